@@ -0,0 +1,95 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "common.h"
+#include "MappedFile.h"
+#include "MeshCodec.h"
+#include "MeshImport.h"
+
+#include <chrono>
+
+// usage: meshCodecBench file.obj|file.glb [more ...]
+// imports each mesh (float and quantized vertices), encodes its buffers and reports the
+// compression ratio and decode throughput in bytes of decoded output per second.
+
+namespace
+{
+    constexpr int RUNS = 20;
+
+    template<typename DecodeFn>
+    double decodeSeconds(DecodeFn const& decode)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (int run = 0; run < RUNS; ++run)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            if (!decode())
+            {
+                throw std::runtime_error("Decoded stream does not match the input!");
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+        }
+        return best;
+    }
+
+    void report(char const* name, size_t rawSize, size_t encodedSize, double seconds)
+    {
+        std::cout << "  " << name << ": " << rawSize << " -> " << encodedSize << " bytes ("
+                  << static_cast<double>(rawSize) / static_cast<double>(std::max<size_t>(encodedSize, 1))
+                  << "x), decode " << static_cast<double>(rawSize) / seconds / 1e9 << " GB/s" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " file.obj|file.glb [more ...]" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        MappedFile file(argv[i]);
+        if (!file)
+        {
+            std::cerr << "Cannot open " << argv[i] << std::endl;
+            return 1;
+        }
+
+        for (auto format : { FLOAT_VERTEX, QUANTIZED_VERTEX })
+        {
+            MeshImportOptions options;
+            options.vertexFormat = format;
+            MeshData mesh = MeshImport::import(file.data(), file.size(), argv[i], options);
+            std::cout << argv[i] << (format == QUANTIZED_VERTEX ? " (quantized): " : ": ")
+                      << mesh.vertexCount() << " vertices, " << mesh.indexCount() << " indices" << std::endl;
+
+            size_t stride = vertexStride(mesh.vertexFormat);
+            size_t vertSize = mesh.vertexCount() * stride;
+            auto vertices = MeshCodec::encodeVertices(mesh.vertexData(), mesh.vertexCount(), stride);
+            std::vector<uint8_t> decodedVertices(vertSize);
+            double vertSeconds = decodeSeconds([&]
+            {
+                return MeshCodec::decodeVertices(vertices.data(), vertices.size(), decodedVertices.data(),
+                                                 mesh.vertexCount(), stride) &&
+                       memcmp(decodedVertices.data(), mesh.vertexData(), vertSize) == 0;
+            });
+            report("vertices", vertSize, vertices.size(), vertSeconds);
+
+            size_t idxSize = mesh.indexCount() * indexStride(mesh.indexType);
+            auto indices = MeshCodec::encodeIndices(mesh.indexData(), mesh.indexCount(), mesh.indexType);
+            std::vector<uint8_t> decodedIndices(idxSize);
+            double idxSeconds = decodeSeconds([&]
+            {
+                return MeshCodec::decodeIndices(indices.data(), indices.size(), decodedIndices.data(),
+                                                mesh.indexCount(), mesh.indexType, mesh.vertexCount()) &&
+                       memcmp(decodedIndices.data(), mesh.indexData(), idxSize) == 0;
+            });
+            report("indices", idxSize, indices.size(), idxSeconds);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "common.h"
+#include "MappedFile.h"
+#include "MeshImport.h"
+
+#include <chrono>
+
+// usage: meshOptimizerBench file.obj|file.glb [more ...]
+// imports each mesh on the CPU and reports post-transform cache efficiency; no GPU needed.
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " file.obj|file.glb [more ...]" << std::endl;
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        MappedFile file(argv[i]);
+        if (!file)
+        {
+            std::cerr << "Cannot open " << argv[i] << std::endl;
+            return 1;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        MeshData mesh = MeshImport::import(file.data(), file.size(), argv[i], MeshImportOptions());
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto const& stats = mesh.cacheStats;
+        size_t triangles = (mesh.lods.empty() ? mesh.indexCount() : mesh.lods[0].indexCount) / 3;
+        std::cout << argv[i] << ": " << triangles << " triangles, "
+                  << mesh.verts.size() << " vertices, ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter
+                  << " (FIFO " << MeshOptimizer::DEFAULT_CACHE_SIZE << "), ATVR "
+                  << stats.acmrAfter * static_cast<float>(triangles) /
+                     static_cast<float>(std::max<size_t>(mesh.verts.size(), 1))
+                  << ", import " << std::chrono::duration<double>(end - start).count() * 1000.0 << " ms"
+                  << std::endl;
+
+        for (size_t level = 1; level < mesh.lods.size(); ++level)
+        {
+            std::cout << "  LOD " << level << ": " << mesh.lods[level].indexCount / 3 << " triangles, error "
+                      << mesh.lods[level].error << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "common.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+// usage: objParserBench [file.obj] [runs]
+// without a file, a tessellated grid of ~4.5M triangles is generated first.
+
+namespace
+{
+    std::string generateGrid(uint32_t n)
+    {
+        std::string fileName = "objParserBench_grid.obj";
+        std::ofstream out(fileName, std::ios::binary);
+
+        char line[128];
+        for (uint32_t y = 0; y <= n; ++y)
+        {
+            for (uint32_t x = 0; x <= n; ++x)
+            {
+                float fx = static_cast<float>(x) / n, fy = static_cast<float>(y) / n;
+                int len = snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0 0 1\n",
+                                   fx, fy, 0.05f * std::sin(fx * 40.f) * std::cos(fy * 40.f), fx, fy);
+                out.write(line, len);
+            }
+        }
+
+        for (uint32_t y = 0; y < n; ++y)
+        {
+            for (uint32_t x = 0; x < n; ++x)
+            {
+                uint32_t a = y * (n + 1) + x + 1, b = a + 1, c = a + n + 1, d = c + 1;
+                int len = snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n",
+                                   a, a, a, b, b, b, d, d, d, c, c, c);
+                out.write(line, len);
+            }
+        }
+        return fileName;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string fileName = argc > 1 ? argv[1] : generateGrid(1500);
+    int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    MappedFile file(fileName);
+    if (!file)
+    {
+        std::cerr << "Cannot open " << fileName << std::endl;
+        return 1;
+    }
+    auto const* text = reinterpret_cast<char const*>(file.data());
+
+    double megabytes = static_cast<double>(file.size()) / (1024.0 * 1024.0);
+    std::cout << fileName << ": " << megabytes << " MB" << std::endl;
+
+    auto& pool = ThreadPool::shared();
+    auto measure = [&](std::string const& label, std::function<ObjParser::ObjData()> const& parseFn)
+    {
+        double best = 1e30;
+        size_t triangles = 0;
+        for (int i = 0; i < runs; ++i)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            ObjParser::ObjData data = parseFn();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            best = std::min(best, std::chrono::duration<double>(end - start).count());
+            triangles = data.corners.size() / 3;
+        }
+
+        std::cout << label << ", best of " << runs << ": " << best * 1000.0 << " ms, "
+                  << megabytes / best << " MB/s, "
+                  << static_cast<double>(triangles) / best / 1e6 << " Mtri/s (" << triangles << " triangles)"
+                  << std::endl;
+    };
+
+    measure("serial", [&]() { return ObjParser::parse(text, text + file.size()); });
+    measure("parallel x" + std::to_string(pool.size()),
+            [&]() { return ObjParser::parseParallel(text, text + file.size(), pool); });
+    return 0;
+}
@@ -0,0 +1,129 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "common.h"
+#include "PngDecoder.h"
+
+#include <chrono>
+#include <random>
+#include <sstream>
+
+#include <png++/png.hpp>
+
+// usage: pngDecodeBench [runs]
+// encodes 4096x4096 RGBA, RGB and paletted images in memory, then decodes each with the
+// png++ get_pixel loop helpers::fromPng used to run and with PngDecoder into a preallocated
+// buffer, as it decodes into staging memory.
+
+namespace
+{
+    constexpr uint32_t SIZE = 4096;
+
+    // what helpers::fromPng did before PngDecoder: column by column, and so transposed
+    std::vector<uint32_t> legacyDecode(std::string const& png)
+    {
+        std::istringstream stream(png);
+        png::image<png::rgba_pixel> inputIm(stream);
+        std::vector<uint32_t> im;
+        for (size_t i = 0; i < inputIm.get_width(); ++i)
+        {
+            for (size_t j = 0; j < inputIm.get_height(); ++j)
+            {
+                auto colorData = inputIm.get_pixel(i, j);
+                im.emplace_back(colorData.red | colorData.green << 8 | colorData.blue << 16 | colorData.alpha << 24);
+            }
+        }
+        return im;
+    }
+
+    // smooth gradients with some noise, so inflate does not dominate completely
+    template<typename Pixel, typename MakePixel>
+    std::string encode(MakePixel const& makePixel, png::palette const* palette = nullptr)
+    {
+        std::mt19937 rng(1);
+        png::image<Pixel> image(SIZE, SIZE);
+        if (palette)
+        {
+            image.set_palette(*palette);
+        }
+        for (uint32_t y = 0; y < SIZE; ++y)
+        {
+            for (uint32_t x = 0; x < SIZE; ++x)
+            {
+                image.set_pixel(x, y, makePixel(x, y, rng() & 15));
+            }
+        }
+        std::ostringstream stream;
+        image.write_stream(stream);
+        return stream.str();
+    }
+
+    template<typename Fn>
+    double bestMs(int runs, Fn const& fn)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (int run = 0; run < runs; ++run)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int runs = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 5;
+
+    png::palette palette(256);
+    for (size_t i = 0; i < palette.size(); ++i)
+    {
+        palette[i] = png::color(static_cast<png::byte>(i), static_cast<png::byte>(255 - i), static_cast<png::byte>(i / 2));
+    }
+
+    std::pair<char const*, std::string> images[] = {
+            {"RGBA", encode<png::rgba_pixel>([](uint32_t x, uint32_t y, uint32_t noise)
+            {
+                return png::rgba_pixel((x + noise) & 0xFF, (y + noise) & 0xFF, (x ^ y) & 0xFF, 0xFF - (noise << 2));
+            })},
+            {"RGB", encode<png::rgb_pixel>([](uint32_t x, uint32_t y, uint32_t noise)
+            {
+                return png::rgb_pixel((x + noise) & 0xFF, (y + noise) & 0xFF, (x ^ y) & 0xFF);
+            })},
+            {"paletted", encode<png::index_pixel>([](uint32_t x, uint32_t y, uint32_t noise)
+            {
+                return png::index_pixel(static_cast<png::byte>((x + y + noise) & 0xFF));
+            }, &palette)},
+    };
+
+    std::vector<uint8_t> rows(size_t(SIZE) * SIZE * sizeof(uint32_t));
+    for (auto const& [name, png] : images)
+    {
+        std::vector<uint32_t> legacy;
+        double legacyMs = bestMs(runs, [&] { legacy = legacyDecode(png); });
+        double rowMs = bestMs(runs, [&]
+        {
+            PngDecoder decoder(reinterpret_cast<uint8_t const*>(png.data()), png.size());
+            decoder.decodeRgba8(rows.data(), size_t(SIZE) * sizeof(uint32_t));
+        });
+
+        // same pixels, except that the legacy layout is transposed
+        bool match = true;
+        for (uint32_t y = 0; y < SIZE && match; ++y)
+        {
+            for (uint32_t x = 0; x < SIZE && match; ++x)
+            {
+                match = memcmp(&legacy[size_t(x) * SIZE + y], &rows[(size_t(y) * SIZE + x) * sizeof(uint32_t)], sizeof(uint32_t)) == 0;
+            }
+        }
+
+        double megapixels = double(SIZE) * SIZE / 1e6;
+        std::cout << name << " " << SIZE << "x" << SIZE << " (" << png.size() << " bytes): get_pixel "
+                  << legacyMs << " ms, rows " << rowMs << " ms (" << megapixels / (rowMs / 1000.0) << " MP/s, "
+                  << legacyMs / rowMs << "x)" << (match ? "" : " MISMATCH") << std::endl;
+    }
+    return 0;
+}
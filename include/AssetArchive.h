@@ -0,0 +1,146 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "MappedFile.h"
+
+#include <string_view>
+
+/*
+ * Read-only pack of asset files, memory mapped as a whole. Layout of an archive:
+ *   Header | block data | Block[blockCount] | Entry[entryCount] | names
+ * Every asset is split into blocks of at most Header::blockSize bytes that are LZ4
+ * compressed individually, or stored as-is when that does not save space. Entries are
+ * sorted by (nameHash, name) so lookups are a binary search over the mapped table.
+ */
+class AssetArchive
+{
+public:
+    static constexpr uint32_t ARCHIVE_MAGIC = 0x4150564b; // "KVPA"
+    static constexpr uint32_t ARCHIVE_VERSION = 1;
+    static constexpr uint32_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+    // the first block of every asset starts at a multiple of this, so stored vertex
+    // and index data can be used from the mapping directly
+    static constexpr size_t DATA_ALIGNMENT = 16;
+    static CHAR_CONSTEXPR DEFAULT_ARCHIVE = "assets.vkpak";
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t blockSize;
+        uint32_t entryCount;
+        uint64_t blockCount;
+        uint64_t blockOffset;
+        uint64_t entryOffset;
+        uint64_t namesOffset;
+        uint64_t namesSize;
+    };
+
+    struct Block
+    {
+        uint64_t offset;
+        // storedSize == rawSize means the block is not compressed
+        uint32_t storedSize;
+        uint32_t rawSize;
+    };
+
+    struct Entry
+    {
+        uint64_t nameHash;
+        // helpers::hashBytes of the whole uncompressed asset
+        uint64_t contentHash;
+        uint64_t size;
+        uint64_t firstBlock;
+        uint64_t blockCount;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    AssetArchive() = default;
+
+    /**
+     * Maps an archive and validates its tables, so that later lookups and reads only
+     * need to check the compressed data itself.
+     * @return nullopt if the file is missing or not a valid archive
+     */
+    static optional<AssetArchive> open(std::string const& archiveFile);
+
+    /**
+     * Makes an archive the one loaders consult (see helpers::readAsset). Not thread safe;
+     * call during startup, before any asset is loaded.
+     * @return false if the archive cannot be opened; the previous one stays mounted
+     */
+    static bool mount(std::string const& archiveFile);
+
+    // null if no archive is mounted
+    static AssetArchive const* mounted();
+
+    AssetArchive(AssetArchive const&) = delete;
+    AssetArchive& operator=(AssetArchive const&) = delete;
+
+    AssetArchive(AssetArchive&&) noexcept = default;
+    AssetArchive& operator=(AssetArchive&&) noexcept = default;
+
+    // names use '/' separators and no leading "./"; null if there is no such asset
+    [[nodiscard]]
+    Entry const* find(std::string_view name) const;
+
+    [[nodiscard]]
+    std::string_view name(Entry const& entry) const;
+
+    [[nodiscard]]
+    size_t entryCount() const;
+
+    [[nodiscard]]
+    Entry const* entries() const;
+
+    /**
+     * The asset inside the mapping if it is stored uncompressed, else null.
+     */
+    [[nodiscard]]
+    uint8_t const* view(Entry const& entry) const;
+
+    /**
+     * Decompresses an asset into dst, which must hold entry.size bytes.
+     * @return false if the archive data is corrupt
+     */
+    bool read(Entry const& entry, uint8_t* dst) const;
+
+    /**
+     * Decompresses bytes [offset, offset + size) of an asset into dst. Only the blocks
+     * overlapping the range are decoded, and only partially covered ones go through a
+     * temporary buffer.
+     * @return false if the range is out of bounds or the archive data is corrupt
+     */
+    bool read(Entry const& entry, uint64_t offset, size_t size, uint8_t* dst) const;
+
+    // throws std::runtime_error if the archive data is corrupt
+    [[nodiscard]]
+    std::vector<uint8_t> read(Entry const& entry) const;
+
+    // the form loaders pass to find(): '\\' becomes '/', leading "./" is dropped
+    static std::string normalizeName(std::string_view name);
+
+    /**
+     * Packs files into a new archive, written through a temporary file and a rename.
+     * @param files pairs of (asset name, path on disk); names are normalized
+     * @return false if a file cannot be read or the archive cannot be written
+     */
+    static bool write(
+            std::string const& archiveFile, std::vector<std::pair<std::string, std::string>> const& files,
+            uint32_t blockSize = DEFAULT_BLOCK_SIZE);
+
+private:
+    explicit AssetArchive(MappedFile&& file);
+
+    [[nodiscard]]
+    Header const& header() const;
+
+    [[nodiscard]]
+    Block const* blocks() const;
+
+    MappedFile file;
+};
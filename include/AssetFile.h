@@ -0,0 +1,79 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "AssetArchive.h"
+#include "Buffers.h"
+
+/*
+ * Positional reads from a preprocessed asset, either a loose file (pread / ReadFile at an
+ * offset, no mapping) or an asset inside an AssetArchive (decompressed block by block).
+ * Reads go straight into the caller's memory, typically a mapped staging buffer, so the
+ * bytes are never held in an intermediate CPU buffer.
+ */
+class AssetFile
+{
+public:
+    AssetFile() = default;
+    ~AssetFile();
+
+    // empty if the file cannot be opened
+    static AssetFile fromPath(std::string const& path);
+
+    // the archive must outlive the returned object
+    static AssetFile fromArchive(AssetArchive const& archive, AssetArchive::Entry const& entry);
+
+    /**
+     * Looks the asset up in the mounted AssetArchive first, then with helpers::searchPath.
+     * @return an empty AssetFile if it is found in neither
+     */
+    static AssetFile open(std::string const& assetName);
+
+    AssetFile(AssetFile const&) = delete;
+    AssetFile& operator=(AssetFile const&) = delete;
+
+    AssetFile(AssetFile&& af) noexcept;
+    AssetFile& operator=(AssetFile&& af) noexcept;
+
+    [[nodiscard]]
+    uint64_t size() const;
+
+    /**
+     * Reads bytes [offset, offset + size) into dst. Safe to call from several threads.
+     * @return false if the range is out of bounds, the file is short or the archive data is corrupt
+     */
+    bool read(uint64_t offset, size_t size, void* dst) const;
+
+    /**
+     * Allocates a staging buffer holding the given (offset, size) ranges back to back and
+     * reads them into its mapping.
+     * Throws std::runtime_error if a range cannot be read.
+     */
+    [[nodiscard]]
+    std::shared_ptr<Buffers::StagingBuffer> stage(
+            VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+            std::vector<std::pair<uint64_t, size_t>> const& ranges,
+            std::set<uint32_t> const& transferQueues) const;
+
+    explicit operator bool() const
+    {
+        return entry != nullptr || fileHandle != INVALID_FILE;
+    }
+
+private:
+    void close();
+
+    AssetArchive const* archive = nullptr;
+    AssetArchive::Entry const* entry = nullptr;
+
+#if defined(_WIN32)
+    static inline void* const INVALID_FILE = reinterpret_cast<void*>(-1);
+    void* fileHandle = INVALID_FILE;
+#else
+    static constexpr int INVALID_FILE = -1;
+    int fileHandle = INVALID_FILE;
+#endif
+    uint64_t fileSize = 0;
+};
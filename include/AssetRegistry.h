@@ -0,0 +1,285 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "Image.h"
+#include "Mesh.h"
+
+#include <functional>
+#include <unordered_map>
+
+/*
+ * Index of a record in a DensePool plus the generation of its slot. The slot's generation
+ * moves on when the record is erased, so handles kept past that are detected as stale
+ * instead of reaching whichever record reuses the slot.
+ */
+template<typename T>
+struct AssetHandle
+{
+    static constexpr uint32_t INVALID_INDEX = ~0u;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    explicit operator bool() const
+    {
+        return index != INVALID_INDEX;
+    }
+
+    bool operator==(AssetHandle const& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(AssetHandle const& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/*
+ * Records packed in one vector, reached through generational handles in O(1): a handle's slot
+ * holds the record's position, which changes when erasing moves the last record into the gap.
+ */
+template<typename T>
+class DensePool
+{
+public:
+    using Handle = AssetHandle<T>;
+
+    Handle insert(T&& record)
+    {
+        uint32_t slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back({});
+        }
+
+        slots[slot].record = static_cast<uint32_t>(records.size());
+        records.push_back(std::move(record));
+        recordSlots.push_back(slot);
+        return { slot, slots[slot].generation };
+    }
+
+    // nullptr if the handle is empty or stale
+    [[nodiscard]]
+    T* get(Handle handle)
+    {
+        return contains(handle) ? &records[slots[handle.index].record] : nullptr;
+    }
+
+    [[nodiscard]]
+    T const* get(Handle handle) const
+    {
+        return contains(handle) ? &records[slots[handle.index].record] : nullptr;
+    }
+
+    // throws std::runtime_error if the handle is empty or stale
+    [[nodiscard]]
+    T& at(Handle handle)
+    {
+        if (!contains(handle))
+        {
+            throw std::runtime_error("Stale asset handle!");
+        }
+        return records[slots[handle.index].record];
+    }
+
+    [[nodiscard]]
+    bool contains(Handle handle) const
+    {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+               slots[handle.index].record != NO_RECORD;
+    }
+
+    // false if the handle was already stale
+    bool erase(Handle handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+
+        uint32_t record = slots[handle.index].record;
+        if (record + 1 != records.size())
+        {
+            records[record] = std::move(records.back());
+            recordSlots[record] = recordSlots.back();
+            slots[recordSlots[record]].record = record;
+        }
+        records.pop_back();
+        recordSlots.pop_back();
+
+        Slot& slot = slots[handle.index];
+        slot.record = NO_RECORD;
+        // a slot whose generation would wrap around is retired rather than risk an old handle matching
+        if (++slot.generation != 0)
+        {
+            freeSlots.push_back(handle.index);
+        }
+        return true;
+    }
+
+    // moves record in place of the handle's record, which is returned; the handle stays valid
+    T replace(Handle handle, T&& record)
+    {
+        T& current = at(handle);
+        T previous = std::move(current);
+        current = std::move(record);
+        return previous;
+    }
+
+    [[nodiscard]]
+    size_t size() const
+    {
+        return records.size();
+    }
+
+    // records in storage order, which erase() does not preserve
+    typename std::vector<T>::iterator begin()
+    {
+        return records.begin();
+    }
+
+    typename std::vector<T>::iterator end()
+    {
+        return records.end();
+    }
+
+private:
+    static constexpr uint32_t NO_RECORD = ~0u;
+
+    struct Slot
+    {
+        uint32_t record = NO_RECORD;
+        uint32_t generation = 0;
+    };
+
+    std::vector<T> records;
+    // slot of each record, to fix the slot up when the record moves
+    std::vector<uint32_t> recordSlots;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+};
+
+using MeshHandle = AssetHandle<Mesh>;
+using TextureHandle = AssetHandle<Image::Image>;
+
+/*
+ * Owns the meshes and textures of a scene. Loading an asset name again returns the handle it
+ * got the first time; a different name whose contents hash the same (a copy of the file, or the
+ * same file through another path) shares that record too, as long as it is loaded the same way.
+ */
+class AssetRegistry
+{
+public:
+    // a handle an asset name was loaded as, with the function that loaded it
+    template<typename T>
+    struct Source
+    {
+        AssetHandle<T> handle;
+        std::function<T()> load;
+    };
+
+    /**
+     * @param variant tells apart records of the same contents loaded differently, e.g.
+     * MeshImportOptions::cacheKey()
+     * @param load creates the mesh when neither the name nor its contents are known yet;
+     * its exceptions propagate
+     */
+    MeshHandle loadMesh(std::string const& assetName, uint64_t variant, std::function<Mesh()> const& load);
+
+    TextureHandle loadTexture(std::string const& assetName, uint64_t variant, std::function<Image::Image()> const& load);
+
+    // throw std::runtime_error for stale handles
+    [[nodiscard]]
+    Mesh& mesh(MeshHandle handle);
+
+    [[nodiscard]]
+    Image::Image& texture(TextureHandle handle);
+
+    [[nodiscard]]
+    bool contains(MeshHandle handle) const;
+
+    [[nodiscard]]
+    bool contains(TextureHandle handle) const;
+
+    // one per variant the asset name was loaded with
+    [[nodiscard]]
+    std::vector<Source<Mesh>> meshSources(std::string const& assetName) const;
+
+    [[nodiscard]]
+    std::vector<Source<Image::Image>> textureSources(std::string const& assetName) const;
+
+    // names of the meshes and textures loaded so far
+    [[nodiscard]]
+    std::set<std::string> assetNames() const;
+
+    /**
+     * Puts a new version of an asset in place of the handle's record, for every name sharing
+     * it, and returns the old record, which the GPU may still be using. The old contents no
+     * longer match the record when loading further names.
+     */
+    Mesh replace(MeshHandle handle, Mesh&& mesh);
+
+    Image::Image replace(TextureHandle handle, Image::Image&& texture);
+
+    // destroys the record; every handle to it, under any name, goes stale
+    bool unload(MeshHandle handle);
+
+    bool unload(TextureHandle handle);
+
+    DensePool<Mesh>& meshes();
+
+    DensePool<Image::Image>& textures();
+
+    /**
+     * Hash identifying the asset's contents: the archive's stored hash when the mounted
+     * AssetArchive has it, else a hash of the mapped file.
+     * Throws std::runtime_error if the asset is found in neither.
+     */
+    [[nodiscard]]
+    static uint64_t contentHash(std::string const& assetName);
+
+private:
+    template<typename T>
+    struct Named
+    {
+        std::string assetName;
+        AssetHandle<T> handle;
+        std::function<T()> load;
+    };
+
+    template<typename T>
+    struct Index
+    {
+        // (name, variant) and (contents, variant) keys
+        std::unordered_map<std::string, Named<T>> names;
+        std::unordered_map<uint64_t, AssetHandle<T>> contents;
+    };
+
+    template<typename T>
+    static AssetHandle<T> load(
+            DensePool<T>& pool, Index<T>& index,
+            std::string const& assetName, uint64_t variant, std::function<T()> const& create);
+
+    template<typename T>
+    static std::vector<Source<T>> sources(Index<T> const& index, std::string const& assetName);
+
+    // removes the handle's contents keys, and its names too unless keepNames
+    template<typename T>
+    static void forget(Index<T>& index, AssetHandle<T> handle, bool keepNames = false);
+
+    DensePool<Mesh> meshPool;
+    DensePool<Image::Image> texturePool;
+    Index<Mesh> meshIndex;
+    Index<Image::Image> textureIndex;
+};
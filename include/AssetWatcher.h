@@ -0,0 +1,47 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+
+#include <unordered_map>
+
+/*
+ * Reports files written in watched directories, for hot reloading assets. Uses inotify on
+ * Linux and is never notified elsewhere. A file counts as written once closed after writing
+ * or renamed into the directory, which is how most editors and exporters save, so assets are
+ * not picked up half written.
+ */
+class AssetWatcher
+{
+public:
+    AssetWatcher();
+    ~AssetWatcher();
+
+    AssetWatcher(AssetWatcher const&) = delete;
+    AssetWatcher& operator=(AssetWatcher const&) = delete;
+
+    /**
+     * Watches the files directly inside directory; watching it again does nothing.
+     * @return false if the directory cannot be watched
+     */
+    bool watch(std::string const& directory);
+
+    /**
+     * Never blocks.
+     * @return paths (watched directory / file name) of the files written since the last call, each once
+     */
+    [[nodiscard]]
+    std::vector<std::string> poll();
+
+    // false where file notifications are not supported
+    explicit operator bool() const;
+
+private:
+#if defined(__linux__)
+    int fd = -1;
+    // watched directory of each watch descriptor
+    std::unordered_map<int, std::string> directories;
+#endif
+};
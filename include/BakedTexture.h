@@ -0,0 +1,128 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "AssetFile.h"
+
+/*
+ * Texture baked offline, with its mip levels already encoded in the format the GPU samples:
+ * a .nvtex written by texBake, or a KTX2 or DDS file from another pipeline. Only the level
+ * table is read when opening; the levels are read straight into a staging buffer and copied
+ * to an Image as they are.
+ *
+ * Layout of a .nvtex file:
+ *   Header | Level[mipLevels] | level data
+ * Levels are stored largest first, each at a 16-byte aligned offset and tightly packed (RGBA8
+ * rows, or rows of 4x4 blocks).
+ *
+ * KTX2 and DDS files must hold one 2D image (no arrays, cube maps or volumes) in an RGBA8,
+ * BGRA8 or BC1-BC7 format; KTX2 files must not be supercompressed.
+ */
+class BakedTexture
+{
+public:
+    static constexpr uint32_t TEXTURE_MAGIC = 0x5854564e; // "NVTX"
+    static constexpr uint32_t TEXTURE_VERSION = 1;
+    static constexpr size_t LEVEL_ALIGNMENT = 16;
+    static CHAR_CONSTEXPR TEXTURE_EXTENSION = ".nvtex";
+
+    enum class Encoding : uint32_t
+    {
+        RGBA8 = 0,
+        // 8 bytes per 4x4 block, 1-bit alpha
+        BC1 = 1,
+        // 16 bytes per 4x4 block
+        BC7 = 2,
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        Encoding encoding;
+        // nonzero if the texels are sRGB encoded
+        uint32_t srgb;
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipLevels;
+        uint32_t reserved;
+    };
+
+    struct Level
+    {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    BakedTexture() = default;
+
+    // the baked texture texBake writes for a source image, e.g. "a/b.png" -> "a/b.nvtex"
+    static std::string bakedPath(std::string const& sourceName);
+
+    /**
+     * Reads the header and level table of a .nvtex, KTX2 or DDS file, told apart by their
+     * magic numbers; the level data stays in the file.
+     * @return nullopt if the file is none of those, is corrupt or holds an unsupported kind of texture
+     */
+    static optional<BakedTexture> open(AssetFile&& file);
+
+    BakedTexture(BakedTexture const&) = delete;
+    BakedTexture& operator=(BakedTexture const&) = delete;
+
+    BakedTexture(BakedTexture&&) noexcept = default;
+    BakedTexture& operator=(BakedTexture&&) noexcept = default;
+
+    [[nodiscard]]
+    uint32_t width() const;
+
+    [[nodiscard]]
+    uint32_t height() const;
+
+    [[nodiscard]]
+    uint32_t mipLevels() const;
+
+    // where each level is in the file, largest first
+    [[nodiscard]]
+    std::vector<Level> const& levels() const;
+
+    [[nodiscard]]
+    VkFormat format() const;
+
+    // whether format() is one of the BC formats, which need the textureCompressionBC feature
+    [[nodiscard]]
+    bool blockCompressed() const;
+
+    /**
+     * Reads every level into one staging buffer, back to back and largest first, as
+     * Image::cmdCopyFromBuffer takes them with levelOffsets().
+     * Throws std::runtime_error if the file cannot be read.
+     */
+    [[nodiscard]]
+    std::shared_ptr<Buffers::StagingBuffer> stage(
+            VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+            std::set<uint32_t> const& transferQueues) const;
+
+    // offset of each level in the buffer stage() fills
+    [[nodiscard]]
+    std::vector<VkDeviceSize> levelOffsets() const;
+
+    /**
+     * Reads levels [firstLevel, firstLevel + levelCount) back to back into dst, laid out as
+     * stage() lays them out from levelOffsets()[firstLevel]. Safe to call from several threads.
+     * @return false if the file cannot be read
+     */
+    bool readLevels(uint32_t firstLevel, uint32_t levelCount, uint8_t* dst) const;
+
+private:
+    static bool readNvtex(AssetFile const& file, BakedTexture& texture);
+    static bool readKtx2(AssetFile const& file, BakedTexture& texture);
+    static bool readDds(AssetFile const& file, BakedTexture& texture);
+
+    AssetFile textureFile;
+    VkFormat vkFormat = VK_FORMAT_UNDEFINED;
+    uint32_t textureWidth = 0;
+    uint32_t textureHeight = 0;
+    std::vector<Level> levelTable;
+};
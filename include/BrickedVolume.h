@@ -0,0 +1,144 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "AssetFile.h"
+#include "Buffers.h"
+#include "Culling.h"
+#include "Image.h"
+#include "VolumeBricks.h"
+
+#include <future>
+
+/*
+ * Volume streamed brick by brick from a .nvvol file (see VolumeBricks) into a fixed-size 3D
+ * atlas image, so datasets larger than device or host memory can be viewed. Only the brick
+ * table is read when opening.
+ *
+ * A page table image has one R8G8B8A8_UINT texel per brick: the brick's slot in the atlas
+ * (x, y, z) and its PageState. Shaders look a point's brick up with nearest filtering and,
+ * for RESIDENT bricks, sample the atlas at slot * STORED_DIM + APRON + the point's voxel
+ * position inside the brick; EMPTY bricks hold nothing above the volume's empty threshold.
+ *
+ * Each update, the non-empty bricks the view frustum touches and that are missing are read
+ * on the shared ThreadPool, nearest first, and copied into free atlas slots or the slots
+ * least recently touched by the view. Page table entries change in the same submission as
+ * the bricks, so a frame never sees an entry before its brick, and no frame waits on a copy.
+ */
+class BrickedVolume : public AVkGraphicsBase
+{
+public:
+    enum PageState : uint8_t
+    {
+        EMPTY = 0,
+        NOT_RESIDENT = 1,
+        RESIDENT = 2,
+    };
+
+    // atlas slots per axis; 8 holds 512 bricks, 20 MB of 8-bit voxels
+    static constexpr uint32_t DEFAULT_ATLAS_BRICKS = 8;
+    // bricks read and copied per submission
+    static constexpr size_t MAX_BATCH_BRICKS = 64;
+
+    BrickedVolume() = default;
+
+    /**
+     * Opens the volume and creates an empty atlas and its page table, waiting for them to be
+     * initialized. Bricks are copied on the graphics queue, which owns the sampled images.
+     * Throws std::runtime_error if the file is missing or is not a valid volume.
+     * @param atlasBricks atlas slots per axis, lowered to what the device's 3D images allow
+     */
+    BrickedVolume(
+            VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+            VkQueue const& graphicsQueue, VkCommandPool* graphicsCmdPool,
+            std::set<uint32_t> const& transferQueues,
+            std::string const& assetName,
+            uint32_t atlasBricks = DEFAULT_ATLAS_BRICKS);
+
+    // waits for the bricks still in flight
+    ~BrickedVolume() override;
+
+    BrickedVolume(BrickedVolume const&) = delete;
+    BrickedVolume& operator=(BrickedVolume const&) = delete;
+
+    /**
+     * Call once per frame, once the frame's fence has been waited on. Marks the bricks the
+     * view touches as used, completes the copies in flight and starts the next ones.
+     * @param model maps voxel space, [0, width] x [0, height] x [0, depth], to world space
+     */
+    void update(Culling::Frustum const& frustum, glm::mat4 const& model, glm::vec3 const& cameraPos);
+
+    // 3D image of atlasBricks^3 slots of STORED_DIM^3 voxels, linearly filtered
+    [[nodiscard]]
+    Image::Image& atlas();
+
+    // one texel per brick, nearest filtered
+    [[nodiscard]]
+    Image::Image& pageTable();
+
+    [[nodiscard]]
+    VolumeBricks::Header const& header() const;
+
+    [[nodiscard]]
+    size_t residentBricks() const;
+
+    [[nodiscard]]
+    size_t emptyBricks() const;
+
+private:
+    static constexpr uint32_t NO_SLOT = ~0u;
+
+    // bricks read into staging, then copied into their slots
+    struct Batch
+    {
+        std::vector<uint32_t> bricks;
+        std::vector<uint32_t> slots;
+        // brick each slot held before, or NO_SLOT; its entry goes NOT_RESIDENT with the batch
+        std::vector<uint32_t> evicted;
+        // bricks whose entry changed outside of a batch, written along with the batch
+        std::vector<uint32_t> entries;
+        std::future<void> read;
+        VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+        bool submitted = false;
+    };
+
+    [[nodiscard]]
+    uint32_t pageEntry(uint32_t brick) const;
+
+    void begin(std::vector<std::pair<float, uint32_t>>& missing);
+    // records and submits the copies once the bricks have been read; true once the fence has signalled
+    bool advance();
+    // waits for the batch; one not submitted yet gives its slots back to the bricks it evicted
+    void cancel();
+
+    AssetFile volumeFile;
+    VolumeBricks::Header hdr = {};
+    std::vector<VolumeBricks::Brick> bricks;
+    uint64_t brickBytes = 0;
+    size_t emptyCount = 0;
+
+    uint32_t atlasBricks = 0;
+    // slot of each brick, reserved from when its batch starts
+    std::vector<uint32_t> brickSlots;
+    std::vector<bool> brickResident;
+    // brick in each slot, or NO_SLOT
+    std::vector<uint32_t> slotBricks;
+    // frame the view last touched each slot's brick
+    std::vector<uint64_t> slotFrames;
+    // bricks whose page table entry has not been written yet, e.g. ones that could not be read
+    std::vector<uint32_t> staleEntries;
+
+    Image::Image atlasImage;
+    Image::Image pageImage;
+
+    VmaAllocator* allocator = nullptr;
+    VkQueue graphicsQueue = VK_NULL_HANDLE;
+    VkCommandPool* cmdPool = nullptr;
+    // MAX_BATCH_BRICKS bricks, then the page table entries the batch writes
+    Buffers::StagingBuffer staging;
+    VkFence fence = VK_NULL_HANDLE;
+    optional<Batch> batch;
+    uint64_t frame = 0;
+};
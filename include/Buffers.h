@@ -23,7 +23,7 @@ namespace Buffers
         Buffer(
                 VkDevice* dev,
                 VmaAllocator* allocator,
-                VkPhysicalDevice const& physicalDev, size_t const& bufferSize,
+                VkPhysicalDevice const& physicalDev, VkDeviceSize const& bufferSize,
                 VkBufferUsageFlags const& bufferUsageFlags,
                 VmaMemoryUsage const& memoryUsage,
                 VkMemoryPropertyFlags const& memoryFlags,
@@ -38,10 +38,18 @@ namespace Buffers
         virtual ~Buffer();
 
         [[nodiscard]]
-        uint32_t getSize() const;
+        VkDeviceSize getSize() const;
+
+        /**
+         * Maps the buffer for host writes on first use; the mapping lasts as long as the buffer,
+         * so loaders can write into it directly instead of going through loadData.
+         * Throws if the memory is not host visible.
+         */
+        [[nodiscard]]
+        uint8_t* mapped();
 
         VkResult loadData(void const* data);
-        VkResult loadData(void const* data, uint32_t const& offset, uint32_t const& dataSize);
+        VkResult loadData(void const* data, VkDeviceSize const& offset, VkDeviceSize const& dataSize);
 
         /**
          * @param data vectors of <src, offset, size>
@@ -55,6 +63,11 @@ namespace Buffers
         void copyDataFrom(Buffer const& src, VkQueue& transferQueue, VkCommandPool& transferCmdPool) const;
         void cmdCopyDataFrom(Buffer const& src, VkCommandBuffer& transferBuffer) const;
 
+        // copies copySize bytes from src at srcOffset to this buffer at dstOffset
+        void cmdCopyDataFrom(
+                VkBuffer const& src, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkDeviceSize copySize,
+                VkCommandBuffer& transferBuffer) const;
+
     protected:
         VkResult createVertexBuffer(
                 VkBufferUsageFlags const& bufferUsageFlags,
@@ -67,8 +80,11 @@ namespace Buffers
                 std::set<uint32_t> const& queues);
 
     private:
+        // unmaps and destroys the buffer, if any, leaving this one empty
+        void release();
+
         VmaAllocator* allocator = nullptr;
-        size_t size = -1;
+        VkDeviceSize size = 0;
         void* mappedMemory = nullptr;
     };
 
@@ -79,7 +95,7 @@ namespace Buffers
         StagingBuffer(
                 VkDevice* dev,
                 VmaAllocator* allocator,
-                VkPhysicalDevice const& physicalDev, size_t const& bufferSize,
+                VkPhysicalDevice const& physicalDev, VkDeviceSize const& bufferSize,
                 VkMemoryPropertyFlags const& memoryFlags,
                 optUint32Set const& usedQueues);
 
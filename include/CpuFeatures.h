@@ -0,0 +1,36 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+// MSVC compiles any intrinsic without flags; callers check the CPU first
+#define TARGET_SSSE3
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+// lets one function use an extension the rest of the build does not assume
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/*
+ * Instruction set extensions of the CPU we run on, for picking SIMD code paths at runtime.
+ * All false on other architectures.
+ */
+struct CpuFeatures
+{
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool avx2 = false;
+
+    // detected once, on first use
+    static CpuFeatures const& detected();
+};
@@ -0,0 +1,38 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "MeshOptimizer.h"
+
+namespace Culling
+{
+    struct Frustum
+    {
+        // inward facing planes (xyz normal, w distance): left, right, bottom, top, near, far
+        std::array<glm::vec4, 6> planes;
+
+        /**
+         * Extracts world space planes from a combined projection * view matrix
+         * (Gribb-Hartmann), assuming a [0, 1] clip space depth range.
+         */
+        static Frustum fromMatrix(glm::mat4 const& viewProj);
+
+        [[nodiscard]]
+        bool intersectsSphere(glm::vec3 const& center, float radius) const;
+    };
+
+    // largest axis scale of a model matrix, to carry object space lengths into world space
+    float maxScale(glm::mat4 const& model);
+
+    /**
+     * Tests meshlets of one mesh instance and merges the visible, adjacent ones into
+     * (firstIndex, indexCount) draw ranges.
+     * @param model model matrix of the instance; the cone test is skipped under non-uniform scale
+     */
+    void visibleRanges(
+            MeshOptimizer::Meshlet const* meshlets, size_t meshletCount,
+            glm::mat4 const& model, Frustum const& frustum, glm::vec3 const& eye,
+            std::vector<std::pair<uint32_t, uint32_t>>& ranges);
+}
@@ -20,7 +20,8 @@ public:
     DisposableCmdBuffer& operator= (DisposableCmdBuffer&& dcb) noexcept;
 
     VkCommandBuffer& commandBuffer();
-    VkResult submit(VkQueue& queue);
+    // fence, if given, signals once the commands have completed
+    VkResult submit(VkQueue& queue, VkFence fence = VK_NULL_HANDLE);
     void finish();
 
 private:
@@ -4,20 +4,22 @@
 
 #pragma once
 #include "common.h"
-#include "Mesh.h"
+#include "AssetRegistry.h"
 #include "UniformObjects.h"
 
 class Drawable : public AVkGraphicsBase
 {
 private:
-    Mesh* drawMesh;
+    MeshHandle drawMesh;
 public:
-    Drawable(Mesh* mesh) : drawMesh(mesh), uniform(glm::mat4())
+    Drawable(AssetRegistry& assets, MeshHandle mesh) : drawMesh(mesh), uniform(glm::mat4())
     {
+        assets.mesh(drawMesh).setDequantization(uniform);
     }
 
-    Drawable(Mesh* mesh, glm::mat4 model) : drawMesh(mesh), uniform(model)
+    Drawable(AssetRegistry& assets, MeshHandle mesh, glm::mat4 model) : drawMesh(mesh), uniform(model)
     {
+        assets.mesh(drawMesh).setDequantization(uniform);
     }
     ~Drawable() = default;
 
@@ -31,16 +33,17 @@ public:
     Drawable& operator= (Drawable&& dwb) noexcept
     {
         AVkGraphicsBase::operator=(std::move(dwb));
-        drawMesh = std::move(dwb.drawMesh);
-        uniform = std::move(uniform);
+        drawMesh = dwb.drawMesh;
+        uniform = std::move(dwb.uniform);
 
         return *this;
     }
 
     MeshUniform uniform;
 
-    Mesh& getMesh()
+    [[nodiscard]]
+    MeshHandle getMesh() const
     {
-        return *drawMesh;
+        return drawMesh;
     }
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+
+/*
+ * Reader for binary glTF 2.0 (.glb) files held in memory (usually mapped). Only the
+ * parts needed for static triangle meshes are understood: buffer views, accessors,
+ * meshes and the node hierarchy of the default scene. Accessor data is not copied;
+ * GlbData points into the BIN chunk of the input.
+ */
+namespace GltfParser
+{
+    constexpr uint32_t NO_INDEX = 0xFFFFFFFF;
+
+    constexpr uint32_t GLB_MAGIC = 0x46546c67; // "glTF"
+    constexpr uint32_t GLB_CHUNK_JSON = 0x4e4f534a;
+    constexpr uint32_t GLB_CHUNK_BIN = 0x004e4942;
+
+    // accessor componentType values
+    enum ComponentType : uint32_t
+    {
+        BYTE = 5120,
+        UNSIGNED_BYTE = 5121,
+        SHORT = 5122,
+        UNSIGNED_SHORT = 5123,
+        UNSIGNED_INT = 5125,
+        FLOAT = 5126,
+    };
+
+    struct BufferView
+    {
+        // relative to the BIN chunk
+        uint64_t byteOffset = 0;
+        uint64_t byteLength = 0;
+        // 0 if the elements are tightly packed
+        uint32_t byteStride = 0;
+    };
+
+    struct Accessor
+    {
+        // NO_INDEX if all elements are zero
+        uint32_t bufferView = NO_INDEX;
+        uint64_t byteOffset = 0;
+        uint32_t componentType = FLOAT;
+        // 1 for SCALAR, 2 for VEC2 ...
+        uint32_t components = 1;
+        uint64_t count = 0;
+        bool normalized = false;
+
+        // POSITION accessors are required to carry their bounds
+        bool hasBounds = false;
+        glm::vec3 min = glm::vec3(0.f);
+        glm::vec3 max = glm::vec3(0.f);
+    };
+
+    // one triangle list placed in the scene; attributes are accessor indices or NO_INDEX
+    struct Primitive
+    {
+        uint32_t position = NO_INDEX;
+        uint32_t normal = NO_INDEX;
+        uint32_t texCoord = NO_INDEX;
+        uint32_t indices = NO_INDEX;
+
+        glm::mat4 transform = glm::mat4(1.f);
+        bool identityTransform = true;
+    };
+
+    struct GlbData
+    {
+        std::vector<BufferView> views;
+        std::vector<Accessor> accessors;
+        // every triangle primitive of every node in the default scene, in document order
+        std::vector<Primitive> primitives;
+
+        uint8_t const* bin = nullptr;
+        size_t binSize = 0;
+
+        // address of the first element; null for accessors without a buffer view
+        [[nodiscard]]
+        uint8_t const* elementData(Accessor const& accessor) const;
+
+        // distance between consecutive elements in bytes
+        [[nodiscard]]
+        size_t elementStride(Accessor const& accessor) const;
+    };
+
+    [[nodiscard]]
+    size_t componentSize(uint32_t componentType);
+
+    /**
+     * Parses the JSON chunk and validates every accessor against the BIN chunk, so
+     * reading accessor elements afterwards needs no bounds checks.
+     * Throws std::runtime_error on malformed files and unsupported features (external
+     * buffers, sparse accessors).
+     */
+    GlbData parse(uint8_t const* data, size_t size);
+}
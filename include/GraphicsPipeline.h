@@ -8,6 +8,7 @@
 #include "SwapchainComponent.h"
 #include "Shaders.h"
 #include "UniformObjects.h"
+#include "Vertex.h"
 
 class GraphicsPipeline : public AVkGraphicsBase
 {
@@ -27,7 +28,8 @@ public:
             size_t const& swpchainImgCount,
             VkRenderPass const& renderPass,
             std::vector<VkDescriptorSetLayout> const& descriptorSetLayout = {},
-            bool enableDepthTest = true);
+            bool enableDepthTest = true,
+            VertexFormat vertexFormat = FLOAT_VERTEX);
 
     GraphicsPipeline(GraphicsPipeline const&) = delete;
     GraphicsPipeline& operator=(GraphicsPipeline const&) = delete;
@@ -44,7 +46,8 @@ protected:
             VkExtent2D const& extent,
             VkRenderPass const& renderPass,
             std::vector<VkDescriptorSetLayout> const& descriptorSetLayout = {},
-            bool enableDepthTest = true);
+            bool enableDepthTest = true,
+            VertexFormat vertexFormat = FLOAT_VERTEX);
 
     VkResult createCmdBuffers(size_t const& swpchainImgCoun);
 
@@ -23,6 +23,12 @@ namespace Image
     VkFormat findDepthFormat(VkPhysicalDevice const& dev);
     bool hasStencilComponent(VkFormat const& fmt);
 
+    // whether images of that format can be sampled with linear filtering
+    bool canSample(VkPhysicalDevice const& dev, VkFormat const& fmt);
+
+    // whether Image::cmdGenerateMips can blit that format with linear filtering
+    bool canBlitMips(VkPhysicalDevice const& dev, VkFormat const& fmt);
+
     typedef std::optional<std::set<uint32_t>> optUint32Set;
 
     class Image : public AVkGraphicsBase
@@ -84,6 +90,7 @@ namespace Image
                 VkImageViewType const& viewType,
                 VkImageAspectFlags const& aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT);
 
+        // transitions levels [baseMipLevel, baseMipLevel + levelCount), all of them by default
         void cmdTransitionLayout(
                 VkImageLayout const& oldLayout,
                 VkImageLayout const& newLayout,
@@ -92,12 +99,54 @@ namespace Image
                 VkAccessFlags const& srcAccessMask,
                 VkAccessFlags const& dstAccessMask,
                 VkCommandBuffer& cmdBuffer,
-                VkImageAspectFlags const& aspectFlags=VK_IMAGE_ASPECT_COLOR_BIT) const;
-
+                VkImageAspectFlags const& aspectFlags=VK_IMAGE_ASPECT_COLOR_BIT,
+                uint32_t baseMipLevel=0,
+                uint32_t levelCount=VK_REMAINING_MIP_LEVELS) const;
+
+        /**
+         * Copies whole levels with one command, one region per level.
+         * @param levelOffsets where level baseMipLevel + i is tightly packed in srcBuffer
+         */
         void cmdCopyFromBuffer(
                 Buffers::Buffer const& srcBuffer,
                 VkImageLayout const& layout,
-                VkCommandBuffer& cmdBuffer);
+                VkCommandBuffer& cmdBuffer,
+                std::vector<VkDeviceSize> const& levelOffsets={ 0 },
+                uint32_t baseMipLevel=0);
+
+        // copies boxes of level 0, one region each, with a single command
+        void cmdCopyRegionsFromBuffer(
+                Buffers::Buffer const& srcBuffer,
+                VkImageLayout const& layout,
+                VkCommandBuffer& cmdBuffer,
+                std::vector<VkBufferImageCopy> const& regions) const;
+
+        /**
+         * Copies levels [srcBaseLevel, srcBaseLevel + levelCount) of src, an image of the same format
+         * whose levels are sampled meanwhile (SHADER_READ_ONLY_OPTIMAL), into this image's levels from
+         * dstBaseLevel, which must be in TRANSFER_DST_OPTIMAL. src is back in SHADER_READ_ONLY_OPTIMAL
+         * for the commands after these, so frames already submitted keep sampling it.
+         */
+        void cmdCopyLevelsFrom(
+                Image const& src,
+                uint32_t srcBaseLevel,
+                uint32_t dstBaseLevel,
+                uint32_t levelCount,
+                VkCommandBuffer& cmdBuffer) const;
+
+        /**
+         * Fills levels 1 and up by blitting each level from the one above, on a graphics queue.
+         * Expects every level in TRANSFER_DST_OPTIMAL with level 0 written, and the image created with
+         * TRANSFER_SRC usage in a format canBlitMips accepts; leaves every level in SHADER_READ_ONLY_OPTIMAL.
+         */
+        void cmdGenerateMips(VkCommandBuffer& cmdBuffer) const;
+
+        [[nodiscard]]
+        uint32_t mipLevelCount() const;
+
+        // width, height and depth of a level
+        [[nodiscard]]
+        std::tuple<uint32_t, uint32_t, uint32_t> mipExtent(uint32_t mipLevel) const;
 
         static VkDescriptorSetLayoutBinding layoutBinding(uint32_t binding);
         void dispose();
@@ -107,6 +156,7 @@ namespace Image
     private:
         VmaAllocator* allocator = VK_NULL_HANDLE;
         std::tuple<uint32_t, uint32_t, uint32_t> size = {0,0,0};
+        uint32_t mipLevels = 1;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+
+/*
+ * LZ4 block format (no frame header), compatible with LZ4_compress_default and
+ * LZ4_decompress_safe. The compressor is the single-pass greedy variant; decompression
+ * is what matters at load time.
+ */
+namespace Lz4
+{
+    // worst case compressed size of srcSize bytes
+    [[nodiscard]]
+    size_t compressBound(size_t srcSize);
+
+    /**
+     * @return compressed size, or 0 if it would not fit into dstCapacity
+     */
+    size_t compress(uint8_t const* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+    /**
+     * Decodes a block that must expand to exactly dstSize bytes. Never reads or writes
+     * out of bounds, even for corrupt input.
+     * @return false if the block is malformed
+     */
+    bool decompress(uint8_t const* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+}
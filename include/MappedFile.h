@@ -0,0 +1,46 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+
+/*
+ * Read-only memory mapping of a whole file. The mapping lives as long as the object,
+ * so anything handing out pointers into it must keep the MappedFile alive.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(std::string const& fileName);
+    ~MappedFile();
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    MappedFile(MappedFile&& mf) noexcept;
+    MappedFile& operator=(MappedFile&& mf) noexcept;
+
+    [[nodiscard]]
+    uint8_t const* data() const;
+
+    [[nodiscard]]
+    size_t size() const;
+
+    explicit operator bool() const
+    {
+        return mapped != nullptr;
+    }
+
+private:
+    void unmap();
+
+    uint8_t const* mapped = nullptr;
+    size_t mappedSize = 0;
+
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
@@ -6,10 +6,10 @@
 #include "common.h"
 #include "Vertex.h"
 #include "Buffers.h"
-#include <fstream>
-#include <sstream>
-
-#include <boost/algorithm/string.hpp>
+#include "MeshCache.h"
+#include "MeshImport.h"
+#include "StreamingUpload.h"
+#include "UniformObjects.h"
 
 class Mesh : public AVkGraphicsBase
 {
@@ -19,16 +19,73 @@ public:
     Mesh() = default;
     ~Mesh() = default;
 
+    /**
+     * @param meshFile asset name of an .obj or .glb file; looked up in the mounted
+     * AssetArchive first, then with helpers::searchPath
+     */
     Mesh(VkDevice* logicalDev, VmaAllocator* allocator, VkPhysicalDevice* physDev,
-         std::string const& objFile);
+         std::string const& meshFile, MeshImportOptions const& options = {});
 
+    // byte offset of the indices in buf, after the vertices
     [[nodiscard]]
-    size_t idxOffset() const;
+    VkDeviceSize idxOffset() const;
 
     [[nodiscard]]
     size_t idxCount() const;
 
-    std::shared_ptr<Buffers::StagingBuffer> stagingBuffer(std::set<uint32_t> const& transferQueues);
+    // index ranges with culling bounds; empty if the mesh was imported without meshlets
+    [[nodiscard]]
+    MeshOptimizer::Meshlet const* meshlets() const;
+
+    [[nodiscard]]
+    size_t meshletCount() const;
+
+    // at least 1; level 0 is the full resolution mesh
+    [[nodiscard]]
+    size_t lodCount() const;
+
+    [[nodiscard]]
+    MeshOptimizer::LodLevel lod(size_t level) const;
+
+    [[nodiscard]]
+    std::pair<glm::vec3, glm::vec3> bounds() const;
+
+    [[nodiscard]]
+    VertexFormat vertexFormat() const;
+
+    // VK_INDEX_TYPE_UINT16 whenever the vertex count allows it
+    [[nodiscard]]
+    VkIndexType indexType() const;
+
+    // fills in the position scale/offset main.vert.hlsl needs for quantized vertices
+    void setDequantization(MeshUniform& uniform) const;
+
+    /**
+     * Allocates buf and records the copies filling it; they have completed after uploader.flush().
+     * Does nothing if the mesh is resident already.
+     */
+    void upload(StreamingUpload& uploader);
+
+    // frees buf; the GPU must be done with it. upload() makes the mesh resident again
+    void evict();
+
+    [[nodiscard]]
+    bool resident() const;
+
+    // size of buf, whether resident or not
+    [[nodiscard]]
+    VkDeviceSize gpuBytes() const;
+
+    // host memory held for the vertices, indices, meshlets and LODs
+    [[nodiscard]]
+    size_t cpuBytes() const;
+
+    /**
+     * Drops the imported vertices and indices, which later uploads read from the mesh cache
+     * written at import instead.
+     * @return false if there is no such cache, in which case they are kept
+     */
+    bool releaseCpuData();
 
     Mesh(Mesh const&) = delete;
     Mesh& operator=(Mesh const&) = delete;
@@ -36,8 +93,23 @@ public:
     Mesh(Mesh&& mesh) noexcept;
     Mesh& operator=(Mesh&& mesh) noexcept;
 private:
-    std::vector<NVertex> verts;
-    std::vector<uint32_t> indices;
+    void importSource(uint8_t const* source, size_t size, std::string const& meshFile, MeshImportOptions const& options);
+
+    [[nodiscard]]
+    size_t vertexCount() const;
+
+    // either data (freshly imported) or cache (read on upload) holds the vertices and indices
+    MeshData data;
+    optional<MeshCache::CachedMesh> cache;
+    // back data.borrowed for glTF files loaded without conversion: the mapped file, or
+    // the asset decompressed from an archive (archive views need neither)
+    MappedFile borrowedSource;
+    std::vector<uint8_t> borrowedBytes;
+
+    // cache written from data at import, which releaseCpuData() switches to
+    std::string writtenCache;
+    std::string writtenCacheSource;
+    uint64_t writtenCacheKey = 0;
 
     VmaAllocator* allocator = nullptr;
     VkPhysicalDevice* physDev = nullptr;
@@ -0,0 +1,171 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "Vertex.h"
+#include "MappedFile.h"
+#include "MeshImport.h"
+#include "AssetFile.h"
+
+/*
+ * Binary mesh cache. Layout of a cache file:
+ *   Header | NVertex or QVertex[vertexCount] | uint16_t or uint32_t[indexCount] | Meshlet[meshletCount] | LodLevel[lodCount]
+ * Each block starts at a 16-byte aligned offset recorded in the header, so the vertex and
+ * index blocks can be read straight into a staging buffer without any parsing.
+ */
+namespace MeshCache
+{
+    constexpr uint32_t CACHE_MAGIC = 0x434d564e; // "NVMC"
+    constexpr uint32_t CACHE_VERSION = 6;
+    constexpr size_t BLOCK_ALIGNMENT = 16;
+    CHAR_CONSTEXPR CACHE_EXTENSION = ".nvmesh";
+    // same layout, with MeshCodec streams in the vertex and index blocks; written by meshPack
+    constexpr uint32_t COMPRESSED_MAGIC = 0x5a4d564e; // "NVMZ"
+    CHAR_CONSTEXPR COMPRESSED_EXTENSION = ".nvmz";
+
+    struct SourceStamp
+    {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t hash = 0;
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        SourceStamp source;
+        // identifies the import settings the cache was produced with
+        uint64_t importKey;
+        uint64_t vertexFormat;
+        // VK_INDEX_TYPE_UINT16 or VK_INDEX_TYPE_UINT32
+        uint64_t indexType;
+
+        uint64_t vertexCount;
+        uint64_t vertexOffset;
+        uint64_t indexCount;
+        uint64_t indexOffset;
+        uint64_t meshletCount;
+        uint64_t meshletOffset;
+        uint64_t lodCount;
+        uint64_t lodOffset;
+
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    /**
+     * Cache file of a source imported with the settings importKey identifies; each variant
+     * of a source gets its own file, so loading several of them does not overwrite each other.
+     */
+    std::string cachePath(std::string const& sourceFile, uint64_t importKey);
+
+    // whether a mesh file is a compressed mesh, by its extension
+    bool isCompressed(std::string const& meshFile);
+
+    // size and mtime only; hash is left at 0
+    optional<SourceStamp> statSource(std::string const& sourceFile);
+    SourceStamp stampSource(MappedFile const& source, SourceStamp stamp);
+
+    class CachedMesh
+    {
+    public:
+        CachedMesh() = default;
+
+        /**
+         * Opens a cache file and checks it against the source file it was built from. Only the
+         * header, meshlets and LODs are read; vertices and indices stay in the file.
+         * Size and mtime are compared first; the (more expensive) content hash is only
+         * computed when the size matches but the mtime does not.
+         * @return nullopt if the cache is missing, corrupt, stale or built with another importKey.
+         */
+        static optional<CachedMesh> open(
+                std::string const& cacheFile, std::string const& sourceFile, uint64_t importKey);
+
+        /**
+         * Same for a cache packed into an archive next to its source: the cache must be
+         * named cachePath(sourceName, importKey) and match the archived source's content hash.
+         */
+        static optional<CachedMesh> open(
+                AssetArchive const& archive, std::string const& sourceName, uint64_t importKey);
+
+        /**
+         * Opens a compressed mesh; it has no source to be checked against. Only the block
+         * tables of the encoded streams are read up front.
+         * @return nullopt if the file is not a valid compressed mesh
+         */
+        static optional<CachedMesh> openCompressed(AssetFile&& file);
+
+        CachedMesh(CachedMesh const&) = delete;
+        CachedMesh& operator=(CachedMesh const&) = delete;
+
+        CachedMesh(CachedMesh&&) noexcept = default;
+        CachedMesh& operator=(CachedMesh&&) noexcept = default;
+
+        /**
+         * Reads bytes [offset, offset + size) of the vertex buffer into dst, decoding only the
+         * blocks that overlap the range when the mesh is compressed.
+         * @return false if the range is out of bounds or the file cannot be read or decoded
+         */
+        bool readVertices(uint64_t offset, size_t size, void* dst) const;
+
+        // same for the index buffer
+        bool readIndices(uint64_t offset, size_t size, void* dst) const;
+
+        [[nodiscard]]
+        MeshOptimizer::Meshlet const* meshlets() const;
+
+        [[nodiscard]]
+        MeshOptimizer::LodLevel const* lods() const;
+
+        [[nodiscard]]
+        Header const& header() const;
+
+    private:
+        // block table of a MeshCodec stream; block data starts at dataOffset in the file
+        struct EncodedStream
+        {
+            uint64_t dataOffset = 0;
+            std::vector<uint64_t> blockEnds;
+        };
+
+        // reads the tables of an already validated header
+        static optional<CachedMesh> load(AssetFile&& file, Header const& hdr);
+
+        bool readEncoded(
+                EncodedStream const& stream, bool vertices, uint64_t offset, size_t size, uint8_t* dst) const;
+
+        // the cache file, or the cache asset inside an archive
+        AssetFile cacheFile;
+        Header hdr = {};
+        bool compressed = false;
+        EncodedStream vertexStream;
+        EncodedStream indexStream;
+        std::vector<MeshOptimizer::Meshlet> meshletTable;
+        std::vector<MeshOptimizer::LodLevel> lodTable;
+    };
+
+    /**
+     * Writes a cache file through a temporary file and a rename, so readers never
+     * observe a partially written cache.
+     * @return false if the cache could not be written (e.g. read-only asset directory).
+     */
+    bool write(
+            std::string const& cacheFile, SourceStamp const& source, uint64_t importKey, MeshData const& mesh);
+
+    /**
+     * Out-of-core OBJ import for sources too large to import in memory: the source is read
+     * in windows of windowBytes and its attributes spill to temporary files next to the cache,
+     * so host memory stays bounded by the window size however large the mesh is. The cache
+     * holds what MeshImportOptions::streamedOptions() describes.
+     * @param importKey streamedOptions().cacheKey()
+     * @param vertexFormat QUANTIZED_VERTEX quantizes against the bounds of every position in the source
+     * @return false if the source cannot be read, references missing vertices, or the cache
+     * cannot be written
+     */
+    bool importStreamed(
+            std::string const& cacheFile, std::string const& sourceFile, SourceStamp const& source,
+            uint64_t importKey, VertexFormat vertexFormat, size_t windowBytes);
+}
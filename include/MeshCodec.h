@@ -0,0 +1,61 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "MeshImport.h"
+
+/*
+ * Lossless codec for vertex and index buffers. Every 32-bit lane of the data (one per
+ * index, stride / 4 per vertex) is delta coded against the previous element, zigzag
+ * mapped and written with a byte-grouped variable length code: one control byte holds
+ * the byte lengths of four values, and control bytes are stored apart from the data so
+ * a decoder can expand four values with one byte shuffle (Stream VByte).
+ *
+ * Streams are split into blocks that decode independently, so any range of the buffer
+ * can be decoded straight into staging memory. Layout of an encoded stream:
+ *   uint64_t blockCount | uint64_t blockEnd[blockCount] | block data
+ * where blockEnd is relative to the start of the block data. A vertex block stores its
+ * lanes one after another, each as control bytes followed by data bytes.
+ *
+ * Decoding uses SSE4.1 (and AVX2 to interleave vertex lanes) when the CPU has it.
+ */
+namespace MeshCodec
+{
+    constexpr size_t VERTEX_BLOCK = 1024;
+    constexpr size_t INDEX_BLOCK = 8192;
+
+    // the vertex layout is only seen as stride / 4 32-bit lanes
+    [[nodiscard]]
+    std::vector<uint8_t> encodeVertices(void const* vertices, size_t count, size_t stride);
+
+    [[nodiscard]]
+    std::vector<uint8_t> encodeIndices(void const* indices, size_t count, VkIndexType indexType);
+
+    /**
+     * Decodes one block of count (at most VERTEX_BLOCK) vertices into dst.
+     * @return false if the block is malformed; never reads past src + srcSize
+     */
+    bool decodeVertexBlock(uint8_t const* src, size_t srcSize, void* dst, size_t count, size_t stride);
+
+    // same for one block of at most INDEX_BLOCK indices, which must all be below vertexCount
+    bool decodeIndexBlock(
+            uint8_t const* src, size_t srcSize, void* dst, size_t count, VkIndexType indexType, uint64_t vertexCount);
+
+    /**
+     * Decodes a whole stream written by encodeVertices.
+     * @return false if the stream is malformed or does not hold count vertices
+     */
+    bool decodeVertices(uint8_t const* src, size_t srcSize, void* dst, size_t count, size_t stride);
+
+    bool decodeIndices(
+            uint8_t const* src, size_t srcSize, void* dst, size_t count, VkIndexType indexType, uint64_t vertexCount);
+
+    /**
+     * Writes a compressed mesh file (see MeshCache::COMPRESSED_MAGIC), which Mesh loads like
+     * an .obj or .glb but without importing anything.
+     * @return false if the file cannot be written
+     */
+    bool write(std::string const& file, MeshData const& mesh);
+}
@@ -0,0 +1,132 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "Vertex.h"
+#include "MeshOptimizer.h"
+
+struct MeshImportOptions
+{
+    // parse large OBJ files in chunks on ThreadPool::shared()
+    bool parallelImport = true;
+    // merge identical (position, normal, texcoord) vertices into a shared index buffer
+    bool weldVertices = true;
+    // give vertices the source has no normal for (e.g. OBJ without vn) smooth area weighted ones
+    bool generateNormals = true;
+    // fill in MeshData::tangents for meshes with texcoords
+    bool generateTangents = false;
+    // reorder triangles for post-transform cache reuse and vertices for linear fetch
+    bool optimizeVertexCache = true;
+    // sort triangle clusters by occlusion potential; only for opaque meshes, needs optimizeVertexCache
+    bool optimizeOverdraw = false;
+    // allowed ACMR increase factor for optimizeOverdraw
+    float overdrawThreshold = 1.05f;
+    // split into meshlets for cluster culling; limits are per meshlet
+    bool buildMeshlets = true;
+    uint32_t meshletMaxVertices = MeshOptimizer::DEFAULT_MESHLET_VERTICES;
+    uint32_t meshletMaxTriangles = MeshOptimizer::DEFAULT_MESHLET_TRIANGLES;
+    // levels of detail including the full resolution one; 1 disables simplification
+    uint32_t lodLevels = 5;
+    // index count of each level relative to the previous one
+    float lodReduction = 0.5f;
+    // largest simplification error, relative to the bounding box diagonal
+    float lodMaxError = 0.05f;
+    // vertex layout of the imported (and cached) vertex buffer
+    VertexFormat vertexFormat = FLOAT_VERTEX;
+    // OBJ files at least this large are imported out of core, straight into the mesh cache
+    // and with the processing above switched off (see streamedOptions()); 0 disables it
+    uint64_t streamImportBytes = uint64_t(1) << 30;
+    // the out-of-core import reads its source in windows of this size, which bounds its memory use
+    size_t streamWindowBytes = 64 * 1024 * 1024;
+
+    // options that change the imported data, for cache invalidation
+    [[nodiscard]]
+    uint64_t cacheKey() const;
+
+    // whether a source file of this name and size is imported out of core
+    [[nodiscard]]
+    bool streams(std::string const& fileName, uint64_t fileSize) const;
+
+    // what an out-of-core import produces: unwelded, unoptimized vertices as in the source, in
+    // vertexFormat, with no generated normals, meshlets or LODs
+    [[nodiscard]]
+    MeshImportOptions streamedOptions() const;
+};
+
+/*
+ * CPU-side mesh data, as produced by an importer and consumed by the cache and Mesh.
+ */
+struct MeshData
+{
+    // all processing runs on verts; qverts is only filled in for QUANTIZED_VERTEX
+    VertexFormat vertexFormat = FLOAT_VERTEX;
+    std::vector<NVertex> verts;
+    std::vector<QVertex> qverts;
+    // all processing runs on indices; indices16 replaces it for VK_INDEX_TYPE_UINT16
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    std::vector<uint32_t> indices;
+    std::vector<uint16_t> indices16;
+    // meshlets cover the full resolution level only
+    std::vector<MeshOptimizer::Meshlet> meshlets;
+    // ranges of indices, finest first; empty if no levels were generated
+    std::vector<MeshOptimizer::LodLevel> lods;
+    // one per vertex (see MeshNormals::generateTangents) if MeshImportOptions::generateTangents
+    // is set; neither vertex layout has room for them, so they are not cached or uploaded
+    std::vector<glm::vec4> tangents;
+
+    glm::vec3 boundsMin = glm::vec3(0.f);
+    glm::vec3 boundsMax = glm::vec3(0.f);
+
+    // importGlb can leave vertices and indices in the source data instead of copying
+    // them; the source must then outlive this MeshData
+    struct BorrowedData
+    {
+        void const* vertices = nullptr;
+        size_t vertexCount = 0;
+        void const* indices = nullptr;
+        size_t indexCount = 0;
+    } borrowed;
+
+    // only filled in when MeshImportOptions::optimizeVertexCache is set
+    MeshOptimizer::VertexCacheStats cacheStats;
+
+    void computeBounds();
+
+    [[nodiscard]]
+    size_t vertexCount() const;
+
+    // vertexCount() vertices in vertexFormat
+    [[nodiscard]]
+    void const* vertexData() const;
+
+    [[nodiscard]]
+    size_t indexCount() const;
+
+    // indexCount() indices of indexType
+    [[nodiscard]]
+    void const* indexData() const;
+};
+
+namespace MeshImport
+{
+    /**
+     * Parses and post-processes an OBJ file. Needs no Vulkan device.
+     * @param data the .obj text, usually a MappedFile or an asset read from an archive
+     */
+    MeshData importObj(uint8_t const* data, size_t size, MeshImportOptions const& options);
+
+    /**
+     * Imports every triangle primitive of the default scene of a binary glTF file,
+     * flattened into one mesh with node transforms applied. With all processing options
+     * off, a single primitive already laid out as interleaved NVertex with 16/32-bit
+     * indices is borrowed from the mapping instead (see MeshData::borrowed).
+     * @param data the .glb file; must outlive the result if it borrows from it
+     */
+    MeshData importGlb(uint8_t const* data, size_t size, MeshImportOptions const& options);
+
+    // picks the importer by file extension (.glb or .obj)
+    MeshData import(
+            uint8_t const* data, size_t size, std::string const& fileName, MeshImportOptions const& options);
+}
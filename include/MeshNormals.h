@@ -0,0 +1,35 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "Vertex.h"
+
+class ThreadPool;
+
+/*
+ * Import-time generation of vertex attributes missing from the source. Both passes build a
+ * vertex to triangle adjacency first, then let every vertex gather from its own triangles,
+ * so the parallel passes never write to shared memory. Linear in the size of the mesh.
+ */
+namespace MeshNormals
+{
+    /**
+     * Gives every vertex without a normal (all zero) the area weighted average of the face
+     * normals around its position. Vertices sharing a position share the normal, so UV
+     * seams stay smooth.
+     * @param pool optional; every pass but the position hashing runs on it
+     * @return the number of vertices that got a normal
+     */
+    size_t generateNormals(std::vector<NVertex>& verts, std::vector<uint32_t> const& indices, ThreadPool* pool = nullptr);
+
+    /**
+     * Per-vertex tangents from the texcoord gradients of the surrounding triangles, area
+     * weighted and orthogonalized against the vertex normal. w is the bitangent sign:
+     * bitangent = w * cross(normal, tangent).
+     * @return one tangent per vertex, or nothing if the mesh has no texcoords
+     */
+    std::vector<glm::vec4> generateTangents(
+            std::vector<NVertex> const& verts, std::vector<uint32_t> const& indices, ThreadPool* pool = nullptr);
+}
@@ -0,0 +1,125 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "Vertex.h"
+
+class ThreadPool;
+
+/*
+ * CPU-side processing passes run on imported meshes before they are cached/uploaded.
+ */
+namespace MeshOptimizer
+{
+    // typical post-transform cache size used for simulation and optimization
+    constexpr uint32_t DEFAULT_CACHE_SIZE = 16;
+
+    constexpr uint32_t DEFAULT_MESHLET_VERTICES = 64;
+    constexpr uint32_t DEFAULT_MESHLET_TRIANGLES = 124;
+
+    /*
+     * A contiguous range of the index buffer with bounds for cluster culling. Plain data,
+     * stored as-is in the mesh cache.
+     */
+    struct Meshlet
+    {
+        glm::vec3 center;
+        float radius;
+        // the whole cluster faces away from eye if
+        // dot(center - eye, coneAxis) > coneCutoff * length(center - eye) + radius
+        glm::vec3 coneAxis;
+        float coneCutoff;
+
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
+    /*
+     * One level of detail: a range of the shared index buffer, and the object space
+     * distance by which it may deviate from the full resolution surface.
+     */
+    struct LodLevel
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        float error;
+    };
+
+    struct VertexCacheStats
+    {
+        float acmrBefore = 0.f;
+        float acmrAfter = 0.f;
+    };
+
+    /**
+     * Merges bit-identical vertices (same position, normal and texcoord) and rewrites
+     * the index buffer to reference the compacted vertex array. The first occurrence of
+     * each vertex keeps its relative order.
+     * @param pool optional; used to hash vertices in parallel
+     * @return the new vertex count
+     */
+    size_t weldVertices(std::vector<NVertex>& verts, std::vector<uint32_t>& indices, ThreadPool* pool = nullptr);
+
+    /**
+     * Maps every vertex to the first vertex with a bit-identical position, so passes can
+     * treat attribute seams as one point.
+     * @param pool optional; used to hash positions in parallel
+     */
+    std::vector<uint32_t> positionRemap(std::vector<NVertex> const& verts, ThreadPool* pool = nullptr);
+
+    /**
+     * Average cache miss ratio (transformed vertices per triangle) of a FIFO post-transform
+     * cache. 3.0 is the worst case; well ordered meshes approach 0.5-0.7.
+     */
+    float computeACMR(
+            uint32_t const* indices, size_t indexCount, size_t vertexCount,
+            uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     * Reorders triangles for post-transform cache reuse (Tipsify, Sander et al. 2007).
+     * Runs in linear time; triangle winding is preserved.
+     */
+    void optimizeVertexCache(
+            std::vector<uint32_t>& indices, size_t vertexCount,
+            uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     * Splits a cache-optimized index buffer into clusters and sorts them so that triangles
+     * likely to occlude others are drawn first (Sander et al. 2007). Run after
+     * optimizeVertexCache.
+     * @param threshold how much worse than the input ACMR a cluster may become (1.05 = 5%);
+     * larger values give smaller clusters and better overdraw ordering
+     */
+    void optimizeOverdraw(
+            std::vector<uint32_t>& indices, std::vector<NVertex> const& verts, float threshold = 1.05f,
+            uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     * Splits the index buffer, in its current order, into meshlets of at most maxVertices
+     * unique vertices and maxTriangles triangles, so the index buffer itself is unchanged.
+     * Run last, after any triangle reordering.
+     */
+    std::vector<Meshlet> buildMeshlets(
+            std::vector<uint32_t> const& indices, std::vector<NVertex> const& verts,
+            uint32_t maxVertices = DEFAULT_MESHLET_VERTICES, uint32_t maxTriangles = DEFAULT_MESHLET_TRIANGLES);
+
+    /**
+     * Quadric error edge collapse (Garland and Heckbert 1997). Vertices are only collapsed
+     * onto existing vertices, so the result indexes the same vertex array. Open borders and
+     * attribute seams (one position, several vertices) are kept in place.
+     * @param targetIndexCount stops once the result has at most this many indices
+     * @param targetError stops before collapses that deviate more than this, in object space
+     * @param resultError receives the largest deviation introduced, may be null
+     */
+    std::vector<uint32_t> simplify(
+            uint32_t const* indices, size_t indexCount, std::vector<NVertex> const& verts,
+            size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+    /**
+     * Reorders vertices into the order the index buffer first references them, so vertex
+     * fetch walks memory mostly linearly. Unreferenced vertices are dropped.
+     */
+    void optimizeVertexFetch(std::vector<NVertex>& verts, std::vector<uint32_t>& indices);
+}
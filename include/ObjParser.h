@@ -0,0 +1,61 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+
+class ThreadPool;
+
+/*
+ * Single-pass Wavefront OBJ tokenizer working on an in-memory (usually mapped) buffer.
+ * Only v/vt/vn/f records are understood; everything else is skipped. No allocation
+ * happens per line, only amortized growth of the output arrays.
+ */
+namespace ObjParser
+{
+    constexpr uint32_t NO_INDEX = 0xFFFFFFFF;
+
+    // 0-based attribute indices of one face corner; NO_INDEX if absent
+    struct Corner
+    {
+        uint32_t pos;
+        uint32_t tex;
+        uint32_t normal;
+    };
+
+    struct ObjData
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+
+        // faces fan-triangulated, 3 corners per triangle
+        std::vector<Corner> corners;
+    };
+
+    // v/vt/vn records seen before some point of the file
+    struct RecordCounts
+    {
+        size_t positions = 0;
+        size_t texCoords = 0;
+        size_t normals = 0;
+    };
+
+    ObjData parse(char const* begin, char const* end);
+
+    /**
+     * Parses one line-aligned window of a file that is read piece by piece because it does
+     * not fit in memory. Windows must be passed in file order.
+     * @param seen records before the window, for relative indices; advanced past the window
+     */
+    ObjData parseWindow(char const* begin, char const* end, RecordCounts& seen);
+
+    /**
+     * Same result as parse(), computed in line-aligned chunks on a thread pool.
+     * Inputs smaller than two chunks are parsed serially.
+     */
+    ObjData parseParallel(
+            char const* begin, char const* end, ThreadPool& pool,
+            size_t minChunkBytes = 4 * 1024 * 1024);
+}
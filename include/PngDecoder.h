@@ -0,0 +1,70 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+
+#include <png.h>
+
+/*
+ * Row by row PNG decoder writing RGBA8 straight into caller memory, e.g. a mapped staging
+ * buffer, without an intermediate image. RGB and paletted rows are expanded by us (RGB with
+ * SSSE3 when available); gray, 16-bit and interlaced images go through libpng's transforms.
+ */
+class PngDecoder
+{
+public:
+    /**
+     * Reads the header; the data must outlive the decoder.
+     * Throws std::runtime_error if it is not a valid PNG.
+     */
+    PngDecoder(uint8_t const* data, size_t size);
+    ~PngDecoder();
+
+    PngDecoder(PngDecoder const&) = delete;
+    PngDecoder& operator=(PngDecoder const&) = delete;
+
+    [[nodiscard]]
+    uint32_t width() const;
+
+    [[nodiscard]]
+    uint32_t height() const;
+
+    /**
+     * Decodes the image once, top row first, into rows of width() RGBA8 pixels.
+     * Throws std::runtime_error if the data is corrupt or truncated.
+     * @param rowPitch bytes from the start of one row of dst to the next, at least width() * 4
+     */
+    void decodeRgba8(uint8_t* dst, size_t rowPitch);
+
+private:
+    // how decoded rows reach dst
+    enum class RowLayout
+    {
+        RGBA,
+        RGB,
+        PALETTE,
+    };
+
+    // sets up libpng's transforms; returns what its rows look like afterwards
+    RowLayout configure(uint32_t (&palette)[256]);
+
+    void readRows(RowLayout layout, uint32_t const* palette, uint8_t* row, uint8_t* dst, size_t rowPitch);
+
+    static void readData(png_structp png, png_bytep out, png_size_t length);
+    static void onError(png_structp png, png_const_charp message);
+    static void onWarning(png_structp png, png_const_charp message);
+
+    png_structp png = nullptr;
+    png_infop info = nullptr;
+    uint8_t const* data;
+    size_t size;
+    size_t offset = 0;
+    // set by onError before it jumps back out of libpng
+    std::string error;
+    uint32_t imageWidth = 0;
+    uint32_t imageHeight = 0;
+    // Adam7 passes over the rows, set by configure
+    int passes = 1;
+};
@@ -0,0 +1,106 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "AssetRegistry.h"
+
+/*
+ * Keeps the meshes of an AssetRegistry on the GPU only while they are drawn, within a memory
+ * budget. Meshes are uploaded when first drawn and their CPU copies released once uploaded;
+ * when the resident meshes exceed the budget, the least recently drawn ones are evicted and
+ * uploaded again the next time they are drawn.
+ *
+ * The budget is either fixed or follows the device-local heaps: VMA's per-heap budget
+ * (from VK_EXT_memory_budget when the allocator was created with it, else an estimate from
+ * the heap sizes) minus what everything else, streamed textures included, uses of them.
+ */
+class ResidencyManager : public AVkGraphicsBase
+{
+public:
+    // share of the heaps' budget left unused when following it, for allocations made between updates
+    static constexpr float BUDGET_HEADROOM = 0.1f;
+
+    struct Usage
+    {
+        VkDeviceSize gpuBytes;
+        size_t cpuBytes;
+        // frame the mesh was last drawn in; meshes are evicted by it
+        uint64_t lastUsedFrame;
+        bool resident;
+    };
+
+    ResidencyManager() = default;
+
+    /**
+     * @param assets must outlive the manager; meshes are uploaded on the transfer queue
+     */
+    ResidencyManager(
+            VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+            VkQueue const& transferQueue, VkCommandPool* transferCmdPool,
+            std::set<uint32_t> const& transferQueues,
+            AssetRegistry& assets);
+
+    ResidencyManager(ResidencyManager const&) = delete;
+    ResidencyManager& operator=(ResidencyManager const&) = delete;
+
+    /**
+     * Marks the mesh as drawn this frame.
+     * @return whether it is resident; if not, it is uploaded on the next update(), budget permitting
+     */
+    bool use(MeshHandle mesh);
+
+    /**
+     * Call once per frame, once the frame's fence has been waited on and before recording it.
+     * Evicts least recently drawn meshes no frame in flight uses while the budget is exceeded,
+     * then uploads the meshes drawn but missing since the last call, as many as fit, waiting
+     * for their copies.
+     */
+    void update();
+
+    // 0 follows the device-local heaps' budget, the default
+    void setBudget(VkDeviceSize bytes);
+
+    // bytes the resident meshes may take, as of the last update()
+    [[nodiscard]]
+    VkDeviceSize budget() const;
+
+    [[nodiscard]]
+    VkDeviceSize residentBytes() const;
+
+    // host memory all meshes of the registry hold
+    [[nodiscard]]
+    size_t cpuBytes();
+
+    [[nodiscard]]
+    Usage usage(MeshHandle mesh);
+
+private:
+    struct Entry
+    {
+        // generation of the mesh the entry is for; a new one in the same slot starts over
+        uint32_t generation = 0;
+        uint64_t lastUsed = 0;
+        bool requested = false;
+    };
+
+    Entry& entry(MeshHandle mesh);
+
+    // bytes the resident meshes may take, given what else uses the device-local heaps
+    VkDeviceSize deviceBudget() const;
+
+    AssetRegistry* assets = nullptr;
+    VmaAllocator* allocator = nullptr;
+    VkPhysicalDevice physicalDev = VK_NULL_HANDLE;
+    VkQueue transferQueue = VK_NULL_HANDLE;
+    VkCommandPool* transferCmdPool = nullptr;
+    std::set<uint32_t> transferQueues;
+
+    // by MeshHandle::index
+    std::vector<Entry> entries;
+    VkDeviceSize fixedBudget = 0;
+    VkDeviceSize currentBudget = 0;
+    VkDeviceSize resident = 0;
+    uint64_t frame = 0;
+};
@@ -7,6 +7,7 @@
 
 namespace Shaders
 {
+    // fileName is an asset name, see helpers::readAsset
     std::vector<uint8_t> readBytecode(std::string const& fileName);
     std::pair<VkShaderModule, VkResult> createShaderModule(
             VkDevice const& logicalDev, std::vector<uint8_t> const& spvSource);
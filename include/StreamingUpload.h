@@ -0,0 +1,75 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "Buffers.h"
+
+#include <functional>
+
+/*
+ * Uploads data of any size into device-local buffers through a fixed-size staging buffer,
+ * so host memory use does not grow with the amount uploaded. The staging buffer is split
+ * in two halves: one is filled while the copies out of the other run on the transfer queue.
+ */
+class StreamingUpload : public AVkGraphicsBase
+{
+public:
+    static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 64 * 1024 * 1024;
+
+    /**
+     * Writes bytes [offset, offset + size) of the source into dst, the staging memory.
+     * Throws if the source cannot be read.
+     */
+    using FillFunction = std::function<void(uint8_t* dst, VkDeviceSize offset, VkDeviceSize size)>;
+
+    StreamingUpload() = default;
+    StreamingUpload(
+            VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+            VkQueue const& transferQueue, VkCommandPool* transferCmdPool,
+            std::set<uint32_t> const& transferQueues,
+            VkDeviceSize stagingSize = DEFAULT_STAGING_SIZE);
+
+    // waits for the copies still in flight
+    ~StreamingUpload() override;
+
+    StreamingUpload(StreamingUpload const&) = delete;
+    StreamingUpload& operator=(StreamingUpload const&) = delete;
+
+    /**
+     * Records copies of size bytes into dst at dstOffset, filling the staging buffer one chunk
+     * at a time. Copies are only guaranteed to have completed after flush().
+     */
+    void upload(Buffers::Buffer const& dst, VkDeviceSize dstOffset, VkDeviceSize size, FillFunction const& fill);
+
+    // submits what is recorded so far and waits for every copy to complete
+    void flush();
+
+private:
+    // halves of the staging buffer
+    static constexpr size_t SLOT_COUNT = 2;
+
+    struct Slot
+    {
+        VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        bool recording = false;
+        bool inFlight = false;
+    };
+
+    // waits for the slot's previous submission and starts recording into it
+    void begin(Slot& slot);
+    // submits the current slot and moves on to the other half of the staging buffer
+    void submit();
+    void wait(Slot& slot);
+
+    Buffers::StagingBuffer staging;
+    VkQueue transferQueue = VK_NULL_HANDLE;
+    VkCommandPool* cmdPool = nullptr;
+    VkDeviceSize slotSize = 0;
+
+    std::array<Slot, SLOT_COUNT> slots;
+    size_t current = 0;
+    VkDeviceSize slotUsed = 0;
+};
@@ -41,6 +41,8 @@ public:
 
     void createUniformBuffers(VkPhysicalDevice const& physDev, SwapchainComponents const& swapchainComponent);
     void configureBuffers(uint32_t const& binding, Image::Image& img);
+    // points the texture binding of descriptor set i, which must not be in use, at another image
+    void setImage(uint32_t i, Image::Image const& img);
     void configureMeshBuffers(uint32_t const& binding, DynUniformObjBuffer<MeshUniform> const& unif);
     VkResult createDescriptorSetLayout();
     VkResult createDescriptorSets(SwapchainComponents const& swapchainComponent);
@@ -0,0 +1,65 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "BakedTexture.h"
+#include "ThreadPool.h"
+
+/*
+ * CPU side texture processing for texBake and for GPUs that cannot generate mips:
+ * gamma-correct mip chains of RGBA8 images, and BC1 / BC7 block compression.
+ *
+ * BC1 blocks fit the color endpoints along the principal axis of the block's colors and
+ * refine them by least squares; blocks with alpha below 128 use the 3-color mode with
+ * transparent texels. BC7 blocks always use mode 6 (one subset, 7-bit RGBA endpoints with
+ * a p-bit each, 4-bit indices), fitted the same way in RGBA with every p-bit combination
+ * tried. Encoders see texels as sRGB or linear bytes alike and fit them in that space.
+ */
+namespace TextureCodec
+{
+    constexpr uint32_t BLOCK_DIM = 4;
+    constexpr size_t BC1_BLOCK_BYTES = 8;
+    constexpr size_t BC7_BLOCK_BYTES = 16;
+
+    // levels of a full mip chain, down to 1x1x1
+    uint32_t mipLevelCount(uint32_t width, uint32_t height, uint32_t depth = 1);
+
+    // bytes of levels [0, mipLevels) of an RGBA8 image, tightly packed one after another
+    uint64_t mipChainSizeRgba8(uint32_t width, uint32_t height, uint32_t mipLevels);
+
+    /**
+     * Box filters level 0 of an RGBA8 image at the start of chain into levels [1, mipLevels)
+     * laid out after it, as in mipChainSizeRgba8.
+     * @param srgb filter color in linear space, as the GPU does for _SRGB formats; alpha is always linear
+     */
+    void generateMipsRgba8(uint8_t* chain, uint32_t width, uint32_t height, uint32_t mipLevels, bool srgb);
+
+    // bytes of one width x height level in an encoding
+    uint64_t encodedSize(BakedTexture::Encoding encoding, uint32_t width, uint32_t height);
+
+    // one 4x4 block of RGBA8 texels, row by row
+    void encodeBc1Block(uint8_t const* texels, uint8_t* dst);
+    void encodeBc7Block(uint8_t const* texels, uint8_t* dst);
+
+    /**
+     * Encodes an RGBA8 image into rows of 4x4 blocks, as Vulkan expects them in a buffer.
+     * Blocks past the right or bottom edge repeat the last column or row. Rows of blocks
+     * are spread over the pool when one is given.
+     * @param encoding BC1 or BC7
+     */
+    [[nodiscard]]
+    std::vector<uint8_t> encodeBlocks(
+            uint8_t const* rgba, uint32_t width, uint32_t height, BakedTexture::Encoding encoding,
+            ThreadPool* pool = nullptr);
+
+    /**
+     * Writes a baked texture (see BakedTexture) holding levels of the given encoding, largest
+     * first, each as encodeBlocks or RGBA8 rows lay it out.
+     * @return false if the file cannot be written
+     */
+    bool write(
+            std::string const& file, BakedTexture::Encoding encoding, bool srgb, uint32_t width, uint32_t height,
+            std::vector<std::vector<uint8_t>> const& levels);
+}
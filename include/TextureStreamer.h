@@ -0,0 +1,149 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "BakedTexture.h"
+#include "Buffers.h"
+#include "Image.h"
+
+#include <future>
+
+/*
+ * Keeps only the mip levels of baked textures that are currently needed in device memory.
+ * A texture starts with its tail (the levels of at most TAIL_EXTENT texels) resident. Each
+ * frame, draws request the finest level they need; levels above the resident ones are then
+ * read from the file on the shared ThreadPool and copied on the GPU into a new image holding
+ * [wanted level, last level], with the levels already resident copied over from the old image.
+ * Levels no longer requested for EVICT_DELAY_FRAMES frames, or beyond the byte budget, are
+ * dropped the same way into a smaller image.
+ *
+ * Nothing waits on the GPU: a new image replaces the old one once its fence has signalled,
+ * and the old one is destroyed after the frames that may still sample it have completed.
+ * Users rebind image() whenever version() changes.
+ */
+class TextureStreamer : public AVkGraphicsBase
+{
+public:
+    static constexpr VkDeviceSize DEFAULT_BUDGET = 256 * 1024 * 1024;
+    // levels at most this wide and high are always resident
+    static constexpr uint32_t TAIL_EXTENT = 64;
+    static constexpr uint32_t EVICT_DELAY_FRAMES = 120;
+    // residency changes in flight at once, which bounds the staging memory used
+    static constexpr size_t MAX_PENDING = 2;
+
+    TextureStreamer() = default;
+
+    /**
+     * Levels are copied on the graphics queue, which owns the sampled images.
+     * @param budget bytes of texture levels kept resident over all textures
+     */
+    TextureStreamer(
+            VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+            VkQueue const& graphicsQueue, VkCommandPool* graphicsCmdPool,
+            std::set<uint32_t> const& transferQueues,
+            VkDeviceSize budget = DEFAULT_BUDGET);
+
+    // waits for the residency changes still in flight
+    ~TextureStreamer() override;
+
+    TextureStreamer(TextureStreamer const&) = delete;
+    TextureStreamer& operator=(TextureStreamer const&) = delete;
+
+    /**
+     * Uploads the tail of the texture, waiting for the copy to complete.
+     * @return the index the other functions take
+     */
+    size_t add(BakedTexture&& texture, VkSamplerCreateInfo const& samplerInfo);
+
+    // asks for levels from level on to be resident; the finest level asked for in a frame wins
+    void request(size_t texture, uint32_t level);
+
+    /**
+     * Call once per frame, once the frame's fence has been waited on. Swaps in the images
+     * whose copies have completed, frees images no frame uses anymore and starts the
+     * residency changes asked for by the requests since the last call.
+     */
+    void update();
+
+    // holds levels [residentLevel(texture), mipLevels) of the texture
+    [[nodiscard]]
+    Image::Image& image(size_t texture);
+
+    // changes whenever image(texture) is replaced
+    [[nodiscard]]
+    uint64_t version(size_t texture) const;
+
+    [[nodiscard]]
+    uint32_t residentLevel(size_t texture) const;
+
+    [[nodiscard]]
+    BakedTexture const& source(size_t texture) const;
+
+    // bytes of the levels resident over all textures
+    [[nodiscard]]
+    VkDeviceSize residentBytes() const;
+
+    void setBudget(VkDeviceSize bytes);
+
+private:
+    // a new image being filled with levels [level, mipLevels)
+    struct Pending
+    {
+        uint32_t level = 0;
+        Image::Image image;
+        std::shared_ptr<Buffers::StagingBuffer> staging;
+        // reads the levels missing from the old image into staging
+        std::future<void> read;
+        VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+        bool submitted = false;
+    };
+
+    struct Texture
+    {
+        BakedTexture source;
+        VkSamplerCreateInfo samplerInfo = {};
+        Image::Image image;
+        uint32_t level = 0;
+        uint32_t tailLevel = 0;
+        // finest level requested since the last update
+        uint32_t wanted = 0;
+        uint32_t framesUnwanted = 0;
+        uint64_t version = 0;
+        optional<Pending> pending;
+        VkFence fence = VK_NULL_HANDLE;
+        // set when reading the file failed; the texture then keeps its current levels
+        bool failed = false;
+    };
+
+    struct Retired
+    {
+        Image::Image image;
+        uint64_t frame;
+    };
+
+    // bytes of levels [level, mipLevels) of the texture
+    [[nodiscard]]
+    VkDeviceSize chainBytes(Texture const& texture, uint32_t level) const;
+
+    [[nodiscard]]
+    Image::Image createImage(Texture const& texture, uint32_t level);
+
+    void begin(Texture& texture, uint32_t level);
+    // records and submits the copies once the file has been read; true once the fence has signalled
+    bool advance(Texture& texture);
+    void cancel(Texture& texture);
+
+    VmaAllocator* allocator = nullptr;
+    VkPhysicalDevice physicalDev = VK_NULL_HANDLE;
+    VkQueue graphicsQueue = VK_NULL_HANDLE;
+    VkCommandPool* cmdPool = nullptr;
+    std::set<uint32_t> transferQueues;
+    VkDeviceSize budget = DEFAULT_BUDGET;
+
+    // unique_ptr so the files being read on the pool never move
+    std::vector<std::unique_ptr<Texture>> textures;
+    std::vector<Retired> retired;
+    uint64_t frame = 0;
+};
@@ -0,0 +1,61 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+/*
+ * Fixed-size worker pool for CPU-side asset work (import, mesh processing, encoding).
+ * Tasks must not block on other tasks of the same pool.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    // process-wide pool sized to the hardware concurrency
+    static ThreadPool& shared();
+
+    [[nodiscard]]
+    size_t size() const;
+
+    template<typename TFunc>
+    std::future<void> submit(TFunc&& func)
+    {
+        auto task = std::make_shared<std::packaged_task<void()>>(std::forward<TFunc>(func));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            tasks.emplace([task]() { (*task)(); });
+        }
+        queueCondition.notify_one();
+        return result;
+    }
+
+    /**
+     * Splits [0, count) into contiguous ranges and runs fn(begin, end) on each, blocking
+     * until all ranges are done. Exceptions thrown by fn are rethrown here.
+     * @param minRange ranges are never split below this many elements
+     */
+    void parallelFor(size_t count, std::function<void(size_t, size_t)> const& fn, size_t minRange = 1024);
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool stopping = false;
+};
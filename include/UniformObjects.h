@@ -27,7 +27,9 @@ struct MeshUniform
     glm::vec4 params; // metallic, roughmess, F0, unused
     glm::mat4 model;
     glm::mat4 modelInvDual;
-
+    // object space position = posOffset + posScale * stored position (QVertex only)
+    glm::vec4 posOffset = glm::vec4(0.f);
+    glm::vec4 posScale = glm::vec4(1.f);
 
     static VkDescriptorSetLayoutBinding descriptorSetLayout(uint32_t binding=0);
 
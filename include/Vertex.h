@@ -28,5 +28,33 @@ struct NVertex
     static std::array<VkVertexInputAttributeDescription,3> attributeDescription();
 };
 
+enum VertexFormat : uint32_t
+{
+    // NVertex, 32 bytes
+    FLOAT_VERTEX = 0,
+    // QVertex, 16 bytes
+    QUANTIZED_VERTEX = 1,
+};
+
+/*
+ * Compact NVertex: position as 16-bit unorm relative to the mesh bounds, octahedral
+ * normal in 2x16-bit snorm and half float texcoords. Dequantized in main.vert.hlsl
+ * with MeshUniform::posOffset/posScale.
+ */
+struct QVertex
+{
+    uint32_t pos[2];
+    uint32_t normal;
+    uint32_t texCoord;
+
+    static QVertex quantize(NVertex const& vert, glm::vec3 const& boundsMin, glm::vec3 const& boundsMax);
+
+    // relevant static functions
+    static VkVertexInputBindingDescription bindingDescription();
+    static std::array<VkVertexInputAttributeDescription,3> attributeDescription();
+};
 
+size_t vertexStride(VertexFormat format);
 
+// bytes per index of an index buffer bound with type
+size_t indexStride(VkIndexType type);
@@ -73,21 +73,26 @@ namespace Buffers
         IndexBuffer() = default;
         ~IndexBuffer() override = default;
 
+        // TIndex is uint16_t or uint32_t; the matching type for vkCmdBindIndexBuffer is kept in indexType
+        template<typename TIndex>
         IndexBuffer(
                 VkDevice* dev,
                 VmaAllocator* allocator,
                 VkPhysicalDevice const& physicalDev,
-                std::vector<uint32_t> const& indices,
+                std::vector<TIndex> const& indices,
                 VkFlags const& additionalFlags = 0,
                 VkMemoryPropertyFlags const& memoryFlags = 0,
                 optUint32Set const& usedQueues = nullopt
         ) : Buffer(dev, allocator, physicalDev,
-                   indices.size() * sizeof(uint32_t),
+                   indices.size() * sizeof(TIndex),
                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT | additionalFlags,
                    VMA_MEMORY_USAGE_GPU_ONLY,
                    memoryFlags,
-                   usedQueues)
+                   usedQueues),
+            indexType(std::is_same_v<TIndex, uint16_t> ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32)
         {
+            static_assert(std::is_same_v<TIndex, uint16_t> || std::is_same_v<TIndex, uint32_t>,
+                          "Index buffers hold 16 or 32 bit indices");
             // Memory requirements
             CHECK_VK_SUCCESS(loadData(indices.data()), "Cannot copy data!");
         }
@@ -97,30 +102,35 @@ namespace Buffers
                 VmaAllocator* allocator,
                 VkPhysicalDevice const& physicalDev,
                 size_t vertexBufferLength,
+                VkIndexType const& type = VK_INDEX_TYPE_UINT32,
                 VkFlags const& additionalFlags = 0,
                 VkMemoryPropertyFlags const& memoryFlags = 0,
                 optUint32Set const& usedQueues = nullopt
 
         ) : Buffer(dev, allocator, physicalDev,
-                   vertexBufferLength * sizeof(uint32_t),
+                   vertexBufferLength * indexStride(type),
                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT | additionalFlags,
                    VMA_MEMORY_USAGE_GPU_ONLY,
                    memoryFlags,
-                   usedQueues)
+                   usedQueues),
+            indexType(type)
         {
         }
 
         IndexBuffer(IndexBuffer const&) = delete;
         IndexBuffer& operator=(IndexBuffer const&) = delete;
 
-        IndexBuffer(IndexBuffer&& vb) noexcept : Buffer(std::move(vb))
+        IndexBuffer(IndexBuffer&& vb) noexcept : Buffer(std::move(vb)), indexType(vb.indexType)
         {
         }
 
         IndexBuffer& operator=(IndexBuffer&& vb) noexcept
         {
+            indexType = vb.indexType;
             Buffer::operator=(std::move(vb));
             return *this;
         }
+
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
     };
 }
\ No newline at end of file
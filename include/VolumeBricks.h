@@ -0,0 +1,94 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#pragma once
+#include "common.h"
+#include "ThreadPool.h"
+
+/*
+ * Bricked volume files (.nvvol), written by volBake from dense voxel grids and streamed by
+ * BrickedVolume. The volume is cut into BRICK_DIM^3 bricks, each stored with an APRON voxel
+ * border copied from its neighbours (clamped at the volume's edges) so that a brick filters
+ * trilinearly on its own once it sits in an atlas. Each brick carries the min / max of its
+ * stored voxels; bricks whose max is at most the empty threshold are not stored at all.
+ *
+ * Layout:
+ *   Header | Brick[bricksX * bricksY * bricksZ] | brick data
+ * Bricks are indexed x fastest, then y, then z; stored bricks are STORED_DIM^3 voxels, x
+ * fastest, at 16-byte aligned offsets.
+ */
+namespace VolumeBricks
+{
+    constexpr uint32_t VOLUME_MAGIC = 0x4c56564e; // "NVVL"
+    constexpr uint32_t VOLUME_VERSION = 1;
+    constexpr uint32_t BRICK_DIM = 32;
+    constexpr uint32_t APRON = 1;
+    constexpr uint32_t STORED_DIM = BRICK_DIM + 2 * APRON;
+    constexpr size_t BRICK_ALIGNMENT = 16;
+    // the brick grid must fit a 3D page table image on any GPU
+    constexpr uint32_t MAX_BRICKS_PER_AXIS = 2048;
+    CHAR_CONSTEXPR VOLUME_EXTENSION = ".nvvol";
+
+    enum class VoxelFormat : uint32_t
+    {
+        R8 = 1,
+        // little endian
+        R16 = 2,
+    };
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        VoxelFormat format;
+        uint32_t brickDim;
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth;
+        uint32_t emptyThreshold;
+        uint32_t bricksX;
+        uint32_t bricksY;
+        uint32_t bricksZ;
+        uint32_t reserved;
+    };
+
+    struct Brick
+    {
+        // 0 for empty bricks, which have no data
+        uint64_t offset;
+        uint16_t minValue;
+        uint16_t maxValue;
+        uint32_t reserved;
+    };
+
+    // 0 for unknown formats
+    size_t voxelBytes(VoxelFormat format);
+
+    // bytes of one stored brick, apron included
+    uint64_t storedBrickBytes(VoxelFormat format);
+
+    // bricks along one axis of that many voxels
+    uint32_t brickCount(uint32_t voxels);
+
+    /**
+     * Copies brick (bx, by, bz) of a dense volume with its apron into dst, which holds
+     * storedBrickBytes(format) bytes.
+     * @return the min and max of the copied voxels
+     */
+    std::pair<uint16_t, uint16_t> extractBrick(
+            uint8_t const* voxels, VoxelFormat format, uint32_t width, uint32_t height, uint32_t depth,
+            uint32_t bx, uint32_t by, uint32_t bz, uint8_t* dst);
+
+    /**
+     * Bricks a dense volume, x fastest then y then z, into a .nvvol file. Only one row of bricks
+     * is held in memory at a time, so voxels can be a mapping of a file larger than memory.
+     * Rows are spread over the pool when one is given.
+     * @param emptyThreshold bricks whose voxels are all at most this are skipped
+     * @return false if the file cannot be written
+     */
+    bool bake(
+            std::string const& file, uint8_t const* voxels, VoxelFormat format,
+            uint32_t width, uint32_t height, uint32_t depth, uint16_t emptyThreshold,
+            ThreadPool* pool = nullptr);
+}
@@ -7,6 +7,14 @@
 #include "WindowBase.h"
 #include "Mesh.h"
 #include "Drawable.h"
+#include "AssetRegistry.h"
+#include "AssetWatcher.h"
+#include "BrickedVolume.h"
+#include "DisposableCmdBuffer.h"
+#include "ResidencyManager.h"
+#include "TextureStreamer.h"
+
+#include <future>
 
 class Window : public WindowBase
 {
@@ -20,9 +28,17 @@ public:
     ~Window() override;
     int mainLoop();
 
+    /**
+     * @param bias log2 of the projected simplification error (in pixels) a LOD level may have;
+     * 0 allows one pixel, positive values switch to coarser levels sooner
+     */
+    void setLodBias(float bias);
+
 protected:
     // Callback functions
     static void onWindowSizeChange(GLFWwindow* ptr, int width, int height);
+    // '[' and ']' lower and raise the LOD bias
+    static void onKey(GLFWwindow* ptr, int key, int scancode, int action, int mods);
 
     virtual void updateFrame(float const& deltaTime);
     VkResult createCommandPool();
@@ -33,11 +49,99 @@ protected:
     void resetSwapChain();
 
     void initBuffers();
+
+    // a texture read into a staging buffer, ready to be copied into its image
+    struct StagedTexture
+    {
+        std::shared_ptr<Buffers::StagingBuffer> staging;
+        std::pair<uint32_t, uint32_t> size;
+        uint32_t mipLevels = 0;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        // where each level is in staging; only level 0 when the GPU blits the rest
+        std::vector<VkDeviceSize> levelOffsets;
+        bool blitMips = false;
+    };
+
+    /**
+     * Loads a .nvtex, KTX2 or DDS texture with its mips as they are. For a PNG, prefers the baked
+     * texture next to it (see BakedTexture) and otherwise makes the mips at load.
+     * Throws std::runtime_error if the texture cannot be read or the GPU cannot sample its format.
+     */
+    Image::Image loadTexture(std::string const& name);
+    // the CPU half of loadTexture, safe to run on the ThreadPool
+    StagedTexture stageTexture(std::string const& name);
+    // creates the texture's image and records its copies, and mip blits if any, into cmdBuffer
+    Image::Image createTexture(StagedTexture const& staged, VkCommandBuffer& cmdBuffer);
+    /**
+     * The .nvtex, KTX2 or DDS texture to use for name, as loadTexture picks it.
+     * @return nullopt for a PNG without a baked texture the GPU can sample
+     */
+    optional<BakedTexture> openBakedTexture(std::string const& name) const;
+    [[nodiscard]]
+    VkSamplerCreateInfo textureSamplerInfo(uint32_t mipLevels) const;
+    // the texture bound to the descriptor sets, whether streamed or not
+    Image::Image& sampledTexture();
+    // changes whenever sampledTexture() is replaced by a new image
+    [[nodiscard]]
+    uint64_t textureVersion() const;
+
+    // watches the files the meshes and whole textures of assets were loaded from
+    void watchAssets();
+    /**
+     * Call once per frame, once the frame's fence has been waited on and before the residency
+     * update. Starts reimporting the watched assets whose files were written, swaps in those
+     * reimported and frees the replaced ones once no frame in flight uses them.
+     */
+    void reloadAssets();
+    void startMeshReload(AssetRegistry::Source<Mesh> const& source);
+    void startTextureReload(TextureHandle handle, std::string const& name);
     void setUniforms(UniformObjBuffer<UniformObjects>& bufObject);
     void setLights(StorageBufferArray<Light>& storageObj);
+    [[nodiscard]]
+    glm::mat4 viewMatrix() const;
+    [[nodiscard]]
+    size_t selectLod(Mesh const& mesh, glm::mat4 const& model) const;
+    // screen pixels per world space unit at the point of the mesh's bounds nearest to the camera
+    [[nodiscard]]
+    float pixelsPerUnit(Mesh const& mesh, glm::mat4 const& model) const;
+    /**
+     * Finest mip level of a texture textureExtent texels wide that the mesh needs on screen,
+     * taking the texture to span the mesh's longest side once.
+     */
+    [[nodiscard]]
+    uint32_t selectTextureLevel(Mesh const& mesh, glm::mat4 const& model, uint32_t textureExtent) const;
 
     void initCallbacks();
 private:
+    struct MeshReload
+    {
+        AssetRegistry::Source<Mesh> source;
+        std::future<Mesh> import;
+        // the file was written again during the import
+        bool again = false;
+    };
+
+    struct TextureReload
+    {
+        TextureHandle handle;
+        std::string name;
+        // set by the read on the ThreadPool
+        std::shared_ptr<optional<StagedTexture>> staged;
+        std::future<void> read;
+        Image::Image image;
+        std::unique_ptr<DisposableCmdBuffer> upload;
+        VkFence fence = VK_NULL_HANDLE;
+        bool submitted = false;
+        bool again = false;
+    };
+
+    template<typename T>
+    struct Retired
+    {
+        T record;
+        uint64_t frame;
+    };
+
     bool running = true;
     std::unique_ptr<SwapchainComponents> swapchainComponent;
     VkCommandPool cmdPool = VK_NULL_HANDLE;
@@ -51,7 +155,17 @@ private:
     // buffers
     std::vector<FrameSemaphores> frameSemaphores;
     size_t currentFrame = 0;
-    Image::Image img;
+    // texture loaded whole into assets when it is not streamed
+    TextureHandle loadedTexture;
+    // textures with baked mip levels stream them in by screen coverage instead of loading them whole
+    bool streamTextures = true;
+    std::unique_ptr<TextureStreamer> textureStreamer;
+    // index of the texture in textureStreamer, when streamed
+    optional<size_t> streamedTexture;
+    // bumped when a reload replaces loadedTexture
+    uint64_t loadedTextureVersion = 0;
+    // textureVersion() each descriptor set was last written with
+    std::vector<uint64_t> boundTextureVersions;
     Image::Image depthBuffer;
     float totalTime = 0;
 
@@ -59,7 +173,32 @@ private:
     float clipNear, clipFar;
     glm::mat4 projectMat;
     glm::vec3 cameraPos;
+    float lodBias = 0.f;
+    // vertex layout of the pipeline and all meshes
+    VertexFormat vertexFormat = QUANTIZED_VERTEX;
 
-    std::map<std::string, std::unique_ptr<Mesh>> meshStorage;
+    // meshes and whole textures, deduplicated by name and contents
+    AssetRegistry assets;
+    std::unique_ptr<ResidencyManager> residency;
+    // bytes of resident meshes; 0 follows the device's memory budget
+    VkDeviceSize meshBudget = 0;
     std::vector<Drawable> drawables;
+    // streamed by the view frustum each frame when the file exists; not drawn yet
+    std::string volumeName = "assets/volume.nvvol";
+    std::unique_ptr<BrickedVolume> volume;
+    // voxel space to world space, the volume's longest side spanning one unit
+    glm::mat4 volumeModel = glm::mat4(1.f);
+
+    // hot reloading; null where files cannot be watched
+    std::unique_ptr<AssetWatcher> assetWatcher;
+    // asset names loaded from each watched file, by canonical path
+    std::unordered_map<std::string, std::vector<std::string>> watchedFiles;
+    std::vector<MeshReload> meshReloads;
+    std::vector<TextureReload> textureReloads;
+    // assets reloads replaced, with the frame they were replaced in
+    std::vector<Retired<Mesh>> retiredMeshes;
+    std::vector<Retired<Image::Image>> retiredTextures;
+    uint64_t reloadFrame = 0;
+    // (firstIndex, indexCount) of visible meshlet runs, reused across draws
+    std::vector<std::pair<uint32_t, uint32_t>> drawRanges;
 };
\ No newline at end of file
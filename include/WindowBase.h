@@ -96,4 +96,8 @@ protected:
     VkDevice logicalDev = {};
     VmaAllocator allocator = VK_NULL_HANDLE;
     VkSurfaceKHR surface = VK_NULL_HANDLE;
+    // whether the device samples BC1-BC7 block compressed formats
+    bool bcTextures = false;
+    // whether VK_EXT_memory_budget is enabled, and VMA's heap budgets come from it
+    bool memoryBudgetExt = false;
 };
@@ -9,14 +9,20 @@
 #include <utility>
 #include <cstdlib>
 
-#include <png++/color.hpp>
-#include <png++/image.hpp>
-
 namespace helpers
 {
     bool fileExists(std::string const& prefix, std::string const& file);
     std::string searchPath(std::string const& file);
 
+    /**
+     * Contents of an asset: from the mounted AssetArchive if it has one by that name,
+     * else from searchPath(name). Throws std::runtime_error if neither has it.
+     */
+    std::vector<uint8_t> readAsset(std::string const& name);
+
+    // non-cryptographic 64-bit hash, for content identity and cache invalidation
+    uint64_t hashBytes(void const* data, size_t size, uint64_t seed = 0);
+
     template<typename PixelFmt>
     struct img
     {
@@ -35,7 +41,10 @@ namespace helpers
             return { width, height };
         }
     };
+    // row-major, one RGBA8 pixel per uint32_t
     typedef img<uint32_t> img_r8g8b8a8;
 
     img_r8g8b8a8 fromPng(std::string const& file);
+    // decodes a PNG file already in memory
+    img_r8g8b8a8 fromPng(std::vector<uint8_t> const& pngData);
 }
\ No newline at end of file
@@ -17,4 +17,6 @@ cbuffer MeshUBO
     float _unused;
     float4x4 meshModel;
     float4x4 meshModelInvDual;
+    float4 meshPosOffset;
+    float4 meshPosScale;
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 struct VertexInput
 {
+    // QVertex: unorm16 position relative to the mesh bounds and octahedral normal in .xy
     [[vk::location(0)]]
     float3 inPosition : VTX_INPUT;
 
@@ -2,16 +2,34 @@
 #include "pixelshader.hlsli"
 #include "ubo.hlsli"
 
+// set from the window's VertexFormat when the pipeline is created
+[[vk::constant_id(0)]]
+const bool quantizedVertices = false;
+
+float3 decodeOctahedral(float2 e)
+{
+    float3 n = float3(e, 1 - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy += float2(n.x >= 0 ? -t : t, n.y >= 0 ? -t : t);
+    return n;
+}
 
 PixelShaderInput main(VertexInput vi)
 {
     PixelShaderInput psi;
-    float4 inPos4 = float4(vi.inPosition,1);
+    float3 pos = vi.inPosition;
+    float3 normal = vi.inNormal;
+    if (quantizedVertices)
+    {
+        pos = meshPosOffset.xyz + meshPosScale.xyz * pos;
+        normal = decodeOctahedral(vi.inNormal.xy);
+    }
+    float4 inPos4 = float4(pos,1);
 
     float4x4 MVP = mul(proj, mul(view, meshModel));
     psi.scrPos = mul(MVP, inPos4);
 
-    float4 inNormalZ = mul(meshModelInvDual, float4(vi.inNormal,0));
+    float4 inNormalZ = mul(meshModelInvDual, float4(normal,0));
     psi.inNormal = normalize(inNormalZ.xyz);
     psi.outTexCoord = vi.texCoord;
     psi.worldPos = mul(meshModel, inPos4).xyz;
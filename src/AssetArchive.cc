@@ -0,0 +1,388 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "AssetArchive.h"
+#include "Lz4.h"
+#include "helpers.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    optional<AssetArchive> mountedArchive;
+
+    bool entryLess(AssetArchive::Entry const& entry, std::string_view entryName,
+                   uint64_t nameHash, std::string_view name)
+    {
+        return entry.nameHash != nameHash ? entry.nameHash < nameHash : entryName < name;
+    }
+
+    bool validTables(MappedFile const& file)
+    {
+        using Header = AssetArchive::Header;
+        if (file.size() < sizeof(Header))
+        {
+            return false;
+        }
+
+        Header hdr;
+        memcpy(&hdr, file.data(), sizeof(Header));
+        if (hdr.magic != AssetArchive::ARCHIVE_MAGIC || hdr.version != AssetArchive::ARCHIVE_VERSION ||
+            hdr.blockSize == 0)
+        {
+            return false;
+        }
+
+        // table extents, written so that none of the products can overflow
+        uint64_t size = file.size();
+        if (hdr.blockOffset > size || hdr.blockCount > (size - hdr.blockOffset) / sizeof(AssetArchive::Block) ||
+            hdr.entryOffset > size || hdr.entryCount > (size - hdr.entryOffset) / sizeof(AssetArchive::Entry) ||
+            hdr.namesOffset > size || hdr.namesSize > size - hdr.namesOffset ||
+            hdr.blockOffset % alignof(AssetArchive::Block) != 0 || hdr.entryOffset % alignof(AssetArchive::Entry) != 0)
+        {
+            return false;
+        }
+
+        auto const* blocks = reinterpret_cast<AssetArchive::Block const*>(file.data() + hdr.blockOffset);
+        for (uint64_t i = 0; i < hdr.blockCount; ++i)
+        {
+            auto const& block = blocks[i];
+            if (block.offset > size || block.storedSize > size - block.offset || block.rawSize > hdr.blockSize ||
+                block.storedSize > block.rawSize)
+            {
+                return false;
+            }
+        }
+
+        auto const* entries = reinterpret_cast<AssetArchive::Entry const*>(file.data() + hdr.entryOffset);
+        for (uint32_t i = 0; i < hdr.entryCount; ++i)
+        {
+            auto const& entry = entries[i];
+            if (entry.firstBlock > hdr.blockCount || entry.blockCount > hdr.blockCount - entry.firstBlock ||
+                entry.nameOffset > hdr.namesSize || entry.nameLength > hdr.namesSize - entry.nameOffset)
+            {
+                return false;
+            }
+
+            uint64_t rawSize = 0;
+            for (uint64_t b = 0; b < entry.blockCount; ++b)
+            {
+                rawSize += blocks[entry.firstBlock + b].rawSize;
+            }
+            if (rawSize != entry.size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+optional<AssetArchive> AssetArchive::open(std::string const& archiveFile)
+{
+    MappedFile file(archiveFile);
+    if (!file || !validTables(file))
+    {
+        return nullopt;
+    }
+    return AssetArchive(std::move(file));
+}
+
+bool AssetArchive::mount(std::string const& archiveFile)
+{
+    auto archive = open(archiveFile);
+    if (!archive.has_value())
+    {
+        return false;
+    }
+    mountedArchive = std::move(archive);
+    return true;
+}
+
+AssetArchive const* AssetArchive::mounted()
+{
+    return mountedArchive.has_value() ? &mountedArchive.value() : nullptr;
+}
+
+AssetArchive::AssetArchive(MappedFile&& file) : file(std::move(file))
+{
+}
+
+AssetArchive::Header const& AssetArchive::header() const
+{
+    return *reinterpret_cast<Header const*>(file.data());
+}
+
+AssetArchive::Block const* AssetArchive::blocks() const
+{
+    return reinterpret_cast<Block const*>(file.data() + header().blockOffset);
+}
+
+AssetArchive::Entry const* AssetArchive::entries() const
+{
+    return reinterpret_cast<Entry const*>(file.data() + header().entryOffset);
+}
+
+size_t AssetArchive::entryCount() const
+{
+    return file ? header().entryCount : 0;
+}
+
+std::string_view AssetArchive::name(Entry const& entry) const
+{
+    auto const* names = reinterpret_cast<char const*>(file.data() + header().namesOffset);
+    return {names + entry.nameOffset, entry.nameLength};
+}
+
+AssetArchive::Entry const* AssetArchive::find(std::string_view assetName) const
+{
+    uint64_t nameHash = helpers::hashBytes(assetName.data(), assetName.size());
+    Entry const* begin = entries();
+    Entry const* end = begin + entryCount();
+
+    auto const* it = std::lower_bound(begin, end, assetName, [&](Entry const& entry, std::string_view key)
+    {
+        return entryLess(entry, name(entry), nameHash, key);
+    });
+    if (it == end || it->nameHash != nameHash || name(*it) != assetName)
+    {
+        return nullptr;
+    }
+    return it;
+}
+
+uint8_t const* AssetArchive::view(Entry const& entry) const
+{
+    Block const* entryBlocks = blocks() + entry.firstBlock;
+    for (uint64_t b = 0; b < entry.blockCount; ++b)
+    {
+        if (entryBlocks[b].storedSize != entryBlocks[b].rawSize ||
+            (b > 0 && entryBlocks[b].offset != entryBlocks[b - 1].offset + entryBlocks[b - 1].rawSize))
+        {
+            return nullptr;
+        }
+    }
+    return entry.blockCount > 0 ? file.data() + entryBlocks[0].offset : file.data();
+}
+
+bool AssetArchive::read(Entry const& entry, uint8_t* dst) const
+{
+    return read(entry, 0, entry.size, dst);
+}
+
+bool AssetArchive::read(Entry const& entry, uint64_t offset, size_t size, uint8_t* dst) const
+{
+    if (offset > entry.size || size > entry.size - offset)
+    {
+        return false;
+    }
+
+    uint64_t end = offset + size;
+    uint64_t blockStart = 0;
+    std::vector<uint8_t> partial;
+    Block const* entryBlocks = blocks() + entry.firstBlock;
+    for (uint64_t b = 0; b < entry.blockCount && blockStart < end; ++b)
+    {
+        auto const& block = entryBlocks[b];
+        uint64_t blockEnd = blockStart + block.rawSize;
+        if (blockEnd <= offset)
+        {
+            blockStart = blockEnd;
+            continue;
+        }
+
+        uint64_t from = std::max(offset, blockStart);
+        uint64_t to = std::min(end, blockEnd);
+        uint8_t* out = dst + (from - offset);
+        uint8_t const* src = file.data() + block.offset;
+        if (block.storedSize == block.rawSize)
+        {
+            memcpy(out, src + (from - blockStart), to - from);
+        }
+        else if (from == blockStart && to == blockEnd)
+        {
+            // whole blocks decompress straight into the destination
+            if (!Lz4::decompress(src, block.storedSize, out, block.rawSize))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            partial.resize(block.rawSize);
+            if (!Lz4::decompress(src, block.storedSize, partial.data(), block.rawSize))
+            {
+                return false;
+            }
+            memcpy(out, partial.data() + (from - blockStart), to - from);
+        }
+        blockStart = blockEnd;
+    }
+    return true;
+}
+
+std::vector<uint8_t> AssetArchive::read(Entry const& entry) const
+{
+    std::vector<uint8_t> data(entry.size);
+    if (!read(entry, data.data()))
+    {
+        throw std::runtime_error("Corrupt asset " + std::string(name(entry)) + " in archive!");
+    }
+    return data;
+}
+
+std::string AssetArchive::normalizeName(std::string_view assetName)
+{
+    std::string out(assetName);
+    std::replace(out.begin(), out.end(), '\\', '/');
+    while (out.compare(0, 2, "./") == 0)
+    {
+        out.erase(0, 2);
+    }
+    return out;
+}
+
+bool AssetArchive::write(
+        std::string const& archiveFile, std::vector<std::pair<std::string, std::string>> const& files,
+        uint32_t blockSize)
+{
+    struct Pending
+    {
+        std::string name;
+        uint64_t nameHash;
+        std::string path;
+    };
+
+    std::vector<Pending> pending;
+    for (auto const& [assetName, path] : files)
+    {
+        std::string normalized = normalizeName(assetName);
+        uint64_t nameHash = helpers::hashBytes(normalized.data(), normalized.size());
+        pending.push_back({std::move(normalized), nameHash, path});
+    }
+    std::sort(pending.begin(), pending.end(), [](Pending const& a, Pending const& b)
+    {
+        return a.nameHash != b.nameHash ? a.nameHash < b.nameHash : a.name < b.name;
+    });
+    for (size_t i = 1; i < pending.size(); ++i)
+    {
+        if (pending[i].name == pending[i - 1].name)
+        {
+            return false;
+        }
+    }
+
+    Header hdr = {};
+    hdr.magic = ARCHIVE_MAGIC;
+    hdr.version = ARCHIVE_VERSION;
+    hdr.blockSize = blockSize;
+    hdr.entryCount = static_cast<uint32_t>(pending.size());
+
+    std::vector<Block> blockTable;
+    std::vector<Entry> entryTable;
+    std::string names;
+
+    std::string tmpFile = archiveFile + ".tmp";
+    {
+        std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+
+        char const padding[DATA_ALIGNMENT] = {};
+        uint64_t offset = sizeof(Header);
+        auto pad = [&]()
+        {
+            size_t padSize = (DATA_ALIGNMENT - offset % DATA_ALIGNMENT) % DATA_ALIGNMENT;
+            out.write(padding, static_cast<std::streamsize>(padSize));
+            offset += padSize;
+        };
+
+        out.write(reinterpret_cast<char const*>(&hdr), sizeof(Header));
+        std::vector<uint8_t> compressed(Lz4::compressBound(blockSize));
+        bool failed = false;
+        for (auto const& asset : pending)
+        {
+            MappedFile source(asset.path);
+            std::error_code err;
+            // MappedFile refuses empty files
+            if (!source && std::filesystem::file_size(asset.path, err) != 0)
+            {
+                failed = true;
+                break;
+            }
+
+            Entry entry = {};
+            entry.nameHash = asset.nameHash;
+            entry.contentHash = helpers::hashBytes(source.data(), source.size());
+            entry.size = source.size();
+            entry.firstBlock = blockTable.size();
+            entry.nameOffset = static_cast<uint32_t>(names.size());
+            entry.nameLength = static_cast<uint32_t>(asset.name.size());
+            names += asset.name;
+
+            pad();
+            for (size_t pos = 0; pos < source.size(); pos += blockSize)
+            {
+                auto rawSize = static_cast<uint32_t>(std::min<size_t>(blockSize, source.size() - pos));
+                size_t storedSize = Lz4::compress(source.data() + pos, rawSize, compressed.data(), compressed.size());
+
+                Block block = {};
+                block.offset = offset;
+                block.rawSize = rawSize;
+                if (storedSize == 0 || storedSize >= rawSize)
+                {
+                    block.storedSize = rawSize;
+                    out.write(reinterpret_cast<char const*>(source.data() + pos), rawSize);
+                }
+                else
+                {
+                    block.storedSize = static_cast<uint32_t>(storedSize);
+                    out.write(reinterpret_cast<char const*>(compressed.data()), static_cast<std::streamsize>(storedSize));
+                }
+                offset += block.storedSize;
+                blockTable.push_back(block);
+            }
+            entry.blockCount = blockTable.size() - entry.firstBlock;
+            entryTable.push_back(entry);
+        }
+
+        pad();
+        hdr.blockCount = blockTable.size();
+        hdr.blockOffset = offset;
+        out.write(reinterpret_cast<char const*>(blockTable.data()),
+                  static_cast<std::streamsize>(blockTable.size() * sizeof(Block)));
+        offset += blockTable.size() * sizeof(Block);
+
+        hdr.entryOffset = offset;
+        out.write(reinterpret_cast<char const*>(entryTable.data()),
+                  static_cast<std::streamsize>(entryTable.size() * sizeof(Entry)));
+        offset += entryTable.size() * sizeof(Entry);
+
+        hdr.namesOffset = offset;
+        hdr.namesSize = names.size();
+        out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        out.seekp(0);
+        out.write(reinterpret_cast<char const*>(&hdr), sizeof(Header));
+
+        if (failed || !out)
+        {
+            out.close();
+            std::filesystem::remove(tmpFile);
+            return false;
+        }
+    }
+
+    std::error_code err;
+    std::filesystem::rename(tmpFile, archiveFile, err);
+    if (err)
+    {
+        std::filesystem::remove(tmpFile, err);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,214 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "AssetFile.h"
+#include "helpers.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // bounds a single read call; ReadFile takes a 32-bit length
+    constexpr size_t MAX_READ_SIZE = size_t(1) << 30;
+}
+
+AssetFile::~AssetFile()
+{
+    close();
+}
+
+AssetFile AssetFile::fromPath(std::string const& path)
+{
+    AssetFile af;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return af;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return af;
+    }
+    af.fileHandle = file;
+    af.fileSize = static_cast<uint64_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return af;
+    }
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return af;
+    }
+    af.fileHandle = fd;
+    af.fileSize = static_cast<uint64_t>(st.st_size);
+#endif
+    return af;
+}
+
+AssetFile AssetFile::fromArchive(AssetArchive const& archive, AssetArchive::Entry const& entry)
+{
+    AssetFile af;
+    af.archive = &archive;
+    af.entry = &entry;
+    af.fileSize = entry.size;
+    return af;
+}
+
+AssetFile AssetFile::open(std::string const& assetName)
+{
+    if (auto const* archive = AssetArchive::mounted())
+    {
+        if (auto const* entry = archive->find(AssetArchive::normalizeName(assetName)))
+        {
+            return fromArchive(*archive, *entry);
+        }
+    }
+
+    std::string path = helpers::searchPath(assetName);
+    return path.empty() ? AssetFile() : fromPath(path);
+}
+
+AssetFile::AssetFile(AssetFile&& af) noexcept :
+        archive(af.archive), entry(af.entry), fileHandle(af.fileHandle), fileSize(af.fileSize)
+{
+    af.archive = nullptr;
+    af.entry = nullptr;
+    af.fileHandle = INVALID_FILE;
+    af.fileSize = 0;
+}
+
+AssetFile& AssetFile::operator=(AssetFile&& af) noexcept
+{
+    if (this != &af)
+    {
+        close();
+
+        archive = af.archive;
+        entry = af.entry;
+        fileHandle = af.fileHandle;
+        fileSize = af.fileSize;
+        af.archive = nullptr;
+        af.entry = nullptr;
+        af.fileHandle = INVALID_FILE;
+        af.fileSize = 0;
+    }
+    return *this;
+}
+
+uint64_t AssetFile::size() const
+{
+    return fileSize;
+}
+
+bool AssetFile::read(uint64_t offset, size_t size, void* dst) const
+{
+    if (offset > fileSize || size > fileSize - offset)
+    {
+        return false;
+    }
+    if (entry)
+    {
+        return archive->read(*entry, offset, size, reinterpret_cast<uint8_t*>(dst));
+    }
+    if (fileHandle == INVALID_FILE)
+    {
+        return false;
+    }
+
+    auto* out = reinterpret_cast<uint8_t*>(dst);
+    while (size > 0)
+    {
+        size_t chunk = std::min(size, MAX_READ_SIZE);
+#if defined(_WIN32)
+        // positional read on a synchronous handle; the offset comes from the OVERLAPPED
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD bytesRead = 0;
+        if (!ReadFile(fileHandle, out, static_cast<DWORD>(chunk), &bytesRead, &overlapped) || bytesRead == 0)
+        {
+            return false;
+        }
+#else
+        ssize_t bytesRead = pread(fileHandle, out, chunk, static_cast<off_t>(offset));
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytesRead <= 0)
+        {
+            // error, or the file shrank since it was opened
+            return false;
+        }
+#endif
+        out += bytesRead;
+        offset += static_cast<uint64_t>(bytesRead);
+        size -= static_cast<size_t>(bytesRead);
+    }
+    return true;
+}
+
+std::shared_ptr<Buffers::StagingBuffer> AssetFile::stage(
+        VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+        std::vector<std::pair<uint64_t, size_t>> const& ranges,
+        std::set<uint32_t> const& transferQueues) const
+{
+    size_t totalSize = 0;
+    for (auto const& [offset, size] : ranges)
+    {
+        totalSize += size;
+    }
+
+    auto stg_ptr = std::make_shared<Buffers::StagingBuffer>(
+            dev, allocator, physicalDev, totalSize,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            transferQueues);
+
+    uint8_t* dst = stg_ptr->mapped();
+    for (auto const& [offset, size] : ranges)
+    {
+        if (!read(offset, size, dst))
+        {
+            throw std::runtime_error("Cannot read asset data into staging buffer!");
+        }
+        dst += size;
+    }
+    return stg_ptr;
+}
+
+void AssetFile::close()
+{
+    if (fileHandle != INVALID_FILE)
+    {
+#if defined(_WIN32)
+        CloseHandle(fileHandle);
+#else
+        ::close(fileHandle);
+#endif
+        fileHandle = INVALID_FILE;
+    }
+    archive = nullptr;
+    entry = nullptr;
+    fileSize = 0;
+}
@@ -0,0 +1,171 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "AssetRegistry.h"
+#include "AssetArchive.h"
+#include "MappedFile.h"
+#include "helpers.h"
+
+MeshHandle AssetRegistry::loadMesh(
+        std::string const& assetName, uint64_t variant, std::function<Mesh()> const& load)
+{
+    return AssetRegistry::load(meshPool, meshIndex, assetName, variant, load);
+}
+
+TextureHandle AssetRegistry::loadTexture(
+        std::string const& assetName, uint64_t variant, std::function<Image::Image()> const& load)
+{
+    return AssetRegistry::load(texturePool, textureIndex, assetName, variant, load);
+}
+
+Mesh& AssetRegistry::mesh(MeshHandle handle)
+{
+    return meshPool.at(handle);
+}
+
+Image::Image& AssetRegistry::texture(TextureHandle handle)
+{
+    return texturePool.at(handle);
+}
+
+bool AssetRegistry::contains(MeshHandle handle) const
+{
+    return meshPool.contains(handle);
+}
+
+bool AssetRegistry::contains(TextureHandle handle) const
+{
+    return texturePool.contains(handle);
+}
+
+std::vector<AssetRegistry::Source<Mesh>> AssetRegistry::meshSources(std::string const& assetName) const
+{
+    return sources(meshIndex, assetName);
+}
+
+std::vector<AssetRegistry::Source<Image::Image>> AssetRegistry::textureSources(std::string const& assetName) const
+{
+    return sources(textureIndex, assetName);
+}
+
+std::set<std::string> AssetRegistry::assetNames() const
+{
+    std::set<std::string> assetNames;
+    for (auto const& [key, named] : meshIndex.names)
+    {
+        assetNames.insert(named.assetName);
+    }
+    for (auto const& [key, named] : textureIndex.names)
+    {
+        assetNames.insert(named.assetName);
+    }
+    return assetNames;
+}
+
+Mesh AssetRegistry::replace(MeshHandle handle, Mesh&& mesh)
+{
+    forget(meshIndex, handle, true);
+    return meshPool.replace(handle, std::move(mesh));
+}
+
+Image::Image AssetRegistry::replace(TextureHandle handle, Image::Image&& texture)
+{
+    forget(textureIndex, handle, true);
+    return texturePool.replace(handle, std::move(texture));
+}
+
+bool AssetRegistry::unload(MeshHandle handle)
+{
+    forget(meshIndex, handle);
+    return meshPool.erase(handle);
+}
+
+bool AssetRegistry::unload(TextureHandle handle)
+{
+    forget(textureIndex, handle);
+    return texturePool.erase(handle);
+}
+
+DensePool<Mesh>& AssetRegistry::meshes()
+{
+    return meshPool;
+}
+
+DensePool<Image::Image>& AssetRegistry::textures()
+{
+    return texturePool;
+}
+
+uint64_t AssetRegistry::contentHash(std::string const& assetName)
+{
+    if (auto const* archive = AssetArchive::mounted())
+    {
+        if (auto const* entry = archive->find(AssetArchive::normalizeName(assetName)))
+        {
+            return entry->contentHash;
+        }
+    }
+
+    std::string path = helpers::searchPath(assetName);
+    MappedFile source = path.empty() ? MappedFile() : MappedFile(path);
+    if (!source)
+    {
+        throw std::runtime_error("Cannot find asset " + assetName);
+    }
+    return helpers::hashBytes(source.data(), source.size());
+}
+
+template<typename T>
+AssetHandle<T> AssetRegistry::load(
+        DensePool<T>& pool, Index<T>& index,
+        std::string const& assetName, uint64_t variant, std::function<T()> const& create)
+{
+    // names are checked first so that known assets are not hashed again
+    std::string nameKey = assetName + '#' + std::to_string(variant);
+    auto named = index.names.find(nameKey);
+    if (named != index.names.end())
+    {
+        return named->second.handle;
+    }
+
+    uint64_t contentKey = helpers::hashBytes(&variant, sizeof(uint64_t), contentHash(assetName));
+    auto same = index.contents.find(contentKey);
+    if (same != index.contents.end())
+    {
+        index.names.emplace(nameKey, Named<T>{ assetName, same->second, create });
+        return same->second;
+    }
+
+    AssetHandle<T> handle = pool.insert(create());
+    index.names.emplace(nameKey, Named<T>{ assetName, handle, create });
+    index.contents.emplace(contentKey, handle);
+    return handle;
+}
+
+template<typename T>
+std::vector<AssetRegistry::Source<T>> AssetRegistry::sources(Index<T> const& index, std::string const& assetName)
+{
+    std::vector<Source<T>> found;
+    for (auto const& [key, named] : index.names)
+    {
+        if (named.assetName == assetName)
+        {
+            found.push_back({ named.handle, named.load });
+        }
+    }
+    return found;
+}
+
+template<typename T>
+void AssetRegistry::forget(Index<T>& index, AssetHandle<T> handle, bool keepNames)
+{
+    for (auto it = index.names.begin(); it != index.names.end() && !keepNames;)
+    {
+        it = it->second.handle == handle ? index.names.erase(it) : std::next(it);
+    }
+    for (auto it = index.contents.begin(); it != index.contents.end();)
+    {
+        it = it->second == handle ? index.contents.erase(it) : std::next(it);
+    }
+}
@@ -0,0 +1,100 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "AssetWatcher.h"
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+AssetWatcher::AssetWatcher()
+{
+#if defined(__linux__)
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+AssetWatcher::~AssetWatcher()
+{
+#if defined(__linux__)
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+#endif
+}
+
+bool AssetWatcher::watch(std::string const& directory)
+{
+#if defined(__linux__)
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // the same directory gets the same descriptor back
+    int wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR);
+    if (wd < 0)
+    {
+        return false;
+    }
+    directories[wd] = directory;
+    return true;
+#else
+    (void) directory;
+    return false;
+#endif
+}
+
+std::vector<std::string> AssetWatcher::poll()
+{
+    std::vector<std::string> written;
+#if defined(__linux__)
+    if (fd < 0)
+    {
+        return written;
+    }
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    std::set<std::string> seen;
+    for (;;)
+    {
+        ssize_t bytes = read(fd, buffer, sizeof(buffer));
+        if (bytes <= 0)
+        {
+            // EAGAIN once every pending event has been read
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < bytes;)
+        {
+            auto const* event = reinterpret_cast<inotify_event const*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            auto directory = directories.find(event->wd);
+            if (event->len == 0 || (event->mask & IN_ISDIR) || directory == directories.end())
+            {
+                continue;
+            }
+
+            std::string path = directory->second + "/" + event->name;
+            if (seen.insert(path).second)
+            {
+                written.push_back(std::move(path));
+            }
+        }
+    }
+#endif
+    return written;
+}
+
+AssetWatcher::operator bool() const
+{
+#if defined(__linux__)
+    return fd >= 0;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,469 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "BakedTexture.h"
+#include "TextureCodec.h"
+
+#include <filesystem>
+
+namespace
+{
+    // beyond maxImageDimension2D of any GPU, and more levels than any image can have;
+    // checked before tables sized by the file are allocated
+    constexpr uint32_t MAX_EXTENT = 16384;
+    constexpr uint32_t MAX_LEVELS = 32;
+
+    struct FormatInfo
+    {
+        VkFormat format;
+        // bytes per texel, or per 4x4 block for block compressed formats
+        uint32_t blockBytes;
+        bool blockCompressed;
+    };
+
+    // what KTX2 and DDS files may hold; all sampled without conversion
+    FormatInfo const SUPPORTED_FORMATS[] = {
+            { VK_FORMAT_R8G8B8A8_UNORM, 4, false },
+            { VK_FORMAT_R8G8B8A8_SRGB, 4, false },
+            { VK_FORMAT_B8G8R8A8_UNORM, 4, false },
+            { VK_FORMAT_B8G8R8A8_SRGB, 4, false },
+            { VK_FORMAT_BC1_RGB_UNORM_BLOCK, 8, true },
+            { VK_FORMAT_BC1_RGB_SRGB_BLOCK, 8, true },
+            { VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 8, true },
+            { VK_FORMAT_BC1_RGBA_SRGB_BLOCK, 8, true },
+            { VK_FORMAT_BC2_UNORM_BLOCK, 16, true },
+            { VK_FORMAT_BC2_SRGB_BLOCK, 16, true },
+            { VK_FORMAT_BC3_UNORM_BLOCK, 16, true },
+            { VK_FORMAT_BC3_SRGB_BLOCK, 16, true },
+            { VK_FORMAT_BC4_UNORM_BLOCK, 8, true },
+            { VK_FORMAT_BC4_SNORM_BLOCK, 8, true },
+            { VK_FORMAT_BC5_UNORM_BLOCK, 16, true },
+            { VK_FORMAT_BC5_SNORM_BLOCK, 16, true },
+            { VK_FORMAT_BC6H_UFLOAT_BLOCK, 16, true },
+            { VK_FORMAT_BC6H_SFLOAT_BLOCK, 16, true },
+            { VK_FORMAT_BC7_UNORM_BLOCK, 16, true },
+            { VK_FORMAT_BC7_SRGB_BLOCK, 16, true },
+    };
+
+    FormatInfo const* findFormat(VkFormat format)
+    {
+        for (auto const& info : SUPPORTED_FORMATS)
+        {
+            if (info.format == format)
+            {
+                return &info;
+            }
+        }
+        return nullptr;
+    }
+
+    uint64_t levelSize(FormatInfo const& info, uint32_t width, uint32_t height)
+    {
+        if (!info.blockCompressed)
+        {
+            return uint64_t(width) * height * info.blockBytes;
+        }
+        uint32_t dim = TextureCodec::BLOCK_DIM;
+        return uint64_t((width + dim - 1) / dim) * ((height + dim - 1) / dim) * info.blockBytes;
+    }
+
+    constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+    struct Ktx2Header
+    {
+        uint8_t identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct Ktx2Level
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    constexpr uint32_t fourCC(char const (&code)[5])
+    {
+        return uint32_t(uint8_t(code[0])) | uint32_t(uint8_t(code[1])) << 8 |
+               uint32_t(uint8_t(code[2])) << 16 | uint32_t(uint8_t(code[3])) << 24;
+    }
+
+    constexpr uint32_t DDS_MAGIC = fourCC("DDS ");
+    constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    constexpr uint32_t DDSD_DEPTH = 0x800000;
+    constexpr uint32_t DDPF_ALPHAPIXELS = 0x1;
+    constexpr uint32_t DDPF_FOURCC = 0x4;
+    constexpr uint32_t DDPF_RGB = 0x40;
+    constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+    constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+    constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+    constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+    struct DdsPixelFormat
+    {
+        uint32_t size;
+        uint32_t flags;
+        uint32_t fourCC;
+        uint32_t rgbBitCount;
+        uint32_t rMask;
+        uint32_t gMask;
+        uint32_t bMask;
+        uint32_t aMask;
+    };
+
+    struct DdsHeader
+    {
+        uint32_t size;
+        uint32_t flags;
+        uint32_t height;
+        uint32_t width;
+        uint32_t pitchOrLinearSize;
+        uint32_t depth;
+        uint32_t mipMapCount;
+        uint32_t reserved1[11];
+        DdsPixelFormat pixelFormat;
+        uint32_t caps;
+        uint32_t caps2;
+        uint32_t caps3;
+        uint32_t caps4;
+        uint32_t reserved2;
+    };
+
+    struct DdsHeaderDx10
+    {
+        uint32_t dxgiFormat;
+        uint32_t resourceDimension;
+        uint32_t miscFlag;
+        uint32_t arraySize;
+        uint32_t miscFlags2;
+    };
+
+    // DXGI_FORMAT values of the supported formats
+    std::pair<uint32_t, VkFormat> const DXGI_FORMATS[] = {
+            { 28, VK_FORMAT_R8G8B8A8_UNORM },
+            { 29, VK_FORMAT_R8G8B8A8_SRGB },
+            { 71, VK_FORMAT_BC1_RGBA_UNORM_BLOCK },
+            { 72, VK_FORMAT_BC1_RGBA_SRGB_BLOCK },
+            { 74, VK_FORMAT_BC2_UNORM_BLOCK },
+            { 75, VK_FORMAT_BC2_SRGB_BLOCK },
+            { 77, VK_FORMAT_BC3_UNORM_BLOCK },
+            { 78, VK_FORMAT_BC3_SRGB_BLOCK },
+            { 80, VK_FORMAT_BC4_UNORM_BLOCK },
+            { 81, VK_FORMAT_BC4_SNORM_BLOCK },
+            { 83, VK_FORMAT_BC5_UNORM_BLOCK },
+            { 84, VK_FORMAT_BC5_SNORM_BLOCK },
+            { 87, VK_FORMAT_B8G8R8A8_UNORM },
+            { 91, VK_FORMAT_B8G8R8A8_SRGB },
+            { 95, VK_FORMAT_BC6H_UFLOAT_BLOCK },
+            { 96, VK_FORMAT_BC6H_SFLOAT_BLOCK },
+            { 98, VK_FORMAT_BC7_UNORM_BLOCK },
+            { 99, VK_FORMAT_BC7_SRGB_BLOCK },
+    };
+
+    // legacy FourCC codes of block compressed formats
+    std::pair<uint32_t, VkFormat> const DDS_FOURCC_FORMATS[] = {
+            { fourCC("DXT1"), VK_FORMAT_BC1_RGBA_UNORM_BLOCK },
+            { fourCC("DXT2"), VK_FORMAT_BC2_UNORM_BLOCK },
+            { fourCC("DXT3"), VK_FORMAT_BC2_UNORM_BLOCK },
+            { fourCC("DXT4"), VK_FORMAT_BC3_UNORM_BLOCK },
+            { fourCC("DXT5"), VK_FORMAT_BC3_UNORM_BLOCK },
+            { fourCC("ATI1"), VK_FORMAT_BC4_UNORM_BLOCK },
+            { fourCC("BC4U"), VK_FORMAT_BC4_UNORM_BLOCK },
+            { fourCC("BC4S"), VK_FORMAT_BC4_SNORM_BLOCK },
+            { fourCC("ATI2"), VK_FORMAT_BC5_UNORM_BLOCK },
+            { fourCC("BC5U"), VK_FORMAT_BC5_UNORM_BLOCK },
+            { fourCC("BC5S"), VK_FORMAT_BC5_SNORM_BLOCK },
+    };
+
+    template<size_t N>
+    VkFormat lookupFormat(std::pair<uint32_t, VkFormat> const (&table)[N], uint32_t code)
+    {
+        for (auto const& [key, format] : table)
+        {
+            if (key == code)
+            {
+                return format;
+            }
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+}
+
+std::string BakedTexture::bakedPath(std::string const& sourceName)
+{
+    return std::filesystem::path(sourceName).replace_extension(TEXTURE_EXTENSION).generic_string();
+}
+
+optional<BakedTexture> BakedTexture::open(AssetFile&& file)
+{
+    uint8_t magic[sizeof(KTX2_IDENTIFIER)] = {};
+    if (!file || !file.read(0, std::min<uint64_t>(sizeof(magic), file.size()), magic))
+    {
+        return nullopt;
+    }
+
+    uint32_t magic32;
+    memcpy(&magic32, magic, sizeof(uint32_t));
+    BakedTexture texture;
+    bool read = false;
+    if (magic32 == TEXTURE_MAGIC)
+    {
+        read = readNvtex(file, texture);
+    }
+    else if (memcmp(magic, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0)
+    {
+        read = readKtx2(file, texture);
+    }
+    else if (magic32 == DDS_MAGIC)
+    {
+        read = readDds(file, texture);
+    }
+    if (!read)
+    {
+        return nullopt;
+    }
+
+    // every level must hold exactly its size in the format, inside the file
+    FormatInfo const* info = findFormat(texture.vkFormat);
+    uint32_t width = texture.textureWidth;
+    uint32_t height = texture.textureHeight;
+    if (!info || width == 0 || height == 0 || width > MAX_EXTENT || height > MAX_EXTENT ||
+        texture.levelTable.empty() || texture.levelTable.size() > TextureCodec::mipLevelCount(width, height))
+    {
+        return nullopt;
+    }
+    for (size_t level = 0; level < texture.levelTable.size(); ++level)
+    {
+        auto const& [offset, size] = texture.levelTable[level];
+        uint64_t expected = levelSize(*info, std::max(width >> level, 1u), std::max(height >> level, 1u));
+        if (size != expected || offset > file.size() || size > file.size() - offset)
+        {
+            return nullopt;
+        }
+    }
+
+    texture.textureFile = std::move(file);
+    return texture;
+}
+
+bool BakedTexture::readNvtex(AssetFile const& file, BakedTexture& texture)
+{
+    Header hdr;
+    if (!file.read(0, sizeof(Header), &hdr) || hdr.version != TEXTURE_VERSION || hdr.mipLevels > MAX_LEVELS)
+    {
+        return false;
+    }
+
+    switch (hdr.encoding)
+    {
+        case Encoding::RGBA8:
+            texture.vkFormat = hdr.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+            break;
+        case Encoding::BC1:
+            texture.vkFormat = hdr.srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            break;
+        case Encoding::BC7:
+            texture.vkFormat = hdr.srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+            break;
+        default:
+            return false;
+    }
+
+    texture.textureWidth = hdr.width;
+    texture.textureHeight = hdr.height;
+    texture.levelTable.resize(hdr.mipLevels);
+    if (!file.read(sizeof(Header), hdr.mipLevels * sizeof(Level), texture.levelTable.data()))
+    {
+        return false;
+    }
+    return std::all_of(texture.levelTable.begin(), texture.levelTable.end(), [](Level const& level)
+    {
+        return level.offset % LEVEL_ALIGNMENT == 0;
+    });
+}
+
+bool BakedTexture::readKtx2(AssetFile const& file, BakedTexture& texture)
+{
+    Ktx2Header hdr;
+    if (!file.read(0, sizeof(Ktx2Header), &hdr))
+    {
+        return false;
+    }
+
+    // Basis Universal (VK_FORMAT_UNDEFINED) and supercompressed levels would need transcoding;
+    // 1D, 3D, array and cube map textures are not what the 2D images we create can hold
+    if (hdr.vkFormat == VK_FORMAT_UNDEFINED || hdr.supercompressionScheme != 0 || hdr.pixelHeight == 0 ||
+        hdr.pixelDepth != 0 || hdr.layerCount > 1 || hdr.faceCount != 1 || hdr.levelCount > MAX_LEVELS)
+    {
+        return false;
+    }
+
+    texture.vkFormat = static_cast<VkFormat>(hdr.vkFormat);
+    texture.textureWidth = hdr.pixelWidth;
+    texture.textureHeight = hdr.pixelHeight;
+
+    // the level index is ordered largest first, even though the data is stored smallest first
+    std::vector<Ktx2Level> levels(std::max(hdr.levelCount, 1u));
+    if (!file.read(sizeof(Ktx2Header), levels.size() * sizeof(Ktx2Level), levels.data()))
+    {
+        return false;
+    }
+    for (auto const& level : levels)
+    {
+        texture.levelTable.push_back({ level.byteOffset, level.byteLength });
+    }
+    return true;
+}
+
+bool BakedTexture::readDds(AssetFile const& file, BakedTexture& texture)
+{
+    DdsHeader hdr;
+    if (!file.read(sizeof(uint32_t), sizeof(DdsHeader), &hdr) || hdr.size != sizeof(DdsHeader) ||
+        hdr.pixelFormat.size != sizeof(DdsPixelFormat))
+    {
+        return false;
+    }
+    if ((hdr.caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) != 0 || ((hdr.flags & DDSD_DEPTH) != 0 && hdr.depth > 1))
+    {
+        return false;
+    }
+
+    uint64_t dataOffset = sizeof(uint32_t) + sizeof(DdsHeader);
+    auto const& pixelFormat = hdr.pixelFormat;
+    if ((pixelFormat.flags & DDPF_FOURCC) != 0 && pixelFormat.fourCC == fourCC("DX10"))
+    {
+        DdsHeaderDx10 dx10;
+        if (!file.read(dataOffset, sizeof(DdsHeaderDx10), &dx10) ||
+            dx10.resourceDimension != DDS_DIMENSION_TEXTURE2D || dx10.arraySize != 1 ||
+            (dx10.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) != 0)
+        {
+            return false;
+        }
+        texture.vkFormat = lookupFormat(DXGI_FORMATS, dx10.dxgiFormat);
+        dataOffset += sizeof(DdsHeaderDx10);
+    }
+    else if ((pixelFormat.flags & DDPF_FOURCC) != 0)
+    {
+        texture.vkFormat = lookupFormat(DDS_FOURCC_FORMATS, pixelFormat.fourCC);
+    }
+    else if ((pixelFormat.flags & DDPF_RGB) != 0 && (pixelFormat.flags & DDPF_ALPHAPIXELS) != 0 &&
+             pixelFormat.rgbBitCount == 32 && pixelFormat.aMask == 0xFF000000)
+    {
+        if (pixelFormat.rMask == 0xFF && pixelFormat.gMask == 0xFF00 && pixelFormat.bMask == 0xFF0000)
+        {
+            texture.vkFormat = VK_FORMAT_R8G8B8A8_UNORM;
+        }
+        else if (pixelFormat.rMask == 0xFF0000 && pixelFormat.gMask == 0xFF00 && pixelFormat.bMask == 0xFF)
+        {
+            texture.vkFormat = VK_FORMAT_B8G8R8A8_UNORM;
+        }
+    }
+
+    FormatInfo const* info = findFormat(texture.vkFormat);
+    uint32_t levelCount = (hdr.flags & DDSD_MIPMAPCOUNT) != 0 && hdr.mipMapCount > 0 ? hdr.mipMapCount : 1;
+    if (!info || levelCount > MAX_LEVELS)
+    {
+        return false;
+    }
+
+    // levels follow the header back to back, largest first
+    texture.textureWidth = hdr.width;
+    texture.textureHeight = hdr.height;
+    uint64_t offset = dataOffset;
+    for (uint32_t level = 0; level < levelCount; ++level)
+    {
+        uint64_t size = levelSize(*info, std::max(hdr.width >> level, 1u), std::max(hdr.height >> level, 1u));
+        texture.levelTable.push_back({ offset, size });
+        offset += size;
+    }
+    return true;
+}
+
+uint32_t BakedTexture::width() const
+{
+    return textureWidth;
+}
+
+uint32_t BakedTexture::height() const
+{
+    return textureHeight;
+}
+
+uint32_t BakedTexture::mipLevels() const
+{
+    return static_cast<uint32_t>(levelTable.size());
+}
+
+std::vector<BakedTexture::Level> const& BakedTexture::levels() const
+{
+    return levelTable;
+}
+
+VkFormat BakedTexture::format() const
+{
+    return vkFormat;
+}
+
+bool BakedTexture::blockCompressed() const
+{
+    FormatInfo const* info = findFormat(vkFormat);
+    return info && info->blockCompressed;
+}
+
+std::shared_ptr<Buffers::StagingBuffer> BakedTexture::stage(
+        VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+        std::set<uint32_t> const& transferQueues) const
+{
+    std::vector<std::pair<uint64_t, size_t>> ranges;
+    for (auto const& [offset, size] : levelTable)
+    {
+        ranges.emplace_back(offset, size);
+    }
+    return textureFile.stage(dev, allocator, physicalDev, ranges, transferQueues);
+}
+
+std::vector<VkDeviceSize> BakedTexture::levelOffsets() const
+{
+    std::vector<VkDeviceSize> offsets;
+    VkDeviceSize offset = 0;
+    for (auto const& level : levelTable)
+    {
+        offsets.push_back(offset);
+        offset += level.size;
+    }
+    return offsets;
+}
+
+bool BakedTexture::readLevels(uint32_t firstLevel, uint32_t levelCount, uint8_t* dst) const
+{
+    if (firstLevel > levelTable.size() || levelCount > levelTable.size() - firstLevel)
+    {
+        return false;
+    }
+
+    for (uint32_t level = firstLevel; level < firstLevel + levelCount; ++level)
+    {
+        auto const& [offset, size] = levelTable[level];
+        if (!textureFile.read(offset, size, dst))
+        {
+            return false;
+        }
+        dst += size;
+    }
+    return true;
+}
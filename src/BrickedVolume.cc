@@ -0,0 +1,489 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "BrickedVolume.h"
+#include "DisposableCmdBuffer.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+
+namespace
+{
+    // staging offsets of bricks stay aligned for any texel size
+    constexpr uint64_t STAGING_ALIGNMENT = 16;
+    // slot coordinates are stored in 8-bit page table channels
+    constexpr uint32_t MAX_ATLAS_BRICKS = 255;
+}
+
+BrickedVolume::BrickedVolume(
+        VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+        VkQueue const& graphicsQueue, VkCommandPool* graphicsCmdPool,
+        std::set<uint32_t> const& transferQueues,
+        std::string const& assetName,
+        uint32_t atlasBricks) :
+        AVkGraphicsBase(dev), volumeFile(AssetFile::open(assetName)),
+        allocator(allocator), graphicsQueue(graphicsQueue), cmdPool(graphicsCmdPool)
+{
+    using namespace VolumeBricks;
+    if (!volumeFile || !volumeFile.read(0, sizeof(Header), &hdr) ||
+        hdr.magic != VOLUME_MAGIC || hdr.version != VOLUME_VERSION || voxelBytes(hdr.format) == 0 ||
+        hdr.brickDim != BRICK_DIM || hdr.width == 0 || hdr.height == 0 || hdr.depth == 0 ||
+        hdr.bricksX != brickCount(hdr.width) || hdr.bricksY != brickCount(hdr.height) ||
+        hdr.bricksZ != brickCount(hdr.depth) || hdr.bricksX > MAX_BRICKS_PER_AXIS ||
+        hdr.bricksY > MAX_BRICKS_PER_AXIS || hdr.bricksZ > MAX_BRICKS_PER_AXIS)
+    {
+        throw std::runtime_error("Cannot load volume " + assetName);
+    }
+
+    size_t brickTotal = size_t(hdr.bricksX) * hdr.bricksY * hdr.bricksZ;
+    bricks.resize(brickTotal);
+    if (!volumeFile.read(sizeof(Header), brickTotal * sizeof(Brick), bricks.data()))
+    {
+        throw std::runtime_error("Cannot load volume " + assetName);
+    }
+    brickBytes = storedBrickBytes(hdr.format);
+    for (auto const& brick : bricks)
+    {
+        if (brick.offset == 0)
+        {
+            ++emptyCount;
+        }
+        else if (brick.offset > volumeFile.size() || brickBytes > volumeFile.size() - brick.offset)
+        {
+            throw std::runtime_error("Cannot load volume " + assetName);
+        }
+    }
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDev, &props);
+    uint32_t maxExtent = props.limits.maxImageDimension3D;
+    this->atlasBricks = std::min({ atlasBricks, maxExtent / STORED_DIM, MAX_ATLAS_BRICKS });
+    if (this->atlasBricks == 0 || hdr.bricksX > maxExtent || hdr.bricksY > maxExtent || hdr.bricksZ > maxExtent)
+    {
+        throw std::runtime_error("Volume " + assetName + " does not fit the device's 3D images");
+    }
+    size_t slotCount = size_t(this->atlasBricks) * this->atlasBricks * this->atlasBricks;
+    brickSlots.assign(brickTotal, NO_SLOT);
+    brickResident.assign(brickTotal, false);
+    slotBricks.assign(slotCount, NO_SLOT);
+    slotFrames.assign(slotCount, 0);
+
+    VkSamplerCreateInfo samplerInfo = {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.anisotropyEnable = VK_FALSE;
+    samplerInfo.maxAnisotropy = 1;
+    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable = VK_FALSE;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.minLod = 0.0f;
+    samplerInfo.maxLod = 0.0f;
+
+    uint32_t atlasExtent = this->atlasBricks * STORED_DIM;
+    atlasImage = Image::Image(
+            dev, allocator, std::make_tuple(atlasExtent, atlasExtent, atlasExtent),
+            hdr.format == VoxelFormat::R8 ? VK_FORMAT_R8_UNORM : VK_FORMAT_R16_UNORM,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            samplerInfo);
+
+    // integer texels cannot be filtered
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    pageImage = Image::Image(
+            dev, allocator, std::make_tuple(hdr.bricksX, hdr.bricksY, hdr.bricksZ),
+            VK_FORMAT_R8G8B8A8_UINT,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            samplerInfo);
+
+    // every brick starts out empty or not resident
+    Buffers::StagingBuffer pageStaging(
+            dev, allocator, physicalDev, brickTotal * sizeof(uint32_t),
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            transferQueues);
+    auto* entries = reinterpret_cast<uint32_t*>(pageStaging.mapped());
+    for (uint32_t brick = 0; brick < brickTotal; ++brick)
+    {
+        entries[brick] = pageEntry(brick);
+    }
+
+    DisposableCmdBuffer dcb(dev, cmdPool);
+    pageImage.cmdTransitionBeginCopy(dcb.commandBuffer());
+    pageImage.cmdCopyFromBuffer(pageStaging, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, dcb.commandBuffer());
+    pageImage.cmdTransitionEndCopy(dcb.commandBuffer());
+    atlasImage.cmdTransitionLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                   VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                   0, 0, dcb.commandBuffer());
+    dcb.finish();
+    CHECK_VK_SUCCESS(dcb.submit(this->graphicsQueue), ErrorMessages::FAILED_CANNOT_SUBMIT_QUEUE);
+    CHECK_VK_SUCCESS(vkQueueWaitIdle(this->graphicsQueue), ErrorMessages::FAILED_WAIT_IDLE);
+
+    // a batch writes at most one entry per brick it copies, one per brick it evicts and
+    // MAX_BATCH_BRICKS stale ones
+    uint64_t brickStride = (brickBytes + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+    staging = Buffers::StagingBuffer(
+            dev, allocator, physicalDev,
+            MAX_BATCH_BRICKS * brickStride + 3 * MAX_BATCH_BRICKS * sizeof(uint32_t),
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            transferQueues);
+
+    VkFenceCreateInfo fenceCreateInfo = {};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    CHECK_VK_SUCCESS(vkCreateFence(*dev, &fenceCreateInfo, nullptr, &fence), "Cannot create Fence!");
+}
+
+BrickedVolume::~BrickedVolume()
+{
+    if (!initialized())
+    {
+        return;
+    }
+
+    cancel();
+    vkDestroyFence(getLogicalDev(), fence, nullptr);
+}
+
+void BrickedVolume::update(Culling::Frustum const& frustum, glm::mat4 const& model, glm::vec3 const& cameraPos)
+{
+    ++frame;
+    if (batch)
+    {
+        try
+        {
+            if (advance())
+            {
+                batch = nullopt;
+            }
+        }
+        catch (std::exception const& e)
+        {
+            // the bricks that could not be read are treated as empty from now on; their
+            // entries go EMPTY with the next batch
+            std::cerr << "Volume streaming failed: " << e.what() << std::endl;
+            std::vector<uint32_t> failed = batch->bricks;
+            cancel();
+            for (uint32_t brick : failed)
+            {
+                bricks[brick].offset = 0;
+                ++emptyCount;
+                staleEntries.push_back(brick);
+            }
+        }
+    }
+
+    using VolumeBricks::BRICK_DIM;
+    float radius = glm::length(glm::vec3(BRICK_DIM * 0.5f)) * Culling::maxScale(model);
+    std::vector<std::pair<float, uint32_t>> missing;
+    uint32_t brick = 0;
+    for (uint32_t bz = 0; bz < hdr.bricksZ; ++bz)
+    {
+        for (uint32_t by = 0; by < hdr.bricksY; ++by)
+        {
+            for (uint32_t bx = 0; bx < hdr.bricksX; ++bx, ++brick)
+            {
+                if (bricks[brick].offset == 0)
+                {
+                    continue;
+                }
+
+                glm::vec3 center = (glm::vec3(bx, by, bz) + glm::vec3(0.5f)) * static_cast<float>(BRICK_DIM);
+                center = glm::vec3(model * glm::vec4(center, 1.f));
+                if (!frustum.intersectsSphere(center, radius))
+                {
+                    continue;
+                }
+
+                if (brickSlots[brick] != NO_SLOT)
+                {
+                    slotFrames[brickSlots[brick]] = frame;
+                }
+                else
+                {
+                    missing.emplace_back(glm::distance(center, cameraPos), brick);
+                }
+            }
+        }
+    }
+
+    if (!batch && (!missing.empty() || !staleEntries.empty()))
+    {
+        begin(missing);
+    }
+}
+
+Image::Image& BrickedVolume::atlas()
+{
+    return atlasImage;
+}
+
+Image::Image& BrickedVolume::pageTable()
+{
+    return pageImage;
+}
+
+VolumeBricks::Header const& BrickedVolume::header() const
+{
+    return hdr;
+}
+
+size_t BrickedVolume::residentBricks() const
+{
+    return static_cast<size_t>(std::count(brickResident.begin(), brickResident.end(), true));
+}
+
+size_t BrickedVolume::emptyBricks() const
+{
+    return emptyCount;
+}
+
+uint32_t BrickedVolume::pageEntry(uint32_t brick) const
+{
+    if (bricks[brick].offset == 0)
+    {
+        return uint32_t(EMPTY) << 24;
+    }
+    if (!brickResident[brick])
+    {
+        return uint32_t(NOT_RESIDENT) << 24;
+    }
+
+    uint32_t slot = brickSlots[brick];
+    uint32_t x = slot % atlasBricks;
+    uint32_t y = slot / atlasBricks % atlasBricks;
+    uint32_t z = slot / (atlasBricks * atlasBricks);
+    return x | y << 8 | z << 16 | uint32_t(RESIDENT) << 24;
+}
+
+void BrickedVolume::begin(std::vector<std::pair<float, uint32_t>>& missing)
+{
+    // slots the view did not touch this frame, free ones first, then the least recently touched
+    std::vector<uint32_t> candidates;
+    for (uint32_t slot = 0; slot < slotBricks.size(); ++slot)
+    {
+        if (slotBricks[slot] == NO_SLOT || slotFrames[slot] < frame)
+        {
+            candidates.push_back(slot);
+        }
+    }
+
+    size_t count = std::min({ missing.size(), MAX_BATCH_BRICKS, candidates.size() });
+    if (count == 0 && staleEntries.empty())
+    {
+        return;
+    }
+    auto slotAge = [this](uint32_t slot)
+    {
+        return slotBricks[slot] == NO_SLOT ? 0 : slotFrames[slot] + 1;
+    };
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                      [&slotAge](uint32_t a, uint32_t b) { return slotAge(a) < slotAge(b); });
+    std::partial_sort(missing.begin(), missing.begin() + count, missing.end());
+
+    Batch next;
+    size_t staleCount = std::min(staleEntries.size(), MAX_BATCH_BRICKS);
+    next.entries.assign(staleEntries.end() - static_cast<ptrdiff_t>(staleCount), staleEntries.end());
+    staleEntries.resize(staleEntries.size() - staleCount);
+
+    std::vector<uint64_t> offsets;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t slot = candidates[i];
+        uint32_t brick = missing[i].second;
+        uint32_t evicted = slotBricks[slot];
+        if (evicted != NO_SLOT)
+        {
+            brickSlots[evicted] = NO_SLOT;
+            brickResident[evicted] = false;
+        }
+
+        slotBricks[slot] = brick;
+        slotFrames[slot] = frame;
+        brickSlots[brick] = slot;
+        next.bricks.push_back(brick);
+        next.slots.push_back(slot);
+        next.evicted.push_back(evicted);
+        offsets.push_back(bricks[brick].offset);
+    }
+
+    if (offsets.empty())
+    {
+        batch = std::move(next);
+        return;
+    }
+
+    AssetFile const* file = &volumeFile;
+    uint8_t* dst = staging.mapped();
+    uint64_t size = brickBytes;
+    uint64_t stride = (brickBytes + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+    next.read = ThreadPool::shared().submit([file, offsets, dst, size, stride]()
+    {
+        for (size_t i = 0; i < offsets.size(); ++i)
+        {
+            if (!file->read(offsets[i], size, dst + i * stride))
+            {
+                throw std::runtime_error("Cannot read volume bricks!");
+            }
+        }
+    });
+    batch = std::move(next);
+}
+
+bool BrickedVolume::advance()
+{
+    if (!batch->submitted)
+    {
+        // a batch of stale entries only has nothing to read
+        if (batch->read.valid())
+        {
+            if (batch->read.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                return false;
+            }
+            // rethrows a failed read
+            batch->read.get();
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = *cmdPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        CHECK_VK_SUCCESS(vkAllocateCommandBuffers(getLogicalDev(), &allocateInfo, &batch->cmdBuffer),
+                         ErrorMessages::FAILED_CANNOT_CREATE_CMD_BUFFER);
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        CHECK_VK_SUCCESS(vkBeginCommandBuffer(batch->cmdBuffer, &beginInfo),
+                         ErrorMessages::FAILED_CANNOT_BEGIN_CMD_BUFFER);
+
+        using VolumeBricks::STORED_DIM;
+        uint64_t stride = (brickBytes + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+        std::vector<VkBufferImageCopy> brickRegions;
+        std::vector<VkBufferImageCopy> entryRegions;
+        auto* entries = reinterpret_cast<uint32_t*>(staging.mapped() + MAX_BATCH_BRICKS * stride);
+        auto addEntry = [&](uint32_t brick)
+        {
+            VkBufferImageCopy region = {};
+            region.bufferOffset = MAX_BATCH_BRICKS * stride + entryRegions.size() * sizeof(uint32_t);
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = {
+                    static_cast<int32_t>(brick % hdr.bricksX),
+                    static_cast<int32_t>(brick / hdr.bricksX % hdr.bricksY),
+                    static_cast<int32_t>(brick / (hdr.bricksX * hdr.bricksY)) };
+            region.imageExtent = { 1, 1, 1 };
+            entries[entryRegions.size()] = pageEntry(brick);
+            entryRegions.push_back(region);
+        };
+
+        for (size_t i = 0; i < batch->bricks.size(); ++i)
+        {
+            uint32_t slot = batch->slots[i];
+            VkBufferImageCopy region = {};
+            region.bufferOffset = i * stride;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = {
+                    static_cast<int32_t>(slot % atlasBricks * STORED_DIM),
+                    static_cast<int32_t>(slot / atlasBricks % atlasBricks * STORED_DIM),
+                    static_cast<int32_t>(slot / (atlasBricks * atlasBricks) * STORED_DIM) };
+            region.imageExtent = { STORED_DIM, STORED_DIM, STORED_DIM };
+            brickRegions.push_back(region);
+
+            brickResident[batch->bricks[i]] = true;
+            addEntry(batch->bricks[i]);
+            if (batch->evicted[i] != NO_SLOT)
+            {
+                addEntry(batch->evicted[i]);
+            }
+        }
+        for (uint32_t brick : batch->entries)
+        {
+            addEntry(brick);
+        }
+
+        // frames submitted earlier may still sample both images
+        for (Image::Image* image : { &atlasImage, &pageImage })
+        {
+            image->cmdTransitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                       0, VK_ACCESS_TRANSFER_WRITE_BIT, batch->cmdBuffer);
+        }
+        atlasImage.cmdCopyRegionsFromBuffer(
+                staging, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, batch->cmdBuffer, brickRegions);
+        pageImage.cmdCopyRegionsFromBuffer(
+                staging, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, batch->cmdBuffer, entryRegions);
+        atlasImage.cmdTransitionEndCopy(batch->cmdBuffer);
+        pageImage.cmdTransitionEndCopy(batch->cmdBuffer);
+
+        CHECK_VK_SUCCESS(vkEndCommandBuffer(batch->cmdBuffer), ErrorMessages::FAILED_CANNOT_END_CMD_BUFFER);
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch->cmdBuffer;
+        CHECK_VK_SUCCESS(vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence),
+                         ErrorMessages::FAILED_CANNOT_SUBMIT_QUEUE);
+        batch->submitted = true;
+        return false;
+    }
+
+    if (vkGetFenceStatus(getLogicalDev(), fence) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    CHECK_VK_SUCCESS(vkResetFences(getLogicalDev(), 1, &fence), "Cannot reset Fence!");
+    vkFreeCommandBuffers(getLogicalDev(), *cmdPool, 1, &batch->cmdBuffer);
+    batch->cmdBuffer = VK_NULL_HANDLE;
+    return true;
+}
+
+void BrickedVolume::cancel()
+{
+    if (!batch)
+    {
+        return;
+    }
+
+    if (batch->read.valid())
+    {
+        batch->read.wait();
+    }
+    if (batch->submitted)
+    {
+        CHECK_VK_SUCCESS(vkWaitForFences(getLogicalDev(), 1, &fence, VK_TRUE, UINT64_MAX),
+                         ErrorMessages::FAILED_WAIT_IDLE);
+        CHECK_VK_SUCCESS(vkResetFences(getLogicalDev(), 1, &fence), "Cannot reset Fence!");
+        if (batch->cmdBuffer != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(getLogicalDev(), *cmdPool, 1, &batch->cmdBuffer);
+        }
+    }
+    else
+    {
+        // nothing reached the GPU: the slots still hold the evicted bricks
+        staleEntries.insert(staleEntries.end(), batch->entries.begin(), batch->entries.end());
+        for (size_t i = 0; i < batch->bricks.size(); ++i)
+        {
+            uint32_t slot = batch->slots[i];
+            uint32_t evicted = batch->evicted[i];
+            brickSlots[batch->bricks[i]] = NO_SLOT;
+            slotBricks[slot] = evicted;
+            if (evicted != NO_SLOT)
+            {
+                brickSlots[evicted] = slot;
+                brickResident[evicted] = true;
+            }
+        }
+    }
+    batch = nullopt;
+}
@@ -28,7 +28,7 @@ namespace Buffers
     }
 
     Buffer::Buffer(VkDevice* dev, VmaAllocator* allocator,
-                   VkPhysicalDevice const& physicalDev, size_t const& bufferSize,
+                   VkPhysicalDevice const& physicalDev, VkDeviceSize const& bufferSize,
                    VkBufferUsageFlags const& bufferUsageFlags,
                    VmaMemoryUsage const& memoryUsage,
                    VkMemoryPropertyFlags const& memoryFlags,
@@ -50,25 +50,39 @@ namespace Buffers
     }
 
     Buffer::Buffer(Buffer&& buf) noexcept:
-            AVkGraphicsBase(std::move(buf)), allocator(std::move(buf.allocator)),
-            size(std::move(buf.size)),
-            vertexBuffer(std::move(buf.vertexBuffer)), allocation(std::move(buf.allocation))
+            AVkGraphicsBase(std::move(buf)),
+            vertexBuffer(std::move(buf.vertexBuffer)), allocation(std::move(buf.allocation)),
+            allocator(std::move(buf.allocator)), size(std::move(buf.size)), mappedMemory(buf.mappedMemory)
     {
+        buf.mappedMemory = nullptr;
     }
 
     Buffer& Buffer::operator=(Buffer&& buf) noexcept
     {
+        if (this == &buf)
+        {
+            return *this;
+        }
+
+        release();
         AVkGraphicsBase::operator=(std::move(buf));
 
         allocator = std::move(buf.allocator);
         size = std::move(buf.size);
         vertexBuffer = std::move(buf.vertexBuffer);
         allocation = std::move(buf.allocation);
+        mappedMemory = buf.mappedMemory;
+        buf.mappedMemory = nullptr;
 
         return *this;
     }
 
     Buffer::~Buffer()
+    {
+        release();
+    }
+
+    void Buffer::release()
     {
         if (initialized())
         {
@@ -78,11 +92,14 @@ namespace Buffers
             }
             vmaDestroyBuffer(*allocator, vertexBuffer, allocation);
         }
+        vertexBuffer = VK_NULL_HANDLE;
+        allocation = VK_NULL_HANDLE;
+        mappedMemory = nullptr;
     }
 
-    uint32_t Buffer::getSize() const
+    VkDeviceSize Buffer::getSize() const
     {
-        return static_cast<uint32_t>(size);
+        return size;
     }
 
     VkResult Buffer::createVertexBuffer(
@@ -134,7 +151,7 @@ namespace Buffers
         return loadData(data, 0, size);
     }
 
-    VkResult Buffer::loadData(void const* data, uint32_t const& offset, uint32_t const& dataSize)
+    uint8_t* Buffer::mapped()
     {
         if (mappedMemory == nullptr)
         {
@@ -142,18 +159,30 @@ namespace Buffers
                     vmaMapMemory(*allocator, allocation, &mappedMemory),
                     "Cannot map buffer memory!");
         }
-        memcpy(reinterpret_cast<uint8_t*>(mappedMemory) + offset, data, dataSize);
+        return reinterpret_cast<uint8_t*>(mappedMemory);
+    }
+
+    VkResult Buffer::loadData(void const* data, VkDeviceSize const& offset, VkDeviceSize const& dataSize)
+    {
+        memcpy(mapped() + offset, data, static_cast<size_t>(dataSize));
 
         return VK_SUCCESS;
     }
 
     void Buffer::cmdCopyDataFrom(VkBuffer const& src,
                                  VkCommandBuffer& transferBuffer) const
+    {
+        cmdCopyDataFrom(src, 0, 0, size, transferBuffer);
+    }
+
+    void Buffer::cmdCopyDataFrom(
+            VkBuffer const& src, VkDeviceSize srcOffset, VkDeviceSize dstOffset, VkDeviceSize copySize,
+            VkCommandBuffer& transferBuffer) const
     {
         VkBufferCopy copyRegion = {};
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
-        copyRegion.size = size;
+        copyRegion.srcOffset = srcOffset;
+        copyRegion.dstOffset = dstOffset;
+        copyRegion.size = copySize;
         vkCmdCopyBuffer(transferBuffer, src, vertexBuffer, 1, &copyRegion);
     }
 
@@ -207,22 +236,17 @@ namespace Buffers
 
     VkResult Buffer::loadData(std::vector<std::tuple<void const*, size_t, size_t>> const& data)
     {
-        if (mappedMemory == nullptr)
-        {
-            CHECK_VK_SUCCESS(
-                    vmaMapMemory(*allocator, allocation, &mappedMemory),
-                    "Cannot map buffer memory!");
-        }
+        uint8_t* dst = mapped();
         for (auto const& [src, offset, sz] : data)
         {
-            memcpy(reinterpret_cast<uint8_t*>(mappedMemory) + offset, src, sz);
+            memcpy(dst + offset, src, sz);
         }
         return VK_SUCCESS;
 
     }
 
     StagingBuffer::StagingBuffer(VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
-                                 size_t const& bufferSize, VkMemoryPropertyFlags const& memoryFlags,
+                                 VkDeviceSize const& bufferSize, VkMemoryPropertyFlags const& memoryFlags,
                                  optUint32Set const& usedQueues) :
             Buffer(dev, allocator, physicalDev, bufferSize,
                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
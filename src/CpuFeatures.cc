@@ -0,0 +1,44 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "CpuFeatures.h"
+
+#if defined(CPU_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    CpuFeatures detect()
+    {
+        CpuFeatures features;
+#if defined(CPU_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        features.ssse3 = (info[2] & (1 << 9)) != 0;
+        features.sse41 = (info[2] & (1 << 19)) != 0;
+        // AVX state must also be enabled by the OS
+        bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+        if (maxLeaf >= 7 && osAvx)
+        {
+            __cpuidex(info, 7, 0);
+            features.avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#elif defined(CPU_X86)
+        __builtin_cpu_init();
+        features.ssse3 = __builtin_cpu_supports("ssse3");
+        features.sse41 = __builtin_cpu_supports("sse4.1");
+        features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+        return features;
+    }
+}
+
+CpuFeatures const& CpuFeatures::detected()
+{
+    static CpuFeatures const features = detect();
+    return features;
+}
@@ -0,0 +1,93 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "Culling.h"
+
+namespace Culling
+{
+    Frustum Frustum::fromMatrix(glm::mat4 const& viewProj)
+    {
+        glm::mat4 rows = glm::transpose(viewProj);
+
+        Frustum frustum = {};
+        frustum.planes[0] = rows[3] + rows[0];
+        frustum.planes[1] = rows[3] - rows[0];
+        frustum.planes[2] = rows[3] + rows[1];
+        frustum.planes[3] = rows[3] - rows[1];
+        frustum.planes[4] = rows[2];
+        frustum.planes[5] = rows[3] - rows[2];
+
+        for (auto& plane : frustum.planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersectsSphere(glm::vec3 const& center, float radius) const
+    {
+        for (auto const& plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    float maxScale(glm::mat4 const& model)
+    {
+        return std::max(glm::length(glm::vec3(model[0])),
+                        std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    }
+
+    void visibleRanges(
+            MeshOptimizer::Meshlet const* meshlets, size_t meshletCount,
+            glm::mat4 const& model, Frustum const& frustum, glm::vec3 const& eye,
+            std::vector<std::pair<uint32_t, uint32_t>>& ranges)
+    {
+        ranges.clear();
+
+        float scaleX = glm::length(glm::vec3(model[0]));
+        float scaleY = glm::length(glm::vec3(model[1]));
+        float scaleZ = glm::length(glm::vec3(model[2]));
+        float scale = maxScale(model);
+        float minScale = std::min(scaleX, std::min(scaleY, scaleZ));
+        // cone cutoffs are angles, which only survive similarity transforms
+        bool coneValid = scale - minScale <= 1e-3f * scale;
+        glm::mat3 rotation = glm::mat3(model) / scale;
+
+        for (size_t i = 0; i < meshletCount; ++i)
+        {
+            auto const& meshlet = meshlets[i];
+            glm::vec3 center = glm::vec3(model * glm::vec4(meshlet.center, 1.f));
+            float radius = meshlet.radius * scale;
+
+            if (!frustum.intersectsSphere(center, radius))
+            {
+                continue;
+            }
+
+            if (coneValid && meshlet.coneCutoff < 1.f)
+            {
+                glm::vec3 toCenter = center - eye;
+                if (glm::dot(toCenter, rotation * meshlet.coneAxis) >
+                    meshlet.coneCutoff * glm::length(toCenter) + radius)
+                {
+                    continue;
+                }
+            }
+
+            if (!ranges.empty() && ranges.back().first + ranges.back().second == meshlet.firstIndex)
+            {
+                ranges.back().second += meshlet.indexCount;
+            }
+            else
+            {
+                ranges.emplace_back(meshlet.firstIndex, meshlet.indexCount);
+            }
+        }
+    }
+}
@@ -41,14 +41,14 @@ DisposableCmdBuffer& DisposableCmdBuffer::operator=(DisposableCmdBuffer&& dcb) n
     return *this;
 }
 
-VkResult DisposableCmdBuffer::submit(VkQueue& queue)
+VkResult DisposableCmdBuffer::submit(VkQueue& queue, VkFence fence)
 {
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &cmdBuffer;
 
-    return vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+    return vkQueueSubmit(queue, 1, &submitInfo, fence);
 }
 
 void DisposableCmdBuffer::finish()
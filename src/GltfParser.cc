@@ -0,0 +1,631 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "GltfParser.h"
+
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+namespace GltfParser
+{
+    namespace
+    {
+        // nesting limit for the JSON chunk and the node hierarchy
+        constexpr uint32_t MAX_DEPTH = 64;
+
+        /*
+         * Just enough JSON for the glTF document: strings are kept as raw views into the
+         * chunk with escapes undecoded, which is fine for the keys and enums looked up here.
+         */
+        struct JsonValue
+        {
+            enum Type
+            {
+                JSON_NULL,
+                JSON_BOOL,
+                JSON_NUMBER,
+                JSON_STRING,
+                JSON_ARRAY,
+                JSON_OBJECT,
+            };
+
+            Type type = JSON_NULL;
+            bool boolean = false;
+            double number = 0.0;
+            std::string_view string;
+            // array elements, or object values in the order of keys
+            std::vector<JsonValue> items;
+            std::vector<std::string_view> keys;
+
+            [[nodiscard]]
+            JsonValue const* find(std::string_view key) const
+            {
+                if (type != JSON_OBJECT)
+                {
+                    return nullptr;
+                }
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    if (keys[i] == key)
+                    {
+                        return &items[i];
+                    }
+                }
+                return nullptr;
+            }
+
+            [[nodiscard]]
+            double numberOr(std::string_view key, double fallback) const
+            {
+                auto const* value = find(key);
+                return value && value->type == JSON_NUMBER ? value->number : fallback;
+            }
+
+            [[nodiscard]]
+            uint32_t indexOr(std::string_view key, uint32_t fallback = NO_INDEX) const
+            {
+                auto const* value = find(key);
+                if (!value || value->type != JSON_NUMBER)
+                {
+                    return fallback;
+                }
+                if (value->number < 0.0 || value->number >= static_cast<double>(NO_INDEX))
+                {
+                    throw std::runtime_error("glTF index out of range!");
+                }
+                return static_cast<uint32_t>(value->number);
+            }
+
+            // items of an array member; empty if it is missing
+            [[nodiscard]]
+            std::vector<JsonValue> const& array(std::string_view key) const
+            {
+                static std::vector<JsonValue> const empty;
+                auto const* value = find(key);
+                return value && value->type == JSON_ARRAY ? value->items : empty;
+            }
+        };
+
+        class JsonReader
+        {
+        public:
+            JsonReader(char const* begin, char const* end) : p(begin), end(end)
+            {
+            }
+
+            JsonValue parseDocument()
+            {
+                JsonValue root = parseValue(0);
+                skipSpace();
+                if (p != end)
+                {
+                    fail();
+                }
+                return root;
+            }
+
+        private:
+            [[noreturn]]
+            static void fail()
+            {
+                throw std::runtime_error("Malformed glTF JSON chunk!");
+            }
+
+            void skipSpace()
+            {
+                // the JSON chunk is padded with spaces, so trailing padding is skipped here too
+                while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == '\0'))
+                {
+                    ++p;
+                }
+            }
+
+            void expect(char c)
+            {
+                skipSpace();
+                if (p >= end || *p != c)
+                {
+                    fail();
+                }
+                ++p;
+            }
+
+            bool consume(char c)
+            {
+                skipSpace();
+                if (p < end && *p == c)
+                {
+                    ++p;
+                    return true;
+                }
+                return false;
+            }
+
+            void expectWord(std::string_view word)
+            {
+                if (static_cast<size_t>(end - p) < word.size() || std::string_view(p, word.size()) != word)
+                {
+                    fail();
+                }
+                p += word.size();
+            }
+
+            std::string_view parseString()
+            {
+                expect('"');
+                char const* start = p;
+                while (p < end && *p != '"')
+                {
+                    p += *p == '\\' ? 2 : 1;
+                }
+                if (p >= end)
+                {
+                    fail();
+                }
+                return {start, static_cast<size_t>(p++ - start)};
+            }
+
+            JsonValue parseValue(uint32_t depth)
+            {
+                if (depth > MAX_DEPTH)
+                {
+                    fail();
+                }
+
+                JsonValue value;
+                skipSpace();
+                if (p >= end)
+                {
+                    fail();
+                }
+
+                switch (*p)
+                {
+                    case '{':
+                        ++p;
+                        value.type = JsonValue::JSON_OBJECT;
+                        if (consume('}'))
+                        {
+                            break;
+                        }
+                        do
+                        {
+                            value.keys.push_back(parseString());
+                            expect(':');
+                            value.items.push_back(parseValue(depth + 1));
+                        } while (consume(','));
+                        expect('}');
+                        break;
+
+                    case '[':
+                        ++p;
+                        value.type = JsonValue::JSON_ARRAY;
+                        if (consume(']'))
+                        {
+                            break;
+                        }
+                        do
+                        {
+                            value.items.push_back(parseValue(depth + 1));
+                        } while (consume(','));
+                        expect(']');
+                        break;
+
+                    case '"':
+                        value.type = JsonValue::JSON_STRING;
+                        value.string = parseString();
+                        break;
+
+                    case 't':
+                        expectWord("true");
+                        value.type = JsonValue::JSON_BOOL;
+                        value.boolean = true;
+                        break;
+
+                    case 'f':
+                        expectWord("false");
+                        value.type = JsonValue::JSON_BOOL;
+                        break;
+
+                    case 'n':
+                        expectWord("null");
+                        break;
+
+                    default:
+                    {
+                        value.type = JsonValue::JSON_NUMBER;
+                        auto [ptr, err] = std::from_chars(p, end, value.number);
+                        if (err != std::errc())
+                        {
+                            fail();
+                        }
+                        p = ptr;
+                        break;
+                    }
+                }
+                return value;
+            }
+
+            char const* p;
+            char const* end;
+        };
+
+        uint32_t readU32(uint8_t const* p)
+        {
+            uint32_t value;
+            memcpy(&value, p, sizeof(uint32_t));
+            return value;
+        }
+
+        uint32_t componentCount(std::string_view type)
+        {
+            if (type == "SCALAR")
+            {
+                return 1;
+            }
+            if (type == "VEC2")
+            {
+                return 2;
+            }
+            if (type == "VEC3")
+            {
+                return 3;
+            }
+            if (type == "VEC4" || type == "MAT2")
+            {
+                return 4;
+            }
+            if (type == "MAT3")
+            {
+                return 9;
+            }
+            if (type == "MAT4")
+            {
+                return 16;
+            }
+            throw std::runtime_error("Unknown glTF accessor type!");
+        }
+
+        glm::vec3 readVec3(JsonValue const& node, std::string_view key, glm::vec3 fallback)
+        {
+            auto const& items = node.array(key);
+            if (items.size() != 3)
+            {
+                return fallback;
+            }
+            return {static_cast<float>(items[0].number), static_cast<float>(items[1].number),
+                    static_cast<float>(items[2].number)};
+        }
+
+        // local transform of a node; false if it has none
+        bool nodeTransform(JsonValue const& node, glm::mat4& out)
+        {
+            auto const& matrix = node.array("matrix");
+            if (matrix.size() == 16)
+            {
+                // column major, like glm
+                for (size_t i = 0; i < 16; ++i)
+                {
+                    out[i / 4][i % 4] = static_cast<float>(matrix[i].number);
+                }
+                return true;
+            }
+
+            auto const& rotation = node.array("rotation");
+            if (!node.find("translation") && !node.find("scale") && rotation.size() != 4)
+            {
+                return false;
+            }
+
+            glm::vec3 t = readVec3(node, "translation", glm::vec3(0.f));
+            glm::vec3 s = readVec3(node, "scale", glm::vec3(1.f));
+            float x = 0.f, y = 0.f, z = 0.f, w = 1.f;
+            if (rotation.size() == 4)
+            {
+                x = static_cast<float>(rotation[0].number);
+                y = static_cast<float>(rotation[1].number);
+                z = static_cast<float>(rotation[2].number);
+                w = static_cast<float>(rotation[3].number);
+            }
+
+            // T * R * S
+            out = glm::mat4(1.f);
+            out[0][0] = (1.f - 2.f * (y * y + z * z)) * s.x;
+            out[0][1] = 2.f * (x * y + w * z) * s.x;
+            out[0][2] = 2.f * (x * z - w * y) * s.x;
+            out[1][0] = 2.f * (x * y - w * z) * s.y;
+            out[1][1] = (1.f - 2.f * (x * x + z * z)) * s.y;
+            out[1][2] = 2.f * (y * z + w * x) * s.y;
+            out[2][0] = 2.f * (x * z + w * y) * s.z;
+            out[2][1] = 2.f * (y * z - w * x) * s.z;
+            out[2][2] = (1.f - 2.f * (x * x + y * y)) * s.z;
+            out[3] = glm::vec4(t, 1.f);
+            return true;
+        }
+
+        class SceneWalker
+        {
+        public:
+            SceneWalker(JsonValue const& root, GlbData& glb) :
+                    meshes(root.array("meshes")), nodes(root.array("nodes")), glb(glb)
+            {
+            }
+
+            void addMesh(uint32_t meshIdx, glm::mat4 const& transform, bool identity)
+            {
+                if (meshIdx >= meshes.size())
+                {
+                    throw std::runtime_error("glTF node references a missing mesh!");
+                }
+
+                for (auto const& prim : meshes[meshIdx].array("primitives"))
+                {
+                    // 4 = TRIANGLES; points, lines, strips and fans are not drawable by Mesh
+                    if (prim.indexOr("mode", 4) != 4)
+                    {
+                        continue;
+                    }
+
+                    auto const* attributes = prim.find("attributes");
+                    if (!attributes)
+                    {
+                        throw std::runtime_error("glTF primitive without attributes!");
+                    }
+
+                    Primitive out;
+                    out.position = attributes->indexOr("POSITION");
+                    out.normal = attributes->indexOr("NORMAL");
+                    out.texCoord = attributes->indexOr("TEXCOORD_0");
+                    out.indices = prim.indexOr("indices");
+                    out.transform = transform;
+                    out.identityTransform = identity;
+                    glb.primitives.push_back(out);
+                }
+            }
+
+            void addNode(uint32_t nodeIdx, glm::mat4 const& parent, bool parentIdentity, uint32_t depth)
+            {
+                if (nodeIdx >= nodes.size() || depth > MAX_DEPTH)
+                {
+                    throw std::runtime_error("Invalid glTF node hierarchy!");
+                }
+
+                auto const& node = nodes[nodeIdx];
+                glm::mat4 local(1.f);
+                bool identity = parentIdentity;
+                glm::mat4 transform = parent;
+                if (nodeTransform(node, local))
+                {
+                    transform = parent * local;
+                    identity = false;
+                }
+
+                uint32_t meshIdx = node.indexOr("mesh");
+                if (meshIdx != NO_INDEX)
+                {
+                    addMesh(meshIdx, transform, identity);
+                }
+
+                for (auto const& child : node.array("children"))
+                {
+                    addNode(nodeIndex(child), transform, identity, depth + 1);
+                }
+            }
+
+            void walk(JsonValue const& root)
+            {
+                auto const& scenes = root.array("scenes");
+                if (!scenes.empty())
+                {
+                    uint32_t sceneIdx = root.indexOr("scene", 0);
+                    if (sceneIdx >= scenes.size())
+                    {
+                        throw std::runtime_error("glTF default scene is missing!");
+                    }
+                    for (auto const& nodeIdx : scenes[sceneIdx].array("nodes"))
+                    {
+                        addNode(nodeIndex(nodeIdx), glm::mat4(1.f), true, 0);
+                    }
+                    return;
+                }
+
+                // no scene: every mesh once, untransformed
+                for (uint32_t i = 0; i < meshes.size(); ++i)
+                {
+                    addMesh(i, glm::mat4(1.f), true);
+                }
+            }
+
+        private:
+            // an item of a node list, checked before the cast as non-integer or negative values would be UB
+            uint32_t nodeIndex(JsonValue const& value) const
+            {
+                if (value.type != JsonValue::JSON_NUMBER || !(value.number >= 0.0) ||
+                    value.number >= static_cast<double>(nodes.size()) || std::floor(value.number) != value.number)
+                {
+                    throw std::runtime_error("Invalid glTF node hierarchy!");
+                }
+                return static_cast<uint32_t>(value.number);
+            }
+
+            std::vector<JsonValue> const& meshes;
+            std::vector<JsonValue> const& nodes;
+            GlbData& glb;
+        };
+
+        void checkAttribute(
+                GlbData const& glb, uint32_t accessorIdx, uint64_t count, uint32_t components, char const* name)
+        {
+            if (accessorIdx == NO_INDEX)
+            {
+                return;
+            }
+            if (accessorIdx >= glb.accessors.size() || glb.accessors[accessorIdx].count != count ||
+                glb.accessors[accessorIdx].components != components)
+            {
+                throw std::runtime_error(std::string("Invalid glTF ") + name + " accessor!");
+            }
+        }
+    }
+
+    size_t componentSize(uint32_t componentType)
+    {
+        switch (componentType)
+        {
+            case BYTE:
+            case UNSIGNED_BYTE:
+                return 1;
+            case SHORT:
+            case UNSIGNED_SHORT:
+                return 2;
+            case UNSIGNED_INT:
+            case FLOAT:
+                return 4;
+            default:
+                throw std::runtime_error("Unknown glTF component type!");
+        }
+    }
+
+    uint8_t const* GlbData::elementData(Accessor const& accessor) const
+    {
+        if (accessor.bufferView == NO_INDEX)
+        {
+            return nullptr;
+        }
+        return bin + views[accessor.bufferView].byteOffset + accessor.byteOffset;
+    }
+
+    size_t GlbData::elementStride(Accessor const& accessor) const
+    {
+        size_t packed = componentSize(accessor.componentType) * accessor.components;
+        if (accessor.bufferView == NO_INDEX || views[accessor.bufferView].byteStride == 0)
+        {
+            return packed;
+        }
+        return views[accessor.bufferView].byteStride;
+    }
+
+    GlbData parse(uint8_t const* data, size_t size)
+    {
+        // 12 byte header, then chunks of (length, type, payload)
+        if (size < 20 || readU32(data) != GLB_MAGIC || readU32(data + 4) != 2 || readU32(data + 8) > size)
+        {
+            throw std::runtime_error("Not a glTF 2.0 binary file!");
+        }
+        size = readU32(data + 8);
+
+        uint32_t jsonLength = readU32(data + 12);
+        if (readU32(data + 16) != GLB_CHUNK_JSON || jsonLength > size - 20)
+        {
+            throw std::runtime_error("glTF binary file without a JSON chunk!");
+        }
+        auto const* json = reinterpret_cast<char const*>(data + 20);
+        JsonValue root = JsonReader(json, json + jsonLength).parseDocument();
+        if (root.type != JsonValue::JSON_OBJECT)
+        {
+            throw std::runtime_error("Malformed glTF JSON chunk!");
+        }
+
+        GlbData glb;
+        size_t binChunk = 20 + ((jsonLength + 3) & ~3u);
+        if (binChunk + 8 <= size && readU32(data + binChunk + 4) == GLB_CHUNK_BIN)
+        {
+            glb.bin = data + binChunk + 8;
+            glb.binSize = std::min<size_t>(readU32(data + binChunk), size - binChunk - 8);
+        }
+
+        auto const& buffers = root.array("buffers");
+        if (buffers.size() > 1 || (buffers.size() == 1 && buffers[0].find("uri")))
+        {
+            throw std::runtime_error("Only glTF files with a single embedded buffer are supported!");
+        }
+
+        for (auto const& view : root.array("bufferViews"))
+        {
+            BufferView out;
+            out.byteOffset = static_cast<uint64_t>(view.numberOr("byteOffset", 0.0));
+            out.byteLength = static_cast<uint64_t>(view.numberOr("byteLength", 0.0));
+            out.byteStride = static_cast<uint32_t>(view.numberOr("byteStride", 0.0));
+            if (view.indexOr("buffer", 0) != 0 || out.byteOffset > glb.binSize ||
+                out.byteLength > glb.binSize - out.byteOffset)
+            {
+                throw std::runtime_error("glTF buffer view out of range!");
+            }
+            glb.views.push_back(out);
+        }
+
+        for (auto const& accessor : root.array("accessors"))
+        {
+            if (accessor.find("sparse"))
+            {
+                throw std::runtime_error("Sparse glTF accessors are not supported!");
+            }
+
+            Accessor out;
+            out.bufferView = accessor.indexOr("bufferView");
+            out.byteOffset = static_cast<uint64_t>(accessor.numberOr("byteOffset", 0.0));
+            out.componentType = static_cast<uint32_t>(accessor.numberOr("componentType", 0.0));
+            out.count = static_cast<uint64_t>(accessor.numberOr("count", 0.0));
+            auto const* normalized = accessor.find("normalized");
+            out.normalized = normalized && normalized->boolean;
+            auto const* type = accessor.find("type");
+            out.components = componentCount(type ? type->string : std::string_view());
+
+            auto const& min = accessor.array("min");
+            auto const& max = accessor.array("max");
+            if (out.components == 3 && min.size() == 3 && max.size() == 3)
+            {
+                out.hasBounds = true;
+                out.min = readVec3(accessor, "min", glm::vec3(0.f));
+                out.max = readVec3(accessor, "max", glm::vec3(0.f));
+            }
+
+            // checked even without elements, as GlbData::elementData reads the view of any accessor
+            if (out.bufferView != NO_INDEX && out.bufferView >= glb.views.size())
+            {
+                throw std::runtime_error("glTF accessor references a missing buffer view!");
+            }
+            if (out.bufferView != NO_INDEX && out.count > 0)
+            {
+
+                size_t elementSize = componentSize(out.componentType) * out.components;
+                size_t stride = glb.views[out.bufferView].byteStride;
+                stride = stride ? stride : elementSize;
+                uint64_t viewLength = glb.views[out.bufferView].byteLength;
+                if (out.byteOffset > viewLength ||
+                    (out.count - 1) > (viewLength - out.byteOffset) / stride ||
+                    out.byteOffset + (out.count - 1) * stride + elementSize > viewLength)
+                {
+                    throw std::runtime_error("glTF accessor out of range!");
+                }
+            }
+            glb.accessors.push_back(out);
+        }
+
+        SceneWalker(root, glb).walk(root);
+
+        for (auto const& prim : glb.primitives)
+        {
+            if (prim.position >= glb.accessors.size() || glb.accessors[prim.position].components != 3)
+            {
+                throw std::runtime_error("glTF primitive without a valid POSITION accessor!");
+            }
+
+            uint64_t count = glb.accessors[prim.position].count;
+            checkAttribute(glb, prim.normal, count, 3, "NORMAL");
+            checkAttribute(glb, prim.texCoord, count, 2, "TEXCOORD_0");
+            if (prim.indices != NO_INDEX)
+            {
+                auto const* indices = prim.indices < glb.accessors.size() ? &glb.accessors[prim.indices] : nullptr;
+                if (!indices || indices->components != 1 || (indices->componentType != UNSIGNED_BYTE &&
+                    indices->componentType != UNSIGNED_SHORT && indices->componentType != UNSIGNED_INT))
+                {
+                    throw std::runtime_error("Invalid glTF index accessor!");
+                }
+            }
+        }
+        return glb;
+    }
+}
@@ -10,7 +10,8 @@ VkResult GraphicsPipeline::createGraphicsPipeline(
         VkExtent2D const& extent,
         VkRenderPass const& renderPass,
         std::vector<VkDescriptorSetLayout> const& descriptorSetLayout,
-        bool enableDepthTest)
+        bool enableDepthTest,
+        VertexFormat vertexFormat)
 {
     auto [vertShader, ret] = Shaders::createShaderModule(getLogicalDev(), vertShaderName);
     auto [fragShader, ret2] = Shaders::createShaderModule(getLogicalDev(), fragShaderName);
@@ -25,6 +26,20 @@ VkResult GraphicsPipeline::createGraphicsPipeline(
     vertShaderInfo.module = vertShader;
     vertShaderInfo.pName = "main";
 
+    // constant_id 0 in main.vert.hlsl: whether positions and normals need dequantization
+    VkBool32 quantizedVertices = vertexFormat == QUANTIZED_VERTEX ? VK_TRUE : VK_FALSE;
+    VkSpecializationMapEntry specEntry = {};
+    specEntry.constantID = 0;
+    specEntry.offset = 0;
+    specEntry.size = sizeof(VkBool32);
+
+    VkSpecializationInfo specInfo = {};
+    specInfo.mapEntryCount = 1;
+    specInfo.pMapEntries = &specEntry;
+    specInfo.dataSize = sizeof(VkBool32);
+    specInfo.pData = &quantizedVertices;
+    vertShaderInfo.pSpecializationInfo = &specInfo;
+
     VkPipelineShaderStageCreateInfo fragShaderInfo = {};
     fragShaderInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     fragShaderInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -33,8 +48,10 @@ VkResult GraphicsPipeline::createGraphicsPipeline(
 
     VkPipelineShaderStageCreateInfo stages[] = {vertShaderInfo, fragShaderInfo};
 
-    auto bindingDesc = Vertex::bindingDescription();
-    auto attribDesc = Vertex::attributeDescription();
+    auto bindingDesc = vertexFormat == QUANTIZED_VERTEX ?
+            QVertex::bindingDescription() : NVertex::bindingDescription();
+    auto attribDesc = vertexFormat == QUANTIZED_VERTEX ?
+            QVertex::attributeDescription() : NVertex::attributeDescription();
 
     VkPipelineVertexInputStateCreateInfo vertInputInfo = {};
     vertInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -183,13 +200,14 @@ GraphicsPipeline::GraphicsPipeline(
         size_t const& swpchainImgCount,
         VkRenderPass const& renderPass,
         std::vector<VkDescriptorSetLayout> const& descriptorSetLayout,
-        bool enableDepthTest) :
+        bool enableDepthTest,
+        VertexFormat vertexFormat) :
         AVkGraphicsBase(device), cmdPool(cmdPool)
 {
     CHECK_VK_SUCCESS(
             createGraphicsPipeline(
                     vertShader, fragShader, extent, renderPass, descriptorSetLayout,
-                    enableDepthTest),
+                    enableDepthTest, vertexFormat),
             ErrorMessages::CREATE_GRAPHICS_PIPELINE_FAILED);
 
     CHECK_VK_SUCCESS(
@@ -46,6 +46,25 @@ namespace Image
         return fmt == VK_FORMAT_D32_SFLOAT_S8_UINT || fmt == VK_FORMAT_D24_UNORM_S8_UINT;
     }
 
+    bool canSample(VkPhysicalDevice const& dev, VkFormat const& fmt)
+    {
+        VkFormatProperties prop;
+        vkGetPhysicalDeviceFormatProperties(dev, fmt, &prop);
+        VkFormatFeatureFlags required =
+                VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return (prop.optimalTilingFeatures & required) == required;
+    }
+
+    bool canBlitMips(VkPhysicalDevice const& dev, VkFormat const& fmt)
+    {
+        VkFormatProperties prop;
+        vkGetPhysicalDeviceFormatProperties(dev, fmt, &prop);
+        VkFormatFeatureFlags required =
+                VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return (prop.optimalTilingFeatures & required) == required;
+    }
+
     Image::Image(VkDevice* logicalDev, VmaAllocator* allocator, std::pair<uint32_t, uint32_t> const& size,
                         VkFormat const& imgFormat, VkImageUsageFlags const& usage,
                         VkMemoryPropertyFlags const& memoryFlags,
@@ -117,6 +136,7 @@ namespace Image
                                        VkImageLayout const& initialLayout, VmaMemoryUsage const& memoryUsage)
     {
         auto const&[width, height, depth] = size;
+        this->mipLevels = mipLevels;
         VkImageCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         createInfo.imageType = imgType;
@@ -164,7 +184,8 @@ namespace Image
             baseSampler(std::move(im.baseSampler)),
             allocation(std::move(im.allocation)),
             allocator(std::move(im.allocator)),
-            size(std::move(im.size))
+            size(std::move(im.size)),
+            mipLevels(im.mipLevels)
     {
 
     }
@@ -180,6 +201,7 @@ namespace Image
         allocation = std::move(im.allocation);
         allocator = std::move(im.allocator);
         size = std::move(im.size);
+        mipLevels = im.mipLevels;
 
         AVkGraphicsBase::operator=(std::move(im));
         return *this;
@@ -195,8 +217,8 @@ namespace Image
     void Image::cmdTransitionEndCopy(VkCommandBuffer& cmdBuffer) const
     {
         cmdTransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                            VK_ACCESS_TRANSFER_WRITE_BIT, 0, cmdBuffer);
+                            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                            VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, cmdBuffer);
     }
 
     VkResult Image::createBaseImageView(VkFormat const& format, VkImageViewType const& viewType, VkImageAspectFlags const& aspectFlags)
@@ -209,7 +231,7 @@ namespace Image
         createInfo.format = format;
         createInfo.subresourceRange.aspectMask = aspectFlags;
         createInfo.subresourceRange.baseMipLevel = 0;
-        createInfo.subresourceRange.levelCount = 1;
+        createInfo.subresourceRange.levelCount = mipLevels;
         createInfo.subresourceRange.baseArrayLayer = 0;
         createInfo.subresourceRange.layerCount = 1;
 
@@ -221,7 +243,8 @@ namespace Image
                                            VkPipelineStageFlags const& srcStage, VkPipelineStageFlags const& dstStage,
                                            VkAccessFlags const& srcAccessMask, VkAccessFlags const& dstAccessMask,
                                            VkCommandBuffer& cmdBuffer,
-                                           VkImageAspectFlags const& aspectFlags) const
+                                           VkImageAspectFlags const& aspectFlags,
+                                           uint32_t baseMipLevel, uint32_t levelCount) const
     {
         VkImageMemoryBarrier barrier = {};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -233,8 +256,8 @@ namespace Image
 
         barrier.image = img;
         barrier.subresourceRange.aspectMask = aspectFlags;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseMipLevel = baseMipLevel;
+        barrier.subresourceRange.levelCount = levelCount;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
 
@@ -250,29 +273,144 @@ namespace Image
     }
 
     void Image::cmdCopyFromBuffer(Buffers::Buffer const& srcBuffer, VkImageLayout const& layout,
-                                         VkCommandBuffer& cmdBuffer)
+                                         VkCommandBuffer& cmdBuffer, std::vector<VkDeviceSize> const& levelOffsets,
+                                         uint32_t baseMipLevel)
     {
-        VkBufferImageCopy copyRegion = {};
-        copyRegion.bufferOffset = 0;
-        copyRegion.bufferRowLength = 0;
-        copyRegion.bufferImageHeight = 0;
+        std::vector<VkBufferImageCopy> copyRegions(levelOffsets.size());
+        for (uint32_t i = 0; i < copyRegions.size(); ++i)
+        {
+            VkBufferImageCopy& copyRegion = copyRegions[i];
+            copyRegion.bufferOffset = levelOffsets[i];
+            copyRegion.bufferRowLength = 0;
+            copyRegion.bufferImageHeight = 0;
 
-        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.imageSubresource.mipLevel = 0;
-        copyRegion.imageSubresource.baseArrayLayer = 0;
-        copyRegion.imageSubresource.layerCount = 1;
+            copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.imageSubresource.mipLevel = baseMipLevel + i;
+            copyRegion.imageSubresource.baseArrayLayer = 0;
+            copyRegion.imageSubresource.layerCount = 1;
 
-        copyRegion.imageOffset = {0, 0, 0};
+            copyRegion.imageOffset = {0, 0, 0};
 
-        auto const&[width, height, depth] = size;
-        copyRegion.imageExtent = {width, height, depth};
+            auto const&[width, height, depth] = mipExtent(baseMipLevel + i);
+            copyRegion.imageExtent = {width, height, depth};
+        }
 
         vkCmdCopyBufferToImage(
                 cmdBuffer,
                 srcBuffer.vertexBuffer,
                 img,
                 layout,
-                1, &copyRegion);
+                static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+    }
+
+    void Image::cmdCopyRegionsFromBuffer(Buffers::Buffer const& srcBuffer, VkImageLayout const& layout,
+                                         VkCommandBuffer& cmdBuffer,
+                                         std::vector<VkBufferImageCopy> const& regions) const
+    {
+        if (regions.empty())
+        {
+            return;
+        }
+
+        vkCmdCopyBufferToImage(
+                cmdBuffer,
+                srcBuffer.vertexBuffer,
+                img,
+                layout,
+                static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    void Image::cmdCopyLevelsFrom(Image const& src, uint32_t srcBaseLevel, uint32_t dstBaseLevel, uint32_t levelCount,
+                                  VkCommandBuffer& cmdBuffer) const
+    {
+        src.cmdTransitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                0, VK_ACCESS_TRANSFER_READ_BIT, cmdBuffer,
+                                VK_IMAGE_ASPECT_COLOR_BIT, srcBaseLevel, levelCount);
+
+        std::vector<VkImageCopy> copyRegions(levelCount);
+        for (uint32_t i = 0; i < levelCount; ++i)
+        {
+            VkImageCopy& copyRegion = copyRegions[i];
+            copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.srcSubresource.mipLevel = srcBaseLevel + i;
+            copyRegion.srcSubresource.baseArrayLayer = 0;
+            copyRegion.srcSubresource.layerCount = 1;
+            copyRegion.srcOffset = {0, 0, 0};
+            copyRegion.dstSubresource = copyRegion.srcSubresource;
+            copyRegion.dstSubresource.mipLevel = dstBaseLevel + i;
+            copyRegion.dstOffset = {0, 0, 0};
+
+            auto const&[width, height, depth] = mipExtent(dstBaseLevel + i);
+            copyRegion.extent = {width, height, depth};
+        }
+
+        vkCmdCopyImage(
+                cmdBuffer,
+                src.img, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                img, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+
+        src.cmdTransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                0, 0, cmdBuffer,
+                                VK_IMAGE_ASPECT_COLOR_BIT, srcBaseLevel, levelCount);
+    }
+
+    void Image::cmdGenerateMips(VkCommandBuffer& cmdBuffer) const
+    {
+        for (uint32_t level = 1; level < mipLevels; ++level)
+        {
+            // the level above is complete: read it, then hand it to the shaders
+            cmdTransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, cmdBuffer,
+                                VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 1);
+
+            auto const&[srcWidth, srcHeight, srcDepth] = mipExtent(level - 1);
+            auto const&[dstWidth, dstHeight, dstDepth] = mipExtent(level);
+            VkImageBlit blit = {};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = level - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = 1;
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {
+                    static_cast<int32_t>(srcWidth), static_cast<int32_t>(srcHeight), static_cast<int32_t>(srcDepth)};
+            blit.dstSubresource = blit.srcSubresource;
+            blit.dstSubresource.mipLevel = level;
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {
+                    static_cast<int32_t>(dstWidth), static_cast<int32_t>(dstHeight), static_cast<int32_t>(dstDepth)};
+
+            vkCmdBlitImage(
+                    cmdBuffer,
+                    img, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    img, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    1, &blit, VK_FILTER_LINEAR);
+
+            cmdTransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT, cmdBuffer,
+                                VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 1);
+        }
+
+        // the last level was only written
+        cmdTransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                            VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, cmdBuffer,
+                            VK_IMAGE_ASPECT_COLOR_BIT, mipLevels - 1, 1);
+    }
+
+    uint32_t Image::mipLevelCount() const
+    {
+        return mipLevels;
+    }
+
+    std::tuple<uint32_t, uint32_t, uint32_t> Image::mipExtent(uint32_t mipLevel) const
+    {
+        auto const&[width, height, depth] = size;
+        return { std::max(width >> mipLevel, 1u), std::max(height >> mipLevel, 1u), std::max(depth >> mipLevel, 1u) };
     }
 
     Image::~Image()
@@ -0,0 +1,245 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "Lz4.h"
+
+namespace Lz4
+{
+    namespace
+    {
+        constexpr size_t MIN_MATCH = 4;
+        // the format requires the last 5 bytes to be literals and the last match to start
+        // at least 12 bytes before the end
+        constexpr size_t LAST_LITERALS = 5;
+        constexpr size_t MATCH_FIND_LIMIT = 12;
+        constexpr size_t MAX_OFFSET = 65535;
+        constexpr uint32_t HASH_BITS = 12;
+
+        uint32_t read32(uint8_t const* p)
+        {
+            uint32_t value;
+            memcpy(&value, p, sizeof(uint32_t));
+            return value;
+        }
+
+        uint32_t hash4(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        class Writer
+        {
+        public:
+            Writer(uint8_t* dst, size_t capacity) : p(dst), end(dst + capacity)
+            {
+            }
+
+            // writes the 255-run extension of a length whose first 4 bits went into the token
+            bool writeLength(size_t length)
+            {
+                for (; length >= 255; length -= 255)
+                {
+                    if (!put(255))
+                    {
+                        return false;
+                    }
+                }
+                return put(static_cast<uint8_t>(length));
+            }
+
+            bool put(uint8_t byte)
+            {
+                if (p >= end)
+                {
+                    return false;
+                }
+                *p++ = byte;
+                return true;
+            }
+
+            bool put(uint8_t const* src, size_t size)
+            {
+                if (static_cast<size_t>(end - p) < size)
+                {
+                    return false;
+                }
+                memcpy(p, src, size);
+                p += size;
+                return true;
+            }
+
+            // literals followed by a match; matchLength 0 ends the block
+            bool sequence(uint8_t const* literals, size_t literalLength, size_t offset, size_t matchLength)
+            {
+                size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+                auto token = static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) |
+                                                  std::min<size_t>(matchCode, 15));
+                if (!put(token))
+                {
+                    return false;
+                }
+                if (literalLength >= 15 && !writeLength(literalLength - 15))
+                {
+                    return false;
+                }
+                if (!put(literals, literalLength))
+                {
+                    return false;
+                }
+                if (matchLength == 0)
+                {
+                    return true;
+                }
+
+                if (!put(static_cast<uint8_t>(offset & 0xff)) || !put(static_cast<uint8_t>(offset >> 8)))
+                {
+                    return false;
+                }
+                return matchCode < 15 || writeLength(matchCode - 15);
+            }
+
+            uint8_t* p;
+            uint8_t* end;
+        };
+    }
+
+    size_t compressBound(size_t srcSize)
+    {
+        return srcSize + srcSize / 255 + 16;
+    }
+
+    size_t compress(uint8_t const* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+    {
+        Writer out(dst, dstCapacity);
+        size_t anchor = 0;
+
+        if (srcSize > MATCH_FIND_LIMIT)
+        {
+            // positions of the last occurrence of each hashed 4-byte sequence; stale or
+            // colliding entries are rejected by comparing the bytes
+            std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+            size_t limit = srcSize - MATCH_FIND_LIMIT;
+            size_t ip = 0;
+
+            while (ip < limit)
+            {
+                uint32_t sequence = read32(src + ip);
+                uint32_t h = hash4(sequence);
+                size_t ref = table[h];
+                table[h] = static_cast<uint32_t>(ip);
+
+                if (ref >= ip || ip - ref > MAX_OFFSET || read32(src + ref) != sequence)
+                {
+                    ++ip;
+                    continue;
+                }
+
+                size_t length = MIN_MATCH;
+                size_t maxLength = srcSize - LAST_LITERALS - ip;
+                while (length < maxLength && src[ref + length] == src[ip + length])
+                {
+                    ++length;
+                }
+
+                if (!out.sequence(src + anchor, ip - anchor, ip - ref, length))
+                {
+                    return 0;
+                }
+                ip += length;
+                anchor = ip;
+            }
+        }
+
+        if (!out.sequence(src + anchor, srcSize - anchor, 0, 0))
+        {
+            return 0;
+        }
+        return static_cast<size_t>(out.p - dst);
+    }
+
+    bool decompress(uint8_t const* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+    {
+        uint8_t const* ip = src;
+        uint8_t const* const ipEnd = src + srcSize;
+        uint8_t* op = dst;
+        uint8_t* const opEnd = dst + dstSize;
+
+        auto readLength = [&](size_t& length) -> bool
+        {
+            uint8_t byte;
+            do
+            {
+                if (ip >= ipEnd)
+                {
+                    return false;
+                }
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        };
+
+        while (ip < ipEnd)
+        {
+            uint8_t token = *ip++;
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !readLength(literalLength))
+            {
+                return false;
+            }
+            if (literalLength > static_cast<size_t>(ipEnd - ip) || literalLength > static_cast<size_t>(opEnd - op))
+            {
+                return false;
+            }
+            memcpy(op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            // the last sequence has no match
+            if (ip == ipEnd)
+            {
+                break;
+            }
+
+            if (ipEnd - ip < 2)
+            {
+                return false;
+            }
+            size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<size_t>(op - dst))
+            {
+                return false;
+            }
+
+            size_t matchLength = token & 15;
+            if (matchLength == 15 && !readLength(matchLength))
+            {
+                return false;
+            }
+            matchLength += MIN_MATCH;
+            if (matchLength > static_cast<size_t>(opEnd - op))
+            {
+                return false;
+            }
+
+            // overlapping copies repeat the last offset bytes, so copy forward byte by byte
+            uint8_t const* match = op - offset;
+            if (offset >= matchLength)
+            {
+                memcpy(op, match, matchLength);
+                op += matchLength;
+            }
+            else
+            {
+                for (size_t i = 0; i < matchLength; ++i)
+                {
+                    *op++ = match[i];
+                }
+            }
+        }
+        return op == opEnd;
+    }
+}
@@ -0,0 +1,149 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(std::string const& fileName)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(
+            fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        return;
+    }
+
+    mapped = reinterpret_cast<uint8_t const*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (mapped == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+
+    if (ptr == MAP_FAILED)
+    {
+        return;
+    }
+
+    mapped = reinterpret_cast<uint8_t const*>(ptr);
+    mappedSize = static_cast<size_t>(st.st_size);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& mf) noexcept :
+        mapped(mf.mapped), mappedSize(mf.mappedSize)
+#if defined(_WIN32)
+        , fileHandle(mf.fileHandle), mappingHandle(mf.mappingHandle)
+#endif
+{
+    mf.mapped = nullptr;
+    mf.mappedSize = 0;
+#if defined(_WIN32)
+    mf.fileHandle = nullptr;
+    mf.mappingHandle = nullptr;
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& mf) noexcept
+{
+    if (this != &mf)
+    {
+        unmap();
+
+        mapped = mf.mapped;
+        mappedSize = mf.mappedSize;
+        mf.mapped = nullptr;
+        mf.mappedSize = 0;
+#if defined(_WIN32)
+        fileHandle = mf.fileHandle;
+        mappingHandle = mf.mappingHandle;
+        mf.fileHandle = nullptr;
+        mf.mappingHandle = nullptr;
+#endif
+    }
+    return *this;
+}
+
+uint8_t const* MappedFile::data() const
+{
+    return mapped;
+}
+
+size_t MappedFile::size() const
+{
+    return mappedSize;
+}
+
+void MappedFile::unmap()
+{
+    if (mapped == nullptr)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(mapped);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(mapped), mappedSize);
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+}
@@ -3,113 +3,286 @@
 //
 
 #include "Mesh.h"
+#include "helpers.h"
 
-Mesh::Mesh(VkDevice* logicalDev, VmaAllocator* allocator, VkPhysicalDevice* physDev, std::string const& objFile) : AVkGraphicsBase(logicalDev), allocator(allocator), physDev(physDev)
+Mesh::Mesh(VkDevice* logicalDev, VmaAllocator* allocator, VkPhysicalDevice* physDev, std::string const& meshFile,
+           MeshImportOptions const& options) : AVkGraphicsBase(logicalDev), allocator(allocator), physDev(physDev)
 {
-    std::vector<glm::vec3> rawVerts;
-    std::vector<glm::vec3> rawNormals;
-
-    std::ifstream objfile(objFile);
-    assert(objfile.is_open());
-
-    std::string buffer;
-
-    while(getline(objfile, buffer))
+    auto const* archive = AssetArchive::mounted();
+    auto const* entry = archive ? archive->find(AssetArchive::normalizeName(meshFile)) : nullptr;
+    if (MeshCache::isCompressed(meshFile))
     {
-        if (buffer[0] == '#')
-        {
-            continue;
-        }
-
-        std::istringstream sstr(buffer);
-        std::string mode;
-        sstr >> mode;
-
-        if (mode == "v")
+        // packed by meshPack: nothing to import, blocks are decoded while uploading
+        cache = MeshCache::CachedMesh::openCompressed(AssetFile::open(meshFile));
+        if (!cache.has_value())
         {
-            std::string x, y, z;
-            sstr >> x >> y >> z;
-            rawVerts.emplace_back(std::stof(x), std::stof(y), std::stof(z));
+            throw std::runtime_error("Cannot open compressed mesh file " + meshFile);
         }
-        else if (mode == "vn")
+    }
+    else if (entry)
+    {
+        // archives are read-only, so only caches packed next to the source are used
+        cache = MeshCache::CachedMesh::open(*archive, meshFile, options.cacheKey());
+        if (!cache.has_value())
         {
-            std::string x, y, z;
-            sstr >> x >> y >> z;
-            rawNormals.emplace_back(std::stof(x), std::stof(y), std::stof(z));
+            uint8_t const* source = archive->view(*entry);
+            if (!source)
+            {
+                borrowedBytes = archive->read(*entry);
+                source = borrowedBytes.data();
+            }
+            importSource(source, entry->size, meshFile, options);
+            if (!data.borrowed.vertices)
+            {
+                borrowedBytes = {};
+            }
         }
-        else if (mode == "f")
+    }
+    else
+    {
+        std::string sourceFile = helpers::searchPath(meshFile);
+        std::string cacheFile = MeshCache::cachePath(sourceFile, options.cacheKey());
+        auto stamp = MeshCache::statSource(sourceFile);
+        if (stamp.has_value() && options.streams(meshFile, stamp->size))
         {
-            std::string tmpindex;
-            uint32_t currIndex = static_cast<uint32_t>(verts.size());
-            int counter = 0;
-
-            while (sstr >> tmpindex)
+            // too large to import in memory: convert straight into the cache and upload from there
+            uint64_t key = options.streamedOptions().cacheKey();
+            std::string streamedFile = MeshCache::cachePath(sourceFile, key);
+            cache = MeshCache::CachedMesh::open(streamedFile, sourceFile, key);
+            if (!cache.has_value())
             {
-                std::vector<std::string> contents;
-                boost::split(contents, tmpindex, [](char c) { return c == '/'; });
-
-                glm::vec3 vert = rawVerts[std::stoi(contents[0]) - 1];
-                glm::vec3 norm(0.f);
-                if (contents.size() >= 3)
+                MappedFile source(sourceFile);
+                if (!source || !MeshCache::importStreamed(
+                        streamedFile, sourceFile, MeshCache::stampSource(source, stamp.value()), key,
+                        options.vertexFormat, options.streamWindowBytes))
                 {
-                    norm = rawNormals[std::stoi(contents[2]) - 1];
+                    throw std::runtime_error("Cannot import mesh file " + meshFile + " out of core!");
                 }
-                auto& it = verts.emplace_back();
-                it.pos = vert;
-                it.normal = norm;
-                it.texCoord = {0.f, 0.f};
-                counter++;
+                cache = MeshCache::CachedMesh::open(streamedFile, sourceFile, key);
             }
+        }
+        else
+        {
+            cache = MeshCache::CachedMesh::open(cacheFile, sourceFile, options.cacheKey());
+        }
 
-            indices.push_back(currIndex);
-            indices.push_back(currIndex + 1);
-            indices.push_back(currIndex + 2);
+        if (!cache.has_value())
+        {
+            MappedFile source(sourceFile);
+            if (sourceFile.empty() || !source)
+            {
+                throw std::runtime_error("Cannot open mesh file " + meshFile);
+            }
 
-            if (counter >= 4)
+            importSource(source.data(), source.size(), meshFile, options);
+            if (data.borrowed.vertices)
+            {
+                // the source file is as fast to load as a cache would be; keep it mapped instead
+                borrowedSource = std::move(source);
+            }
+            else if (stamp.has_value() &&
+                     MeshCache::write(cacheFile, MeshCache::stampSource(source, stamp.value()), options.cacheKey(), data))
             {
-                indices.push_back(currIndex);
-                indices.push_back(currIndex + 2);
-                indices.push_back(currIndex + 3);
+                writtenCache = cacheFile;
+                writtenCacheSource = sourceFile;
+                writtenCacheKey = options.cacheKey();
             }
         }
     }
-    auto idxSize = indices.size() * sizeof(uint32_t);
-    auto vertSize = idxOffset();
+
+    if (cache.has_value())
+    {
+        data.boundsMin = cache->header().boundsMin;
+        data.boundsMax = cache->header().boundsMax;
+    }
+
+    // pipelines are built for one vertex layout, and a packed mesh keeps the one it was packed with
+    if (vertexFormat() != options.vertexFormat)
+    {
+        throw std::runtime_error("Mesh file " + meshFile + " does not hold the requested vertex format!");
+    }
+}
+
+void Mesh::importSource(
+        uint8_t const* source, size_t size, std::string const& meshFile, MeshImportOptions const& options)
+{
+    data = MeshImport::import(source, size, meshFile, options);
+}
+
+size_t Mesh::vertexCount() const
+{
+    return cache.has_value() ? cache->header().vertexCount : data.vertexCount();
+}
+
+VkDeviceSize Mesh::idxOffset() const
+{
+    return vertexCount() * vertexStride(vertexFormat());
+}
+
+size_t Mesh::idxCount() const
+{
+    return cache.has_value() ? cache->header().indexCount : data.indexCount();
+}
+
+MeshOptimizer::Meshlet const* Mesh::meshlets() const
+{
+    return cache.has_value() ? cache->meshlets() : data.meshlets.data();
+}
+
+size_t Mesh::meshletCount() const
+{
+    return cache.has_value() ? cache->header().meshletCount : data.meshlets.size();
+}
+
+size_t Mesh::lodCount() const
+{
+    size_t count = cache.has_value() ? cache->header().lodCount : data.lods.size();
+    return std::max<size_t>(count, 1);
+}
+
+MeshOptimizer::LodLevel Mesh::lod(size_t level) const
+{
+    size_t count = cache.has_value() ? cache->header().lodCount : data.lods.size();
+    if (count == 0)
+    {
+        return {0, static_cast<uint32_t>(idxCount()), 0.f};
+    }
+    return cache.has_value() ? cache->lods()[level] : data.lods[level];
+}
+
+VertexFormat Mesh::vertexFormat() const
+{
+    return cache.has_value() ? static_cast<VertexFormat>(cache->header().vertexFormat) : data.vertexFormat;
+}
+
+VkIndexType Mesh::indexType() const
+{
+    return cache.has_value() ? static_cast<VkIndexType>(cache->header().indexType) : data.indexType;
+}
+
+void Mesh::setDequantization(MeshUniform& uniform) const
+{
+    if (vertexFormat() == QUANTIZED_VERTEX)
+    {
+        uniform.posOffset = glm::vec4(data.boundsMin, 0.f);
+        uniform.posScale = glm::vec4(data.boundsMax - data.boundsMin, 1.f);
+    }
+    else
+    {
+        uniform.posOffset = glm::vec4(0.f);
+        uniform.posScale = glm::vec4(1.f);
+    }
+}
+
+std::pair<glm::vec3, glm::vec3> Mesh::bounds() const
+{
+    return { data.boundsMin, data.boundsMax };
+}
+
+void Mesh::upload(StreamingUpload& uploader)
+{
+    if (resident())
+    {
+        return;
+    }
+
+    VkDeviceSize vertSize = idxOffset();
+    VkDeviceSize idxSize = idxCount() * indexStride(indexType());
     buf = Buffers::Buffer(
             getLogicalDevPtr(), allocator, *physDev, idxSize + vertSize,
             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
             VMA_MEMORY_USAGE_GPU_ONLY,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (cache.has_value())
+    {
+        // pread / decompressed / decoded straight into the staging memory, one chunk at a time
+        uploader.upload(buf, 0, vertSize, [this](uint8_t* dst, VkDeviceSize offset, VkDeviceSize size)
+        {
+            if (!cache->readVertices(offset, static_cast<size_t>(size), dst))
+            {
+                throw std::runtime_error("Cannot read mesh cache!");
+            }
+        });
+        uploader.upload(buf, vertSize, idxSize, [this](uint8_t* dst, VkDeviceSize offset, VkDeviceSize size)
+        {
+            if (!cache->readIndices(offset, static_cast<size_t>(size), dst))
+            {
+                throw std::runtime_error("Cannot read mesh cache!");
+            }
+        });
+        return;
+    }
+
+    auto copyRange = [](void const* src)
+    {
+        return [src](uint8_t* dst, VkDeviceSize offset, VkDeviceSize size)
+        {
+            memcpy(dst, reinterpret_cast<uint8_t const*>(src) + offset, static_cast<size_t>(size));
+        };
+    };
+    uploader.upload(buf, 0, vertSize, copyRange(data.vertexData()));
+    uploader.upload(buf, vertSize, idxSize, copyRange(data.indexData()));
 }
 
-size_t Mesh::idxOffset() const
+void Mesh::evict()
 {
-    return verts.size() * sizeof(NVertex);
+    buf = {};
 }
 
-size_t Mesh::idxCount() const
+bool Mesh::resident() const
+{
+    return static_cast<bool>(buf);
+}
+
+VkDeviceSize Mesh::gpuBytes() const
 {
-    return indices.size();
+    return idxOffset() + idxCount() * indexStride(indexType());
 }
 
-std::shared_ptr<Buffers::StagingBuffer> Mesh::stagingBuffer(std::set<uint32_t> const& transferQueues)
+size_t Mesh::cpuBytes() const
 {
-    auto vertSize = idxOffset();
-    auto idxSize = indices.size() * sizeof(uint32_t);
-    auto stg_ptr = std::make_shared<Buffers::StagingBuffer>(
-            getLogicalDevPtr(), allocator, *physDev, vertSize + idxSize,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            transferQueues);
+    auto bytes = [](auto const& v)
+    {
+        return v.capacity() * sizeof(typename std::decay_t<decltype(v)>::value_type);
+    };
+    return bytes(data.verts) + bytes(data.qverts) + bytes(data.indices) + bytes(data.indices16) +
+           bytes(data.meshlets) + bytes(data.lods) + bytes(data.tangents) + borrowedBytes.capacity();
+}
+
+bool Mesh::releaseCpuData()
+{
+    if (cache.has_value())
+    {
+        return true;
+    }
+    if (writtenCache.empty())
+    {
+        return false;
+    }
+
+    cache = MeshCache::CachedMesh::open(writtenCache, writtenCacheSource, writtenCacheKey);
+    if (!cache.has_value())
+    {
+        return false;
+    }
 
-    stg_ptr->loadData({{verts.data(), 0, vertSize}, {indices.data(), vertSize, idxSize}});
-    return stg_ptr;
+    MeshData released;
+    released.boundsMin = data.boundsMin;
+    released.boundsMax = data.boundsMax;
+    data = std::move(released);
+    return true;
 }
 
 Mesh::Mesh(Mesh&& mesh) noexcept:
         AVkGraphicsBase(std::move(mesh)),
         buf(std::move(mesh.buf)),
-        verts(std::move(mesh.verts)),
-        indices(std::move(mesh.indices)),
+        data(std::move(mesh.data)),
+        cache(std::move(mesh.cache)),
+        borrowedSource(std::move(mesh.borrowedSource)),
+        borrowedBytes(std::move(mesh.borrowedBytes)),
+        writtenCache(std::move(mesh.writtenCache)),
+        writtenCacheSource(std::move(mesh.writtenCacheSource)),
+        writtenCacheKey(mesh.writtenCacheKey),
         allocator(std::move(mesh.allocator)),
         physDev(std::move(mesh.physDev))
 {
@@ -119,8 +292,13 @@ Mesh::Mesh(Mesh&& mesh) noexcept:
 Mesh& Mesh::operator=(Mesh&& mesh) noexcept
 {
     buf = std::move(mesh.buf);
-    verts = std::move(mesh.verts);
-    indices = std::move(mesh.indices);
+    data = std::move(mesh.data);
+    cache = std::move(mesh.cache);
+    borrowedSource = std::move(mesh.borrowedSource);
+    borrowedBytes = std::move(mesh.borrowedBytes);
+    writtenCache = std::move(mesh.writtenCache);
+    writtenCacheSource = std::move(mesh.writtenCacheSource);
+    writtenCacheKey = mesh.writtenCacheKey;
 
     allocator = std::move(mesh.allocator);
     physDev = std::move(mesh.physDev);
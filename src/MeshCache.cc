@@ -0,0 +1,648 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "MeshCache.h"
+#include "MeshCodec.h"
+#include "ObjParser.h"
+#include "helpers.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+namespace MeshCache
+{
+    namespace
+    {
+        uint64_t alignUp(uint64_t value)
+        {
+            return (value + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+        }
+
+        // removes a temporary file when it goes out of scope, whether it was finished or not
+        struct TempFile
+        {
+            explicit TempFile(std::string path) : path(std::move(path))
+            {
+            }
+
+            ~TempFile()
+            {
+                std::error_code err;
+                std::filesystem::remove(path, err);
+            }
+
+            std::string const path;
+        };
+
+        template<typename T>
+        void writeRecords(std::ofstream& out, std::vector<T> const& records)
+        {
+            out.write(reinterpret_cast<char const*>(records.data()),
+                      static_cast<std::streamsize>(records.size() * sizeof(T)));
+        }
+
+        void writePadding(std::ofstream& out, uint64_t size)
+        {
+            char const padding[BLOCK_ALIGNMENT] = {};
+            out.write(padding, static_cast<std::streamsize>(size));
+        }
+
+        /**
+         * Records a new source mtime in the header, so an unchanged source is not hashed again.
+         * Only that field is written, so a failed or interrupted write leaves an mtime that fails
+         * to match at worst, which falls back to the hash again.
+         * @return false if the cache could not be written (e.g. read-only asset directory)
+         */
+        bool restamp(std::string const& cacheFile, int64_t mtime)
+        {
+            std::fstream out(cacheFile, std::ios::binary | std::ios::in | std::ios::out);
+            if (!out)
+            {
+                return false;
+            }
+            out.seekp(static_cast<std::streamoff>(offsetof(Header, source) + offsetof(SourceStamp, mtime)));
+            out.write(reinterpret_cast<char const*>(&mtime), sizeof(mtime));
+            out.flush();
+            return static_cast<bool>(out);
+        }
+
+        bool validHeader(Header const& hdr, uint64_t size, bool compressed = false)
+        {
+            if (size < sizeof(Header) || hdr.magic != (compressed ? COMPRESSED_MAGIC : CACHE_MAGIC) ||
+                hdr.version != CACHE_VERSION)
+            {
+                return false;
+            }
+
+            if (hdr.vertexFormat != FLOAT_VERTEX && hdr.vertexFormat != QUANTIZED_VERTEX)
+            {
+                return false;
+            }
+
+            if (hdr.indexType != VK_INDEX_TYPE_UINT16 && hdr.indexType != VK_INDEX_TYPE_UINT32)
+            {
+                return false;
+            }
+
+            // block extents, written so that none of the products can overflow; the tables
+            // are allocated from these counts before they are read
+            auto fits = [size](uint64_t offset, uint64_t count, uint64_t stride)
+            {
+                return offset % BLOCK_ALIGNMENT == 0 && offset <= size && count <= (size - offset) / stride;
+            };
+            if (compressed)
+            {
+                // encoded streams fill the space up to the next block; their tables are checked on load
+                return hdr.vertexOffset % BLOCK_ALIGNMENT == 0 && hdr.indexOffset % BLOCK_ALIGNMENT == 0 &&
+                       hdr.vertexOffset <= hdr.indexOffset && hdr.indexOffset <= hdr.meshletOffset &&
+                       fits(hdr.meshletOffset, hdr.meshletCount, sizeof(MeshOptimizer::Meshlet)) &&
+                       fits(hdr.lodOffset, hdr.lodCount, sizeof(MeshOptimizer::LodLevel));
+            }
+            return fits(hdr.vertexOffset, hdr.vertexCount, vertexStride(static_cast<VertexFormat>(hdr.vertexFormat))) &&
+                   fits(hdr.indexOffset, hdr.indexCount, indexStride(static_cast<VkIndexType>(hdr.indexType))) &&
+                   fits(hdr.meshletOffset, hdr.meshletCount, sizeof(MeshOptimizer::Meshlet)) &&
+                   fits(hdr.lodOffset, hdr.lodCount, sizeof(MeshOptimizer::LodLevel));
+        }
+    }
+
+    std::string cachePath(std::string const& sourceFile, uint64_t importKey)
+    {
+        char key[17];
+        snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(importKey));
+        return sourceFile + "." + key + CACHE_EXTENSION;
+    }
+
+    bool isCompressed(std::string const& meshFile)
+    {
+        std::string_view extension = COMPRESSED_EXTENSION;
+        return meshFile.size() > extension.size() &&
+               meshFile.compare(meshFile.size() - extension.size(), extension.size(), extension) == 0;
+    }
+
+    optional<SourceStamp> statSource(std::string const& sourceFile)
+    {
+        std::error_code err;
+        auto fileSize = std::filesystem::file_size(sourceFile, err);
+        if (err)
+        {
+            return nullopt;
+        }
+        auto writeTime = std::filesystem::last_write_time(sourceFile, err);
+        if (err)
+        {
+            return nullopt;
+        }
+
+        SourceStamp stamp;
+        stamp.size = fileSize;
+        stamp.mtime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+        return stamp;
+    }
+
+    SourceStamp stampSource(MappedFile const& source, SourceStamp stamp)
+    {
+        stamp.hash = helpers::hashBytes(source.data(), source.size());
+        return stamp;
+    }
+
+    optional<CachedMesh> CachedMesh::open(
+            std::string const& cacheFile, std::string const& sourceFile, uint64_t importKey)
+    {
+        auto current = statSource(sourceFile);
+        if (!current.has_value())
+        {
+            return nullopt;
+        }
+
+        auto file = AssetFile::fromPath(cacheFile);
+        Header hdr;
+        if (!file || !file.read(0, sizeof(Header), &hdr) || !validHeader(hdr, file.size()))
+        {
+            return nullopt;
+        }
+
+        if (hdr.importKey != importKey || hdr.source.size != current->size)
+        {
+            return nullopt;
+        }
+
+        if (hdr.source.mtime != current->mtime)
+        {
+            // touched but possibly unchanged (e.g. fresh checkout); fall back to content
+            MappedFile source(sourceFile);
+            if (!source || stampSource(source, *current).hash != hdr.source.hash)
+            {
+                return nullopt;
+            }
+
+            // closed first, as Windows opens it for shared reading only; a cache that cannot be
+            // restamped is still used, it is just hashed again next time
+            file = AssetFile();
+            bool restamped = restamp(cacheFile, current->mtime);
+
+            // checked again, as the header was written to or the file replaced meanwhile
+            Header written;
+            file = AssetFile::fromPath(cacheFile);
+            if (!file || !file.read(0, sizeof(Header), &written) || !validHeader(written, file.size()) ||
+                written.importKey != importKey || written.source.size != current->size ||
+                written.source.hash != hdr.source.hash ||
+                (restamped && written.source.mtime != current->mtime))
+            {
+                return nullopt;
+            }
+            hdr = written;
+        }
+
+        return load(std::move(file), hdr);
+    }
+
+    optional<CachedMesh> CachedMesh::open(
+            AssetArchive const& archive, std::string const& sourceName, uint64_t importKey)
+    {
+        auto const* source = archive.find(AssetArchive::normalizeName(sourceName));
+        auto const* entry = archive.find(AssetArchive::normalizeName(cachePath(sourceName, importKey)));
+        if (!source || !entry)
+        {
+            return nullopt;
+        }
+
+        // only the blocks holding the header are decompressed here
+        auto file = AssetFile::fromArchive(archive, *entry);
+        Header hdr;
+        if (!file.read(0, sizeof(Header), &hdr) || !validHeader(hdr, file.size()) ||
+            hdr.importKey != importKey || hdr.source.size != source->size || hdr.source.hash != source->contentHash)
+        {
+            return nullopt;
+        }
+        return load(std::move(file), hdr);
+    }
+
+    optional<CachedMesh> CachedMesh::openCompressed(AssetFile&& file)
+    {
+        Header hdr;
+        if (!file || !file.read(0, sizeof(Header), &hdr) || !validHeader(hdr, file.size(), true))
+        {
+            return nullopt;
+        }
+
+        // the block table of a stream stored in [begin, end) of the file
+        auto readStream = [&file](uint64_t begin, uint64_t end, uint64_t count, size_t blockSize,
+                                  EncodedStream& stream)
+        {
+            uint64_t blockCount = count / blockSize + (count % blockSize != 0);
+            uint64_t storedCount;
+            if (end - begin < sizeof(uint64_t) || !file.read(begin, sizeof(uint64_t), &storedCount) ||
+                storedCount != blockCount || blockCount > (end - begin) / sizeof(uint64_t) - 1)
+            {
+                return false;
+            }
+
+            stream.dataOffset = begin + (1 + blockCount) * sizeof(uint64_t);
+            stream.blockEnds.resize(blockCount);
+            if (!file.read(begin + sizeof(uint64_t), blockCount * sizeof(uint64_t), stream.blockEnds.data()))
+            {
+                return false;
+            }
+
+            uint64_t prev = 0;
+            for (uint64_t blockEnd : stream.blockEnds)
+            {
+                if (blockEnd < prev)
+                {
+                    return false;
+                }
+                prev = blockEnd;
+            }
+            return prev <= end - stream.dataOffset;
+        };
+
+        EncodedStream vertexStream, indexStream;
+        if (!readStream(hdr.vertexOffset, hdr.indexOffset, hdr.vertexCount, MeshCodec::VERTEX_BLOCK, vertexStream) ||
+            !readStream(hdr.indexOffset, hdr.meshletOffset, hdr.indexCount, MeshCodec::INDEX_BLOCK, indexStream))
+        {
+            return nullopt;
+        }
+
+        auto mesh = load(std::move(file), hdr);
+        if (mesh.has_value())
+        {
+            mesh->compressed = true;
+            mesh->vertexStream = std::move(vertexStream);
+            mesh->indexStream = std::move(indexStream);
+        }
+        return mesh;
+    }
+
+    optional<CachedMesh> CachedMesh::load(AssetFile&& file, Header const& hdr)
+    {
+        CachedMesh mesh;
+        mesh.hdr = hdr;
+        mesh.meshletTable.resize(hdr.meshletCount);
+        mesh.lodTable.resize(hdr.lodCount);
+        if (!file.read(hdr.meshletOffset, hdr.meshletCount * sizeof(MeshOptimizer::Meshlet), mesh.meshletTable.data()) ||
+            !file.read(hdr.lodOffset, hdr.lodCount * sizeof(MeshOptimizer::LodLevel), mesh.lodTable.data()))
+        {
+            return nullopt;
+        }
+        mesh.cacheFile = std::move(file);
+        return mesh;
+    }
+
+    bool CachedMesh::readVertices(uint64_t offset, size_t size, void* dst) const
+    {
+        uint64_t vertSize = hdr.vertexCount * vertexStride(static_cast<VertexFormat>(hdr.vertexFormat));
+        if (offset > vertSize || size > vertSize - offset)
+        {
+            return false;
+        }
+        return compressed ? readEncoded(vertexStream, true, offset, size, reinterpret_cast<uint8_t*>(dst)) :
+               cacheFile.read(hdr.vertexOffset + offset, size, dst);
+    }
+
+    bool CachedMesh::readIndices(uint64_t offset, size_t size, void* dst) const
+    {
+        uint64_t idxSize = hdr.indexCount * indexStride(static_cast<VkIndexType>(hdr.indexType));
+        if (offset > idxSize || size > idxSize - offset)
+        {
+            return false;
+        }
+        return compressed ? readEncoded(indexStream, false, offset, size, reinterpret_cast<uint8_t*>(dst)) :
+               cacheFile.read(hdr.indexOffset + offset, size, dst);
+    }
+
+    bool CachedMesh::readEncoded(
+            EncodedStream const& stream, bool vertices, uint64_t offset, size_t size, uint8_t* dst) const
+    {
+        size_t elementSize = vertices ? vertexStride(static_cast<VertexFormat>(hdr.vertexFormat)) :
+                             indexStride(static_cast<VkIndexType>(hdr.indexType));
+        uint64_t elementCount = vertices ? hdr.vertexCount : hdr.indexCount;
+        size_t blockElements = vertices ? MeshCodec::VERTEX_BLOCK : MeshCodec::INDEX_BLOCK;
+        uint64_t blockBytes = blockElements * elementSize;
+        if (size == 0)
+        {
+            return true;
+        }
+
+        std::vector<uint8_t> encoded, partial;
+        for (uint64_t block = offset / blockBytes; block * blockBytes < offset + size; ++block)
+        {
+            uint64_t blockStart = block * blockBytes;
+            auto count = static_cast<size_t>(std::min<uint64_t>(blockElements, elementCount - block * blockElements));
+            uint64_t blockEnd = blockStart + count * elementSize;
+
+            uint64_t encodedBegin = block == 0 ? 0 : stream.blockEnds[block - 1];
+            encoded.resize(stream.blockEnds[block] - encodedBegin);
+            if (!cacheFile.read(stream.dataOffset + encodedBegin, encoded.size(), encoded.data()))
+            {
+                return false;
+            }
+
+            // whole blocks decode straight into dst, the ends of the range through scratch
+            uint64_t from = std::max(offset, blockStart);
+            uint64_t to = std::min(offset + size, blockEnd);
+            bool whole = from == blockStart && to == blockEnd;
+            partial.resize(whole ? 0 : count * elementSize);
+            uint8_t* target = whole ? dst + (from - offset) : partial.data();
+
+            bool decoded = vertices ?
+                    MeshCodec::decodeVertexBlock(encoded.data(), encoded.size(), target, count, elementSize) :
+                    MeshCodec::decodeIndexBlock(encoded.data(), encoded.size(), target, count,
+                                                static_cast<VkIndexType>(hdr.indexType), hdr.vertexCount);
+            if (!decoded)
+            {
+                return false;
+            }
+            if (!whole)
+            {
+                memcpy(dst + (from - offset), partial.data() + (from - blockStart), to - from);
+            }
+        }
+        return true;
+    }
+
+    MeshOptimizer::Meshlet const* CachedMesh::meshlets() const
+    {
+        return meshletTable.data();
+    }
+
+    MeshOptimizer::LodLevel const* CachedMesh::lods() const
+    {
+        return lodTable.data();
+    }
+
+    Header const& CachedMesh::header() const
+    {
+        return hdr;
+    }
+
+    bool write(
+            std::string const& cacheFile, SourceStamp const& source, uint64_t importKey, MeshData const& mesh)
+    {
+        size_t vertSize = mesh.vertexCount() * vertexStride(mesh.vertexFormat);
+        size_t idxSize = mesh.indexCount() * indexStride(mesh.indexType);
+        size_t meshletSize = mesh.meshlets.size() * sizeof(MeshOptimizer::Meshlet);
+        size_t lodSize = mesh.lods.size() * sizeof(MeshOptimizer::LodLevel);
+
+        Header hdr = {};
+        hdr.magic = CACHE_MAGIC;
+        hdr.version = CACHE_VERSION;
+        hdr.source = source;
+        hdr.importKey = importKey;
+        hdr.vertexFormat = mesh.vertexFormat;
+        hdr.indexType = mesh.indexType;
+        hdr.vertexCount = mesh.vertexCount();
+        hdr.vertexOffset = alignUp(sizeof(Header));
+        hdr.indexCount = mesh.indexCount();
+        hdr.indexOffset = alignUp(hdr.vertexOffset + vertSize);
+        hdr.meshletCount = mesh.meshlets.size();
+        hdr.meshletOffset = alignUp(hdr.indexOffset + idxSize);
+        hdr.lodCount = mesh.lods.size();
+        hdr.lodOffset = alignUp(hdr.meshletOffset + meshletSize);
+        hdr.boundsMin = mesh.boundsMin;
+        hdr.boundsMax = mesh.boundsMax;
+
+        std::string tmpFile = cacheFile + ".tmp";
+        {
+            std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                return false;
+            }
+
+            char const padding[BLOCK_ALIGNMENT] = {};
+            auto writeBlock = [&](void const* data, size_t size, uint64_t offset, uint64_t nextOffset)
+            {
+                out.write(reinterpret_cast<char const*>(data), static_cast<std::streamsize>(size));
+                out.write(padding, static_cast<std::streamsize>(nextOffset - offset - size));
+            };
+
+            writeBlock(&hdr, sizeof(Header), 0, hdr.vertexOffset);
+            writeBlock(mesh.vertexData(), vertSize, hdr.vertexOffset, hdr.indexOffset);
+            writeBlock(mesh.indexData(), idxSize, hdr.indexOffset, hdr.meshletOffset);
+            writeBlock(mesh.meshlets.data(), meshletSize, hdr.meshletOffset, hdr.lodOffset);
+            writeBlock(mesh.lods.data(), lodSize, hdr.lodOffset, hdr.lodOffset + lodSize);
+
+            if (!out)
+            {
+                out.close();
+                std::filesystem::remove(tmpFile);
+                return false;
+            }
+        }
+
+        std::error_code err;
+        std::filesystem::rename(tmpFile, cacheFile, err);
+        if (err)
+        {
+            std::filesystem::remove(tmpFile, err);
+            return false;
+        }
+        return true;
+    }
+
+    bool importStreamed(
+            std::string const& cacheFile, std::string const& sourceFile, SourceStamp const& source,
+            uint64_t importKey, VertexFormat vertexFormat, size_t windowBytes)
+    {
+        auto in = AssetFile::fromPath(sourceFile);
+        if (!in || windowBytes == 0)
+        {
+            return false;
+        }
+
+        // pass 1: parse window by window, spilling attributes and triangle corners to files
+        // that pass 2 maps, so faces can reference any vertex of the file
+        TempFile positionFile(cacheFile + ".pos.tmp");
+        TempFile texCoordFile(cacheFile + ".tex.tmp");
+        TempFile normalFile(cacheFile + ".nrm.tmp");
+        TempFile cornerFile(cacheFile + ".corners.tmp");
+        ObjParser::RecordCounts seen;
+        uint64_t cornerCount = 0;
+        // of every position, so quantized vertices can be written in a single pass below
+        glm::vec3 boundsMin(0.f);
+        glm::vec3 boundsMax(0.f);
+        bool bounded = false;
+        {
+            std::ofstream positions(positionFile.path, std::ios::binary | std::ios::trunc);
+            std::ofstream texCoords(texCoordFile.path, std::ios::binary | std::ios::trunc);
+            std::ofstream normals(normalFile.path, std::ios::binary | std::ios::trunc);
+            std::ofstream corners(cornerFile.path, std::ios::binary | std::ios::trunc);
+
+            std::vector<char> window(windowBytes);
+            size_t carried = 0;
+            uint64_t offset = 0;
+            while (offset < in.size())
+            {
+                auto chunk = static_cast<size_t>(std::min<uint64_t>(window.size() - carried, in.size() - offset));
+                if (!in.read(offset, chunk, window.data() + carried))
+                {
+                    return false;
+                }
+                offset += chunk;
+                size_t filled = carried + chunk;
+
+                // the incomplete last line moves on to the next window
+                size_t parsed = filled;
+                if (offset < in.size())
+                {
+                    while (parsed > 0 && window[parsed - 1] != '\n')
+                    {
+                        --parsed;
+                    }
+                    if (parsed == 0)
+                    {
+                        // a single line longer than the window
+                        window.resize(window.size() * 2);
+                        carried = filled;
+                        continue;
+                    }
+                }
+
+                auto data = ObjParser::parseWindow(window.data(), window.data() + parsed, seen);
+                for (glm::vec3 const& position : data.positions)
+                {
+                    boundsMin = bounded ? glm::min(boundsMin, position) : position;
+                    boundsMax = bounded ? glm::max(boundsMax, position) : position;
+                    bounded = true;
+                }
+                writeRecords(positions, data.positions);
+                writeRecords(texCoords, data.texCoords);
+                writeRecords(normals, data.normals);
+                writeRecords(corners, data.corners);
+                cornerCount += data.corners.size();
+
+                carried = filled - parsed;
+                memmove(window.data(), window.data() + parsed, carried);
+            }
+
+            if (!positions || !texCoords || !normals || !corners)
+            {
+                return false;
+            }
+        }
+
+        // pass 2: the unwelded mesh, one vertex per corner, written straight into the cache.
+        // MappedFile refuses empty files, which is fine as nothing can reference them then
+        MappedFile positionMap(positionFile.path);
+        MappedFile texCoordMap(texCoordFile.path);
+        MappedFile normalMap(normalFile.path);
+        auto cornerIn = AssetFile::fromPath(cornerFile.path);
+        auto const* positionData = reinterpret_cast<glm::vec3 const*>(positionMap.data());
+        auto const* texCoordData = reinterpret_cast<glm::vec2 const*>(texCoordMap.data());
+        auto const* normalData = reinterpret_cast<glm::vec3 const*>(normalMap.data());
+
+        // indices are 32-bit
+        if (cornerCount > std::numeric_limits<uint32_t>::max() + uint64_t(1))
+        {
+            return false;
+        }
+
+        // same narrowing rule as the in-memory import
+        VkIndexType indexType = cornerCount <= std::numeric_limits<uint16_t>::max() + uint64_t(1) ?
+                                VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+        Header hdr = {};
+        hdr.magic = CACHE_MAGIC;
+        hdr.version = CACHE_VERSION;
+        hdr.source = source;
+        hdr.importKey = importKey;
+        hdr.vertexFormat = vertexFormat;
+        hdr.indexType = indexType;
+        hdr.vertexCount = cornerCount;
+        hdr.vertexOffset = alignUp(sizeof(Header));
+        hdr.indexCount = cornerCount;
+        hdr.indexOffset = alignUp(hdr.vertexOffset + cornerCount * vertexStride(vertexFormat));
+        hdr.boundsMin = boundsMin;
+        hdr.boundsMax = boundsMax;
+        hdr.meshletOffset = alignUp(hdr.indexOffset + cornerCount * indexStride(indexType));
+        hdr.lodOffset = hdr.meshletOffset;
+
+        TempFile tmpFile(cacheFile + ".tmp");
+        {
+            std::ofstream out(tmpFile.path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<char const*>(&hdr), sizeof(Header));
+            writePadding(out, hdr.vertexOffset - sizeof(Header));
+
+            size_t windowCorners = std::max<size_t>(windowBytes / sizeof(NVertex), 1);
+            std::vector<ObjParser::Corner> corners(windowCorners);
+            std::vector<NVertex> verts(windowCorners);
+            std::vector<QVertex> qverts(vertexFormat == QUANTIZED_VERTEX ? windowCorners : 0);
+            for (uint64_t first = 0; first < cornerCount; first += windowCorners)
+            {
+                auto count = static_cast<size_t>(std::min<uint64_t>(windowCorners, cornerCount - first));
+                if (!cornerIn.read(first * sizeof(ObjParser::Corner), count * sizeof(ObjParser::Corner), corners.data()))
+                {
+                    return false;
+                }
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    auto const& corner = corners[i];
+                    if (corner.pos >= seen.positions)
+                    {
+                        return false;
+                    }
+
+                    auto& vert = verts[i];
+                    vert.pos = positionData[corner.pos];
+                    vert.normal = corner.normal < seen.normals ? normalData[corner.normal] : glm::vec3(0.f);
+                    // OBJ texture space has v pointing up, Vulkan samples top-down
+                    vert.texCoord = corner.tex < seen.texCoords ?
+                            glm::vec2(texCoordData[corner.tex].x, 1.f - texCoordData[corner.tex].y) :
+                            glm::vec2(0.f);
+                    if (vertexFormat == QUANTIZED_VERTEX)
+                    {
+                        qverts[i] = QVertex::quantize(vert, boundsMin, boundsMax);
+                    }
+                }
+                if (vertexFormat == QUANTIZED_VERTEX)
+                {
+                    out.write(reinterpret_cast<char const*>(qverts.data()),
+                              static_cast<std::streamsize>(count * sizeof(QVertex)));
+                }
+                else
+                {
+                    out.write(reinterpret_cast<char const*>(verts.data()),
+                              static_cast<std::streamsize>(count * sizeof(NVertex)));
+                }
+            }
+            writePadding(out, hdr.indexOffset - (hdr.vertexOffset + cornerCount * vertexStride(vertexFormat)));
+
+            // unwelded, so the indices just count up
+            std::vector<uint32_t> indices(indexType == VK_INDEX_TYPE_UINT32 ? windowCorners : 0);
+            std::vector<uint16_t> indices16(indexType == VK_INDEX_TYPE_UINT16 ? windowCorners : 0);
+            for (uint64_t first = 0; first < cornerCount; first += windowCorners)
+            {
+                auto count = static_cast<size_t>(std::min<uint64_t>(windowCorners, cornerCount - first));
+                if (indexType == VK_INDEX_TYPE_UINT16)
+                {
+                    std::iota(indices16.begin(), indices16.begin() + static_cast<ptrdiff_t>(count), static_cast<uint16_t>(first));
+                    out.write(reinterpret_cast<char const*>(indices16.data()),
+                              static_cast<std::streamsize>(count * sizeof(uint16_t)));
+                }
+                else
+                {
+                    std::iota(indices.begin(), indices.begin() + static_cast<ptrdiff_t>(count), static_cast<uint32_t>(first));
+                    out.write(reinterpret_cast<char const*>(indices.data()),
+                              static_cast<std::streamsize>(count * sizeof(uint32_t)));
+                }
+            }
+            writePadding(out, hdr.meshletOffset - (hdr.indexOffset + cornerCount * indexStride(indexType)));
+
+            out.seekp(0);
+            out.write(reinterpret_cast<char const*>(&hdr), sizeof(Header));
+            if (!out)
+            {
+                return false;
+            }
+        }
+
+        std::error_code err;
+        std::filesystem::rename(tmpFile.path, cacheFile, err);
+        return !err;
+    }
+}
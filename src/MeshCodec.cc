@@ -0,0 +1,539 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "MeshCodec.h"
+#include "MeshCache.h"
+#include "CpuFeatures.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace MeshCodec
+{
+    namespace
+    {
+        // NVertex; wider layouts would need a bigger lane buffer
+        constexpr size_t MAX_LANES = 8;
+
+        struct DecodeTables
+        {
+            // pshufb masks expanding the data bytes of four values into four 32-bit lanes
+            uint8_t shuffle[256][16];
+            // data bytes of the four values of a control byte
+            uint8_t length[256];
+        };
+
+        DecodeTables buildTables()
+        {
+            DecodeTables tables = {};
+            for (uint32_t control = 0; control < 256; ++control)
+            {
+                uint8_t pos = 0;
+                for (uint32_t value = 0; value < 4; ++value)
+                {
+                    uint32_t length = ((control >> (2 * value)) & 3) + 1;
+                    for (uint32_t byte = 0; byte < 4; ++byte)
+                    {
+                        tables.shuffle[control][4 * value + byte] = byte < length ? static_cast<uint8_t>(pos + byte) : 0x80;
+                    }
+                    pos += static_cast<uint8_t>(length);
+                }
+                tables.length[control] = pos;
+            }
+            return tables;
+        }
+
+        DecodeTables const& tables()
+        {
+            static DecodeTables const decodeTables = buildTables();
+            return decodeTables;
+        }
+
+        uint32_t zigzag(uint32_t delta)
+        {
+            return (delta << 1) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+        }
+
+        uint32_t unzigzag(uint32_t value)
+        {
+            return (value >> 1) ^ (0u - (value & 1));
+        }
+
+        uint32_t byteLength(uint32_t value)
+        {
+            return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+        }
+
+        /**
+         * Appends count delta coded values as control bytes followed by data bytes.
+         * @param value returns element i of the lane
+         */
+        template<typename ValueFn>
+        void encodeLane(size_t count, ValueFn const& value, std::vector<uint8_t>& out)
+        {
+            size_t control = out.size();
+            out.resize(out.size() + (count + 3) / 4, 0);
+
+            uint32_t prev = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t current = value(i);
+                uint32_t code = zigzag(current - prev);
+                prev = current;
+
+                uint32_t length = byteLength(code);
+                out[control + i / 4] |= static_cast<uint8_t>((length - 1) << (2 * (i % 4)));
+                for (uint32_t byte = 0; byte < length; ++byte)
+                {
+                    out.push_back(static_cast<uint8_t>(code >> (8 * byte)));
+                }
+            }
+        }
+
+        // dst of a range read need not be aligned
+        template<typename T>
+        void storeValue(T* out, uint32_t value)
+        {
+            auto narrowed = static_cast<T>(value);
+            memcpy(out, &narrowed, sizeof(T));
+        }
+
+#if defined(CPU_X86)
+        /**
+         * Decodes whole groups of four values while 16 bytes can be loaded from data.
+         * @return groups decoded; data, prev and maxValue are advanced past them
+         */
+        template<typename T>
+        TARGET_SSE41
+        size_t decodeGroupsSse41(
+                uint8_t const* control, size_t groups, uint8_t const*& data, uint8_t const* dataEnd,
+                uint32_t& prev, uint32_t& maxValue, T* out)
+        {
+            auto const& t = tables();
+            __m128i const one = _mm_set1_epi32(1);
+            __m128i last = _mm_set1_epi32(static_cast<int>(prev));
+            __m128i maxv = _mm_set1_epi32(static_cast<int>(maxValue));
+
+            size_t g = 0;
+            for (; g < groups && dataEnd - data >= 16; ++g)
+            {
+                uint8_t c = control[g];
+                __m128i v = _mm_shuffle_epi8(
+                        _mm_loadu_si128(reinterpret_cast<__m128i const*>(data)),
+                        _mm_loadu_si128(reinterpret_cast<__m128i const*>(t.shuffle[c])));
+                data += t.length[c];
+
+                v = _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, one)));
+                // prefix sum of the deltas, then add the last value of the previous group
+                v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+                v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+                v = _mm_add_epi32(v, last);
+                last = _mm_shuffle_epi32(v, 0xFF);
+                maxv = _mm_max_epu32(maxv, v);
+
+                if constexpr (sizeof(T) == sizeof(uint16_t))
+                {
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4 * g), _mm_packus_epi32(v, v));
+                }
+                else
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * g), v);
+                }
+            }
+
+            prev = static_cast<uint32_t>(_mm_cvtsi128_si32(last));
+            maxv = _mm_max_epu32(maxv, _mm_shuffle_epi32(maxv, 0x4E));
+            maxv = _mm_max_epu32(maxv, _mm_shuffle_epi32(maxv, 0xB1));
+            maxValue = static_cast<uint32_t>(_mm_cvtsi128_si32(maxv));
+            return g;
+        }
+#endif
+
+        /**
+         * Decodes a lane written by encodeLane.
+         * @param maxValue raised to the largest decoded value
+         * @return the end of the lane, or null if it does not fit into [p, end)
+         */
+        template<typename T>
+        uint8_t const* decodeLane(uint8_t const* p, uint8_t const* end, size_t count, uint32_t& maxValue, T* out)
+        {
+            size_t controlSize = (count + 3) / 4;
+            if (static_cast<size_t>(end - p) < controlSize)
+            {
+                return nullptr;
+            }
+
+            auto const& t = tables();
+            uint8_t const* control = p;
+            uint8_t const* data = p + controlSize;
+            size_t fullGroups = count / 4;
+            size_t dataSize = 0;
+            for (size_t g = 0; g < fullGroups; ++g)
+            {
+                dataSize += t.length[control[g]];
+            }
+            for (size_t i = fullGroups * 4; i < count; ++i)
+            {
+                dataSize += ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+            }
+            if (static_cast<size_t>(end - data) < dataSize)
+            {
+                return nullptr;
+            }
+            uint8_t const* dataEnd = data + dataSize;
+
+            uint32_t prev = 0;
+            size_t first = 0;
+#if defined(CPU_X86)
+            if (CpuFeatures::detected().sse41)
+            {
+                first = 4 * decodeGroupsSse41(control, fullGroups, data, dataEnd, prev, maxValue, out);
+            }
+#endif
+            for (size_t i = first; i < count; ++i)
+            {
+                uint32_t length = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+                uint32_t code = 0;
+                for (uint32_t byte = 0; byte < length; ++byte)
+                {
+                    code |= static_cast<uint32_t>(data[byte]) << (8 * byte);
+                }
+                data += length;
+
+                prev += unzigzag(code);
+                maxValue = std::max(maxValue, prev);
+                storeValue(out + i, prev);
+            }
+            return dataEnd;
+        }
+
+#if defined(CPU_X86)
+        TARGET_SSE41
+        void transpose4(
+                __m128i r0, __m128i r1, __m128i r2, __m128i r3,
+                __m128i& v0, __m128i& v1, __m128i& v2, __m128i& v3)
+        {
+            __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+            __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+            __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+            __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+            v0 = _mm_unpacklo_epi64(t0, t2);
+            v1 = _mm_unpackhi_epi64(t0, t2);
+            v2 = _mm_unpacklo_epi64(t1, t3);
+            v3 = _mm_unpackhi_epi64(t1, t3);
+        }
+
+        // lanes 4 or 8; returns the vertices written
+        TARGET_SSE41
+        size_t interleaveSse41(uint32_t const (*lanes)[VERTEX_BLOCK], size_t laneCount, size_t count, uint8_t* dst)
+        {
+            auto load = [&](size_t lane, size_t i)
+            {
+                return _mm_loadu_si128(reinterpret_cast<__m128i const*>(lanes[lane] + i));
+            };
+
+            size_t stride = laneCount * sizeof(uint32_t);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                for (size_t half = 0; half < laneCount; half += 4)
+                {
+                    __m128i v[4];
+                    transpose4(load(half, i), load(half + 1, i), load(half + 2, i), load(half + 3, i),
+                               v[0], v[1], v[2], v[3]);
+                    for (size_t k = 0; k < 4; ++k)
+                    {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (i + k) * stride + half * sizeof(uint32_t)), v[k]);
+                    }
+                }
+            }
+            return i;
+        }
+
+        // 8 lanes (NVertex): one 8x8 transpose turns 8 lane rows into 8 vertices
+        TARGET_AVX2
+        size_t interleaveAvx2(uint32_t const (*lanes)[VERTEX_BLOCK], size_t count, uint8_t* dst)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i r[8];
+                for (size_t lane = 0; lane < 8; ++lane)
+                {
+                    r[lane] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(lanes[lane] + i));
+                }
+
+                __m256i t[8], u[8];
+                for (size_t k = 0; k < 8; k += 2)
+                {
+                    t[k] = _mm256_unpacklo_epi32(r[k], r[k + 1]);
+                    t[k + 1] = _mm256_unpackhi_epi32(r[k], r[k + 1]);
+                }
+                for (size_t k = 0; k < 8; k += 4)
+                {
+                    u[k] = _mm256_unpacklo_epi64(t[k], t[k + 2]);
+                    u[k + 1] = _mm256_unpackhi_epi64(t[k], t[k + 2]);
+                    u[k + 2] = _mm256_unpacklo_epi64(t[k + 1], t[k + 3]);
+                    u[k + 3] = _mm256_unpackhi_epi64(t[k + 1], t[k + 3]);
+                }
+
+                // u[k] holds lanes 0-3 (k < 4) or 4-7 of vertices k % 4 and k % 4 + 4
+                auto* out = reinterpret_cast<__m256i*>(dst + i * 8 * sizeof(uint32_t));
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    _mm256_storeu_si256(out + k, _mm256_permute2x128_si256(u[k], u[k + 4], 0x20));
+                    _mm256_storeu_si256(out + k + 4, _mm256_permute2x128_si256(u[k], u[k + 4], 0x31));
+                }
+            }
+            return i;
+        }
+#endif
+
+        // lane-major block to interleaved vertices, written once to dst
+        void interleave(uint32_t const (*lanes)[VERTEX_BLOCK], size_t laneCount, size_t count, uint8_t* dst)
+        {
+            size_t first = 0;
+#if defined(CPU_X86)
+            if (laneCount == 8 && CpuFeatures::detected().avx2)
+            {
+                first = interleaveAvx2(lanes, count, dst);
+            }
+            else if ((laneCount == 4 || laneCount == 8) && CpuFeatures::detected().sse41)
+            {
+                first = interleaveSse41(lanes, laneCount, count, dst);
+            }
+#endif
+            for (size_t i = first; i < count; ++i)
+            {
+                for (size_t lane = 0; lane < laneCount; ++lane)
+                {
+                    memcpy(dst + (i * laneCount + lane) * sizeof(uint32_t), &lanes[lane][i], sizeof(uint32_t));
+                }
+            }
+        }
+
+        template<typename EncodeBlock>
+        std::vector<uint8_t> encodeStream(size_t count, size_t blockSize, EncodeBlock const& encodeBlock)
+        {
+            uint64_t blockCount = (count + blockSize - 1) / blockSize;
+            std::vector<uint8_t> out((1 + blockCount) * sizeof(uint64_t));
+            size_t dataStart = out.size();
+
+            std::vector<uint64_t> blockEnds(blockCount);
+            for (uint64_t b = 0; b < blockCount; ++b)
+            {
+                size_t first = b * blockSize;
+                encodeBlock(first, std::min(blockSize, count - first), out);
+                blockEnds[b] = out.size() - dataStart;
+            }
+
+            memcpy(out.data(), &blockCount, sizeof(uint64_t));
+            if (blockCount > 0)
+            {
+                memcpy(out.data() + sizeof(uint64_t), blockEnds.data(), blockCount * sizeof(uint64_t));
+            }
+            return out;
+        }
+
+        template<typename DecodeBlock>
+        bool decodeStream(
+                uint8_t const* src, size_t srcSize, size_t count, size_t blockSize, DecodeBlock const& decodeBlock)
+        {
+            uint64_t blockCount;
+            if (srcSize < sizeof(uint64_t))
+            {
+                return false;
+            }
+            memcpy(&blockCount, src, sizeof(uint64_t));
+            if (blockCount != (count + blockSize - 1) / blockSize ||
+                blockCount > (srcSize - sizeof(uint64_t)) / sizeof(uint64_t))
+            {
+                return false;
+            }
+
+            uint8_t const* data = src + (1 + blockCount) * sizeof(uint64_t);
+            size_t dataSize = srcSize - (1 + blockCount) * sizeof(uint64_t);
+            uint64_t begin = 0;
+            for (uint64_t b = 0; b < blockCount; ++b)
+            {
+                uint64_t end;
+                memcpy(&end, src + (1 + b) * sizeof(uint64_t), sizeof(uint64_t));
+                size_t first = b * blockSize;
+                if (end < begin || end > dataSize ||
+                    !decodeBlock(data + begin, end - begin, first, std::min(blockSize, count - first)))
+                {
+                    return false;
+                }
+                begin = end;
+            }
+            return true;
+        }
+
+        template<typename T>
+        bool decodeIndexBlock(uint8_t const* src, size_t srcSize, T* dst, size_t count, uint64_t vertexCount)
+        {
+            uint32_t maxValue = 0;
+            if (count > INDEX_BLOCK || !decodeLane(src, src + srcSize, count, maxValue, dst))
+            {
+                return false;
+            }
+            // out of range indices would read past the vertex buffer on the GPU
+            return count == 0 || maxValue < vertexCount;
+        }
+
+        uint64_t alignUp(uint64_t value)
+        {
+            return (value + MeshCache::BLOCK_ALIGNMENT - 1) & ~uint64_t(MeshCache::BLOCK_ALIGNMENT - 1);
+        }
+    }
+
+    std::vector<uint8_t> encodeVertices(void const* vertices, size_t count, size_t stride)
+    {
+        auto const* bytes = reinterpret_cast<uint8_t const*>(vertices);
+        size_t laneCount = stride / sizeof(uint32_t);
+        return encodeStream(count, VERTEX_BLOCK, [&](size_t first, size_t blockCount, std::vector<uint8_t>& out)
+        {
+            for (size_t lane = 0; lane < laneCount; ++lane)
+            {
+                encodeLane(blockCount, [&](size_t i)
+                {
+                    uint32_t value;
+                    memcpy(&value, bytes + (first + i) * stride + lane * sizeof(uint32_t), sizeof(uint32_t));
+                    return value;
+                }, out);
+            }
+        });
+    }
+
+    std::vector<uint8_t> encodeIndices(void const* indices, size_t count, VkIndexType indexType)
+    {
+        return encodeStream(count, INDEX_BLOCK, [&](size_t first, size_t blockCount, std::vector<uint8_t>& out)
+        {
+            encodeLane(blockCount, [&](size_t i) -> uint32_t
+            {
+                return indexType == VK_INDEX_TYPE_UINT16 ?
+                       reinterpret_cast<uint16_t const*>(indices)[first + i] :
+                       reinterpret_cast<uint32_t const*>(indices)[first + i];
+            }, out);
+        });
+    }
+
+    bool decodeVertexBlock(uint8_t const* src, size_t srcSize, void* dst, size_t count, size_t stride)
+    {
+        size_t laneCount = stride / sizeof(uint32_t);
+        if (count > VERTEX_BLOCK || stride % sizeof(uint32_t) != 0 || laneCount > MAX_LANES)
+        {
+            return false;
+        }
+
+        // decoded lane by lane into L1-sized scratch, then interleaved straight into dst
+        alignas(32) uint32_t lanes[MAX_LANES][VERTEX_BLOCK];
+        uint8_t const* p = src;
+        uint8_t const* end = src + srcSize;
+        uint32_t maxValue = 0;
+        for (size_t lane = 0; lane < laneCount; ++lane)
+        {
+            p = decodeLane(p, end, count, maxValue, lanes[lane]);
+            if (!p)
+            {
+                return false;
+            }
+        }
+        interleave(lanes, laneCount, count, reinterpret_cast<uint8_t*>(dst));
+        return true;
+    }
+
+    bool decodeIndexBlock(
+            uint8_t const* src, size_t srcSize, void* dst, size_t count, VkIndexType indexType, uint64_t vertexCount)
+    {
+        return indexType == VK_INDEX_TYPE_UINT16 ?
+               decodeIndexBlock(src, srcSize, reinterpret_cast<uint16_t*>(dst), count, vertexCount) :
+               decodeIndexBlock(src, srcSize, reinterpret_cast<uint32_t*>(dst), count, vertexCount);
+    }
+
+    bool decodeVertices(uint8_t const* src, size_t srcSize, void* dst, size_t count, size_t stride)
+    {
+        auto* out = reinterpret_cast<uint8_t*>(dst);
+        return decodeStream(src, srcSize, count, VERTEX_BLOCK,
+                            [&](uint8_t const* block, size_t blockSize, size_t first, size_t blockCount)
+        {
+            return decodeVertexBlock(block, blockSize, out + first * stride, blockCount, stride);
+        });
+    }
+
+    bool decodeIndices(
+            uint8_t const* src, size_t srcSize, void* dst, size_t count, VkIndexType indexType, uint64_t vertexCount)
+    {
+        auto* out = reinterpret_cast<uint8_t*>(dst);
+        return decodeStream(src, srcSize, count, INDEX_BLOCK,
+                            [&](uint8_t const* block, size_t blockSize, size_t first, size_t blockCount)
+        {
+            return decodeIndexBlock(block, blockSize, out + first * indexStride(indexType), blockCount,
+                                    indexType, vertexCount);
+        });
+    }
+
+    bool write(std::string const& file, MeshData const& mesh)
+    {
+        auto vertices = encodeVertices(mesh.vertexData(), mesh.vertexCount(), vertexStride(mesh.vertexFormat));
+        auto indices = encodeIndices(mesh.indexData(), mesh.indexCount(), mesh.indexType);
+        size_t meshletSize = mesh.meshlets.size() * sizeof(MeshOptimizer::Meshlet);
+        size_t lodSize = mesh.lods.size() * sizeof(MeshOptimizer::LodLevel);
+
+        // a cache file layout whose vertex and index blocks hold encoded streams
+        MeshCache::Header hdr = {};
+        hdr.magic = MeshCache::COMPRESSED_MAGIC;
+        hdr.version = MeshCache::CACHE_VERSION;
+        hdr.vertexFormat = mesh.vertexFormat;
+        hdr.indexType = mesh.indexType;
+        hdr.vertexCount = mesh.vertexCount();
+        hdr.vertexOffset = alignUp(sizeof(MeshCache::Header));
+        hdr.indexCount = mesh.indexCount();
+        hdr.indexOffset = alignUp(hdr.vertexOffset + vertices.size());
+        hdr.meshletCount = mesh.meshlets.size();
+        hdr.meshletOffset = alignUp(hdr.indexOffset + indices.size());
+        hdr.lodCount = mesh.lods.size();
+        hdr.lodOffset = alignUp(hdr.meshletOffset + meshletSize);
+        hdr.boundsMin = mesh.boundsMin;
+        hdr.boundsMax = mesh.boundsMax;
+
+        std::string tmpFile = file + ".tmp";
+        {
+            std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                return false;
+            }
+
+            char const padding[MeshCache::BLOCK_ALIGNMENT] = {};
+            auto writeBlock = [&](void const* data, size_t size, uint64_t offset, uint64_t nextOffset)
+            {
+                out.write(reinterpret_cast<char const*>(data), static_cast<std::streamsize>(size));
+                out.write(padding, static_cast<std::streamsize>(nextOffset - offset - size));
+            };
+
+            writeBlock(&hdr, sizeof(MeshCache::Header), 0, hdr.vertexOffset);
+            writeBlock(vertices.data(), vertices.size(), hdr.vertexOffset, hdr.indexOffset);
+            writeBlock(indices.data(), indices.size(), hdr.indexOffset, hdr.meshletOffset);
+            writeBlock(mesh.meshlets.data(), meshletSize, hdr.meshletOffset, hdr.lodOffset);
+            writeBlock(mesh.lods.data(), lodSize, hdr.lodOffset, hdr.lodOffset + lodSize);
+
+            if (!out)
+            {
+                out.close();
+                std::filesystem::remove(tmpFile);
+                return false;
+            }
+        }
+
+        std::error_code err;
+        std::filesystem::rename(tmpFile, file, err);
+        if (err)
+        {
+            std::filesystem::remove(tmpFile, err);
+            return false;
+        }
+        return true;
+    }
+}
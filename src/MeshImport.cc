@@ -0,0 +1,503 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "MeshImport.h"
+#include "ObjParser.h"
+#include "GltfParser.h"
+#include "MeshNormals.h"
+#include "ThreadPool.h"
+#include "helpers.h"
+
+namespace
+{
+    void buildVertices(ObjParser::ObjData const& obj, MeshData& mesh, ThreadPool* pool)
+    {
+        mesh.verts.resize(obj.corners.size());
+        mesh.indices.resize(obj.corners.size());
+
+        auto buildRange = [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto const& corner = obj.corners[i];
+                if (corner.pos >= obj.positions.size())
+                {
+                    throw std::runtime_error("OBJ face references a missing vertex!");
+                }
+
+                auto& vert = mesh.verts[i];
+                vert.pos = obj.positions[corner.pos];
+                vert.normal = corner.normal < obj.normals.size() ? obj.normals[corner.normal] : glm::vec3(0.f);
+                // OBJ texture space has v pointing up, Vulkan samples top-down
+                vert.texCoord = corner.tex < obj.texCoords.size() ?
+                        glm::vec2(obj.texCoords[corner.tex].x, 1.f - obj.texCoords[corner.tex].y) :
+                        glm::vec2(0.f);
+
+                mesh.indices[i] = static_cast<uint32_t>(i);
+            }
+        };
+
+        if (pool)
+        {
+            pool->parallelFor(obj.corners.size(), buildRange, 1 << 16);
+        }
+        else
+        {
+            buildRange(0, obj.corners.size());
+        }
+    }
+
+    // appends coarser index ranges after the full resolution one
+    void buildLods(MeshData& mesh, MeshImportOptions const& options)
+    {
+        auto fullCount = static_cast<uint32_t>(mesh.indices.size());
+        mesh.lods.push_back({0, fullCount, 0.f});
+
+        float maxError = options.lodMaxError * glm::length(mesh.boundsMax - mesh.boundsMin);
+        std::vector<uint32_t> previous(mesh.indices);
+        float error = 0.f;
+
+        for (uint32_t level = 1; level < options.lodLevels; ++level)
+        {
+            auto target = static_cast<size_t>(static_cast<float>(previous.size() / 3) * options.lodReduction) * 3;
+            float levelError = 0.f;
+            auto simplified = MeshOptimizer::simplify(
+                    previous.data(), previous.size(), mesh.verts, target, maxError - error, &levelError);
+
+            // not worth another index range
+            if (simplified.empty() || simplified.size() * 10 > previous.size() * 9)
+            {
+                break;
+            }
+
+            MeshOptimizer::optimizeVertexCache(simplified, mesh.verts.size());
+            // errors of successive simplifications add up at worst
+            error += levelError;
+            mesh.lods.push_back({static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(simplified.size()), error});
+            mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.end());
+            previous.swap(simplified);
+        }
+    }
+
+    // everything after the vertices and indices are known, shared by all importers
+    void process(MeshData& mesh, MeshImportOptions const& options, ThreadPool* pool)
+    {
+        if (options.weldVertices)
+        {
+            MeshOptimizer::weldVertices(mesh.verts, mesh.indices, pool);
+        }
+
+        if (options.generateNormals)
+        {
+            MeshNormals::generateNormals(mesh.verts, mesh.indices, pool);
+        }
+
+        if (options.optimizeVertexCache)
+        {
+            auto& stats = mesh.cacheStats;
+            stats.acmrBefore = MeshOptimizer::computeACMR(
+                    mesh.indices.data(), mesh.indices.size(), mesh.verts.size());
+            MeshOptimizer::optimizeVertexCache(mesh.indices, mesh.verts.size());
+            if (options.optimizeOverdraw)
+            {
+                MeshOptimizer::optimizeOverdraw(mesh.indices, mesh.verts, options.overdrawThreshold);
+            }
+            MeshOptimizer::optimizeVertexFetch(mesh.verts, mesh.indices);
+            stats.acmrAfter = MeshOptimizer::computeACMR(
+                    mesh.indices.data(), mesh.indices.size(), mesh.verts.size());
+        }
+
+        if (options.buildMeshlets)
+        {
+            mesh.meshlets = MeshOptimizer::buildMeshlets(
+                    mesh.indices, mesh.verts, options.meshletMaxVertices, options.meshletMaxTriangles);
+        }
+
+        // vertices are in their final order; LOD ranges must not count as surface yet
+        if (options.generateTangents)
+        {
+            mesh.tangents = MeshNormals::generateTangents(mesh.verts, mesh.indices, pool);
+        }
+
+        mesh.computeBounds();
+        if (options.lodLevels > 1)
+        {
+            buildLods(mesh, options);
+        }
+
+        if (options.vertexFormat == QUANTIZED_VERTEX)
+        {
+            mesh.vertexFormat = QUANTIZED_VERTEX;
+            mesh.qverts.resize(mesh.verts.size());
+            for (size_t i = 0; i < mesh.verts.size(); ++i)
+            {
+                mesh.qverts[i] = QVertex::quantize(mesh.verts[i], mesh.boundsMin, mesh.boundsMax);
+            }
+            mesh.verts = {};
+        }
+
+        // every level and meshlet shares the vertex array, so one index type fits all of them
+        if (mesh.vertexCount() <= std::numeric_limits<uint16_t>::max() + size_t(1))
+        {
+            mesh.indexType = VK_INDEX_TYPE_UINT16;
+            mesh.indices16.assign(mesh.indices.begin(), mesh.indices.end());
+            mesh.indices = {};
+        }
+    }
+
+    // reads element i of a float or normalized integer accessor; missing components stay 0
+    void readFloats(GltfParser::GlbData const& glb, GltfParser::Accessor const& accessor, size_t i, float* out)
+    {
+        auto const* p = glb.elementData(accessor);
+        if (!p)
+        {
+            return;
+        }
+        p += i * glb.elementStride(accessor);
+
+        for (uint32_t c = 0; c < accessor.components; ++c)
+        {
+            switch (accessor.componentType)
+            {
+                case GltfParser::FLOAT:
+                    memcpy(&out[c], p + c * sizeof(float), sizeof(float));
+                    break;
+                case GltfParser::UNSIGNED_BYTE:
+                    out[c] = accessor.normalized ? p[c] / 255.f : p[c];
+                    break;
+                case GltfParser::BYTE:
+                {
+                    auto v = static_cast<float>(static_cast<int8_t>(p[c]));
+                    out[c] = accessor.normalized ? std::max(v / 127.f, -1.f) : v;
+                    break;
+                }
+                case GltfParser::UNSIGNED_SHORT:
+                {
+                    uint16_t v;
+                    memcpy(&v, p + c * sizeof(uint16_t), sizeof(uint16_t));
+                    out[c] = accessor.normalized ? v / 65535.f : v;
+                    break;
+                }
+                case GltfParser::SHORT:
+                {
+                    int16_t v;
+                    memcpy(&v, p + c * sizeof(int16_t), sizeof(int16_t));
+                    out[c] = accessor.normalized ? std::max(v / 32767.f, -1.f) : v;
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Unsupported glTF vertex attribute format!");
+            }
+        }
+    }
+
+    uint32_t readIndex(GltfParser::GlbData const& glb, GltfParser::Accessor const& accessor, size_t i)
+    {
+        auto const* p = glb.elementData(accessor);
+        if (!p)
+        {
+            return 0;
+        }
+        p += i * glb.elementStride(accessor);
+
+        switch (accessor.componentType)
+        {
+            case GltfParser::UNSIGNED_BYTE:
+                return *p;
+            case GltfParser::UNSIGNED_SHORT:
+            {
+                uint16_t v;
+                memcpy(&v, p, sizeof(uint16_t));
+                return v;
+            }
+            default:
+            {
+                uint32_t v;
+                memcpy(&v, p, sizeof(uint32_t));
+                return v;
+            }
+        }
+    }
+
+    // the conversion pass: appends one placed primitive to the (float) vertex and index arrays
+    void appendPrimitive(GltfParser::GlbData const& glb, GltfParser::Primitive const& prim, MeshData& mesh)
+    {
+        auto const& position = glb.accessors[prim.position];
+        size_t base = mesh.verts.size();
+        if (base + position.count > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::runtime_error("glTF file has too many vertices!");
+        }
+
+        glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(prim.transform)));
+        mesh.verts.resize(base + position.count);
+        for (size_t i = 0; i < position.count; ++i)
+        {
+            auto& vert = mesh.verts[base + i];
+            vert = {};
+            readFloats(glb, position, i, &vert.pos.x);
+            if (prim.normal != GltfParser::NO_INDEX)
+            {
+                readFloats(glb, glb.accessors[prim.normal], i, &vert.normal.x);
+            }
+            // glTF texture space already has v pointing down
+            if (prim.texCoord != GltfParser::NO_INDEX)
+            {
+                readFloats(glb, glb.accessors[prim.texCoord], i, &vert.texCoord.x);
+            }
+
+            if (!prim.identityTransform)
+            {
+                vert.pos = glm::vec3(prim.transform * glm::vec4(vert.pos, 1.f));
+                if (glm::dot(vert.normal, vert.normal) > 0.f)
+                {
+                    vert.normal = glm::normalize(normalMatrix * vert.normal);
+                }
+            }
+        }
+
+        if (prim.indices == GltfParser::NO_INDEX)
+        {
+            for (size_t i = 0; i + 2 < position.count; i += 3)
+            {
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    mesh.indices.push_back(static_cast<uint32_t>(base + i + c));
+                }
+            }
+            return;
+        }
+
+        auto const& indices = glb.accessors[prim.indices];
+        size_t indexCount = indices.count / 3 * 3;
+        mesh.indices.reserve(mesh.indices.size() + indexCount);
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            uint32_t index = readIndex(glb, indices, i);
+            if (index >= position.count)
+            {
+                throw std::runtime_error("glTF primitive references a missing vertex!");
+            }
+            mesh.indices.push_back(static_cast<uint32_t>(base + index));
+        }
+    }
+
+    /*
+     * Leaves the vertices and indices in the mapped file when no processing is requested
+     * and the single primitive is already stored as interleaved NVertex and 16/32-bit
+     * indices; the fast path for files exported with a matching layout.
+     */
+    bool borrowGlb(GltfParser::GlbData const& glb, MeshData& mesh, MeshImportOptions const& options)
+    {
+        bool processing = options.weldVertices || options.optimizeVertexCache || options.buildMeshlets ||
+                          options.lodLevels > 1 || options.vertexFormat != FLOAT_VERTEX || options.generateTangents;
+        if (processing || glb.primitives.size() != 1)
+        {
+            return false;
+        }
+
+        auto const& prim = glb.primitives[0];
+        if (!prim.identityTransform || prim.normal == GltfParser::NO_INDEX ||
+            prim.texCoord == GltfParser::NO_INDEX || prim.indices == GltfParser::NO_INDEX)
+        {
+            return false;
+        }
+
+        auto const& pos = glb.accessors[prim.position];
+        auto const& normal = glb.accessors[prim.normal];
+        auto const& texCoord = glb.accessors[prim.texCoord];
+        auto const& indices = glb.accessors[prim.indices];
+
+        // one buffer view with NVertex as its element
+        auto const* base = glb.elementData(pos);
+        bool interleaved = base && pos.bufferView == normal.bufferView && pos.bufferView == texCoord.bufferView &&
+                glb.elementStride(pos) == sizeof(NVertex) &&
+                pos.componentType == GltfParser::FLOAT && normal.componentType == GltfParser::FLOAT &&
+                texCoord.componentType == GltfParser::FLOAT &&
+                glb.elementData(normal) == base + offsetof(NVertex, normal) &&
+                glb.elementData(texCoord) == base + offsetof(NVertex, texCoord);
+
+        bool packedIndices = glb.elementData(indices) &&
+                (indices.componentType == GltfParser::UNSIGNED_SHORT || indices.componentType == GltfParser::UNSIGNED_INT) &&
+                glb.elementStride(indices) == GltfParser::componentSize(indices.componentType) &&
+                indices.count % 3 == 0;
+
+        // culling needs bounds, which are otherwise computed from the converted vertices
+        if (!interleaved || !packedIndices || !pos.hasBounds)
+        {
+            return false;
+        }
+
+        // out of range indices would read past the vertex buffer on the GPU
+        for (size_t i = 0; i < indices.count; ++i)
+        {
+            if (readIndex(glb, indices, i) >= pos.count)
+            {
+                return false;
+            }
+        }
+
+        mesh.borrowed.vertices = base;
+        mesh.borrowed.vertexCount = pos.count;
+        mesh.borrowed.indices = glb.elementData(indices);
+        mesh.borrowed.indexCount = indices.count;
+        mesh.indexType = indices.componentType == GltfParser::UNSIGNED_SHORT ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        mesh.boundsMin = pos.min;
+        mesh.boundsMax = pos.max;
+        return true;
+    }
+}
+
+namespace
+{
+    // lower case, with the dot; empty if there is none
+    std::string fileExtension(std::string const& fileName)
+    {
+        auto dot = fileName.find_last_of('.');
+        std::string ext = dot == std::string::npos ? std::string() : fileName.substr(dot);
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        return ext;
+    }
+}
+
+uint64_t MeshImportOptions::cacheKey() const
+{
+    // parallelImport is left out on purpose: it does not change the result; neither does
+    // generateTangents change what is cached
+    uint64_t key = helpers::hashBytes(&weldVertices, sizeof(bool));
+    key = helpers::hashBytes(&generateNormals, sizeof(bool), key);
+    key = helpers::hashBytes(&vertexFormat, sizeof(VertexFormat), key);
+    key = helpers::hashBytes(&optimizeVertexCache, sizeof(bool), key);
+    if (optimizeVertexCache && optimizeOverdraw)
+    {
+        key = helpers::hashBytes(&overdrawThreshold, sizeof(float), key);
+    }
+    if (buildMeshlets)
+    {
+        uint32_t limits[2] = {meshletMaxVertices, meshletMaxTriangles};
+        key = helpers::hashBytes(limits, sizeof(limits), key);
+    }
+    if (lodLevels > 1)
+    {
+        float lodParams[3] = {static_cast<float>(lodLevels), lodReduction, lodMaxError};
+        key = helpers::hashBytes(lodParams, sizeof(lodParams), key);
+    }
+    return key;
+}
+
+bool MeshImportOptions::streams(std::string const& fileName, uint64_t fileSize) const
+{
+    return streamImportBytes > 0 && fileSize >= streamImportBytes && fileExtension(fileName) == ".obj";
+}
+
+MeshImportOptions MeshImportOptions::streamedOptions() const
+{
+    MeshImportOptions streamed = *this;
+    streamed.weldVertices = false;
+    streamed.generateNormals = false;
+    streamed.generateTangents = false;
+    streamed.optimizeVertexCache = false;
+    streamed.optimizeOverdraw = false;
+    streamed.buildMeshlets = false;
+    streamed.lodLevels = 1;
+    return streamed;
+}
+
+void MeshData::computeBounds()
+{
+    if (verts.empty())
+    {
+        return;
+    }
+
+    boundsMin = boundsMax = verts[0].pos;
+    for (auto const& vert : verts)
+    {
+        boundsMin = glm::min(boundsMin, vert.pos);
+        boundsMax = glm::max(boundsMax, vert.pos);
+    }
+}
+
+size_t MeshData::vertexCount() const
+{
+    if (borrowed.vertices)
+    {
+        return borrowed.vertexCount;
+    }
+    return vertexFormat == QUANTIZED_VERTEX ? qverts.size() : verts.size();
+}
+
+void const* MeshData::vertexData() const
+{
+    if (borrowed.vertices)
+    {
+        return borrowed.vertices;
+    }
+    return vertexFormat == QUANTIZED_VERTEX ? static_cast<void const*>(qverts.data()) : verts.data();
+}
+
+size_t MeshData::indexCount() const
+{
+    if (borrowed.indices)
+    {
+        return borrowed.indexCount;
+    }
+    return indexType == VK_INDEX_TYPE_UINT16 ? indices16.size() : indices.size();
+}
+
+void const* MeshData::indexData() const
+{
+    if (borrowed.indices)
+    {
+        return borrowed.indices;
+    }
+    return indexType == VK_INDEX_TYPE_UINT16 ? static_cast<void const*>(indices16.data()) : indices.data();
+}
+
+namespace MeshImport
+{
+    MeshData importObj(uint8_t const* data, size_t size, MeshImportOptions const& options)
+    {
+        auto const* text = reinterpret_cast<char const*>(data);
+        ThreadPool* pool = options.parallelImport ? &ThreadPool::shared() : nullptr;
+
+        MeshData mesh;
+        if (pool)
+        {
+            buildVertices(ObjParser::parseParallel(text, text + size, *pool), mesh, pool);
+        }
+        else
+        {
+            buildVertices(ObjParser::parse(text, text + size), mesh, nullptr);
+        }
+
+        process(mesh, options, pool);
+        return mesh;
+    }
+
+    MeshData importGlb(uint8_t const* data, size_t size, MeshImportOptions const& options)
+    {
+        auto glb = GltfParser::parse(data, size);
+        ThreadPool* pool = options.parallelImport ? &ThreadPool::shared() : nullptr;
+
+        MeshData mesh;
+        if (borrowGlb(glb, mesh, options))
+        {
+            return mesh;
+        }
+
+        for (auto const& prim : glb.primitives)
+        {
+            appendPrimitive(glb, prim, mesh);
+        }
+        process(mesh, options, pool);
+        return mesh;
+    }
+
+    MeshData import(
+            uint8_t const* data, size_t size, std::string const& fileName, MeshImportOptions const& options)
+    {
+        return fileExtension(fileName) == ".glb" ? importGlb(data, size, options) : importObj(data, size, options);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "MeshNormals.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+
+namespace MeshNormals
+{
+    namespace
+    {
+        constexpr size_t MIN_RANGE = 1 << 14;
+
+        void forRanges(ThreadPool* pool, size_t count, std::function<void(size_t, size_t)> const& fn)
+        {
+            if (pool)
+            {
+                pool->parallelFor(count, fn, MIN_RANGE);
+            }
+            else
+            {
+                fn(0, count);
+            }
+        }
+
+        /*
+         * Triangles around each key in compressed sparse row form: the triangles of key k are
+         * triangles[offsets[k], offsets[k + 1]), in ascending order.
+         */
+        struct Adjacency
+        {
+            std::vector<size_t> offsets;
+            std::vector<uint32_t> triangles;
+        };
+
+        /**
+         * Counts corners per key with atomic increments, turns the counts into offsets and
+         * fills the lists the same way. Lists are sorted afterwards, so sums over them come
+         * out bit-identical whatever order the fill ran in.
+         * @param keyOf maps a vertex index to a key below keyCount
+         */
+        template<typename KeyFn>
+        Adjacency buildAdjacency(
+                std::vector<uint32_t> const& indices, size_t keyCount, KeyFn const& keyOf, ThreadPool* pool)
+        {
+            size_t cornerCount = indices.size() / 3 * 3;
+            std::unique_ptr<std::atomic<uint32_t>[]> counts(new std::atomic<uint32_t>[keyCount]());
+            forRanges(pool, cornerCount, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    counts[keyOf(indices[i])].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+
+            Adjacency adjacency;
+            adjacency.offsets.resize(keyCount + 1);
+            size_t offset = 0;
+            for (size_t key = 0; key < keyCount; ++key)
+            {
+                adjacency.offsets[key] = offset;
+                offset += counts[key].load(std::memory_order_relaxed);
+                counts[key].store(0, std::memory_order_relaxed);
+            }
+            adjacency.offsets[keyCount] = offset;
+
+            adjacency.triangles.resize(offset);
+            forRanges(pool, cornerCount, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    size_t key = keyOf(indices[i]);
+                    size_t slot = adjacency.offsets[key] + counts[key].fetch_add(1, std::memory_order_relaxed);
+                    adjacency.triangles[slot] = static_cast<uint32_t>(i / 3);
+                }
+            });
+
+            forRanges(pool, keyCount, [&](size_t begin, size_t end)
+            {
+                auto first = adjacency.triangles.begin();
+                for (size_t key = begin; key < end; ++key)
+                {
+                    std::sort(first + static_cast<ptrdiff_t>(adjacency.offsets[key]),
+                              first + static_cast<ptrdiff_t>(adjacency.offsets[key + 1]));
+                }
+            });
+            return adjacency;
+        }
+
+        // any unit vector perpendicular to n
+        glm::vec3 perpendicular(glm::vec3 const& n)
+        {
+            glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.f, 0.f, 0.f) : glm::vec3(0.f, 1.f, 0.f);
+            glm::vec3 t = glm::cross(n, axis);
+            float length = glm::length(t);
+            return length > 0.f ? t / length : glm::vec3(1.f, 0.f, 0.f);
+        }
+    }
+
+    size_t generateNormals(std::vector<NVertex>& verts, std::vector<uint32_t> const& indices, ThreadPool* pool)
+    {
+        std::atomic<size_t> missing(0);
+        forRanges(pool, verts.size(), [&](size_t begin, size_t end)
+        {
+            size_t count = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                count += verts[i].normal == glm::vec3(0.f);
+            }
+            missing.fetch_add(count, std::memory_order_relaxed);
+        });
+        if (missing == 0)
+        {
+            return 0;
+        }
+
+        // the cross product of two edges is twice the triangle's area long: area weighting for free
+        size_t triCount = indices.size() / 3;
+        std::vector<glm::vec3> faceNormals(triCount);
+        forRanges(pool, triCount, [&](size_t begin, size_t end)
+        {
+            for (size_t t = begin; t < end; ++t)
+            {
+                glm::vec3 const& p0 = verts[indices[3 * t]].pos;
+                faceNormals[t] = glm::cross(verts[indices[3 * t + 1]].pos - p0, verts[indices[3 * t + 2]].pos - p0);
+            }
+        });
+
+        auto remap = MeshOptimizer::positionRemap(verts, pool);
+        auto adjacency = buildAdjacency(indices, verts.size(), [&](uint32_t v) { return remap[v]; }, pool);
+
+        // only the first vertex of each position gathers; the others copy from it below
+        std::vector<glm::vec3> positionNormals(verts.size());
+        forRanges(pool, verts.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+            {
+                glm::vec3 sum(0.f);
+                for (size_t i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i)
+                {
+                    sum += faceNormals[adjacency.triangles[i]];
+                }
+                // isolated or only degenerate triangles around: nothing to average
+                float length = glm::length(sum);
+                positionNormals[v] = length > 0.f ? sum / length : glm::vec3(0.f);
+            }
+        });
+
+        forRanges(pool, verts.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+            {
+                if (verts[v].normal == glm::vec3(0.f))
+                {
+                    verts[v].normal = positionNormals[remap[v]];
+                }
+            }
+        });
+        return missing;
+    }
+
+    std::vector<glm::vec4> generateTangents(
+            std::vector<NVertex> const& verts, std::vector<uint32_t> const& indices, ThreadPool* pool)
+    {
+        bool hasTexCoords = std::any_of(verts.begin(), verts.end(), [](NVertex const& vert)
+        {
+            return vert.texCoord != glm::vec2(0.f);
+        });
+        if (!hasTexCoords)
+        {
+            return {};
+        }
+
+        // directions of increasing u and v on each triangle, scaled by its area
+        size_t triCount = indices.size() / 3;
+        std::vector<glm::vec3> faceTangents(triCount);
+        std::vector<glm::vec3> faceBitangents(triCount);
+        forRanges(pool, triCount, [&](size_t begin, size_t end)
+        {
+            for (size_t t = begin; t < end; ++t)
+            {
+                auto const& v0 = verts[indices[3 * t]];
+                auto const& v1 = verts[indices[3 * t + 1]];
+                auto const& v2 = verts[indices[3 * t + 2]];
+                glm::vec3 e1 = v1.pos - v0.pos;
+                glm::vec3 e2 = v2.pos - v0.pos;
+                glm::vec2 d1 = v1.texCoord - v0.texCoord;
+                glm::vec2 d2 = v2.texCoord - v0.texCoord;
+
+                float det = d1.x * d2.y - d2.x * d1.y;
+                float area = glm::length(glm::cross(e1, e2));
+                if (det == 0.f || area == 0.f)
+                {
+                    faceTangents[t] = faceBitangents[t] = glm::vec3(0.f);
+                    continue;
+                }
+
+                glm::vec3 tangent = (e1 * d2.y - e2 * d1.y) / det;
+                glm::vec3 bitangent = (e2 * d1.x - e1 * d2.x) / det;
+                float tangentLength = glm::length(tangent);
+                float bitangentLength = glm::length(bitangent);
+                faceTangents[t] = tangentLength > 0.f ? tangent * (area / tangentLength) : glm::vec3(0.f);
+                faceBitangents[t] = bitangentLength > 0.f ? bitangent * (area / bitangentLength) : glm::vec3(0.f);
+            }
+        });
+
+        // per vertex rather than per position: UV seams are where tangent frames may differ
+        auto adjacency = buildAdjacency(indices, verts.size(), [](uint32_t v) { return v; }, pool);
+
+        std::vector<glm::vec4> tangents(verts.size());
+        forRanges(pool, verts.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+            {
+                glm::vec3 tangent(0.f), bitangent(0.f);
+                for (size_t i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i)
+                {
+                    tangent += faceTangents[adjacency.triangles[i]];
+                    bitangent += faceBitangents[adjacency.triangles[i]];
+                }
+
+                // Gram-Schmidt against the normal
+                glm::vec3 const& n = verts[v].normal;
+                tangent -= n * glm::dot(n, tangent);
+                float length = glm::length(tangent);
+                tangent = length > 0.f ? tangent / length : perpendicular(n);
+                float sign = glm::dot(glm::cross(n, tangent), bitangent) < 0.f ? -1.f : 1.f;
+                tangents[v] = glm::vec4(tangent, sign);
+            }
+        });
+        return tangents;
+    }
+}
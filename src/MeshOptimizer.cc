@@ -0,0 +1,881 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include "helpers.h"
+
+namespace MeshOptimizer
+{
+    namespace
+    {
+        constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+
+        size_t tableSizeFor(size_t count)
+        {
+            size_t size = 16;
+            while (size < count * 2)
+            {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        // vertex -> adjacent triangle lists in compressed (CSR) form
+        struct TriangleAdjacency
+        {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> triangles;
+
+            TriangleAdjacency(uint32_t const* indices, size_t indexCount, size_t vertexCount) :
+                    offsets(vertexCount + 1, 0), triangles(indexCount)
+            {
+                for (size_t i = 0; i < indexCount; ++i)
+                {
+                    ++offsets[indices[i] + 1];
+                }
+                for (size_t v = 0; v < vertexCount; ++v)
+                {
+                    offsets[v + 1] += offsets[v];
+                }
+
+                std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                for (size_t i = 0; i < indexCount; ++i)
+                {
+                    triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+                }
+            }
+
+            [[nodiscard]]
+            uint32_t count(uint32_t vertex) const
+            {
+                return offsets[vertex + 1] - offsets[vertex];
+            }
+        };
+
+        // FIFO post-transform cache simulation, in the same form as computeACMR
+        struct FifoCache
+        {
+            std::vector<size_t> pushedAt;
+            size_t pushes = 0;
+            uint32_t cacheSize;
+
+            FifoCache(size_t vertexCount, uint32_t cacheSize) : pushedAt(vertexCount, 0), cacheSize(cacheSize)
+            {
+            }
+
+            uint32_t access(uint32_t vertex)
+            {
+                if (pushedAt[vertex] == 0 || pushes - pushedAt[vertex] >= cacheSize)
+                {
+                    pushedAt[vertex] = ++pushes;
+                    return 1;
+                }
+                return 0;
+            }
+
+            uint32_t accessTriangle(uint32_t const* tri)
+            {
+                return access(tri[0]) + access(tri[1]) + access(tri[2]);
+            }
+
+            void flush()
+            {
+                pushes += cacheSize;
+            }
+        };
+
+        // symmetric 4x4 plane quadric, in double to survive large accumulated weights
+        struct Quadric
+        {
+            double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+            double b0 = 0, b1 = 0, b2 = 0, c = 0;
+            double weight = 0;
+
+            static Quadric fromPlane(glm::vec3 const& n, double d, double weight)
+            {
+                Quadric q;
+                q.a00 = weight * n.x * n.x;
+                q.a01 = weight * n.x * n.y;
+                q.a02 = weight * n.x * n.z;
+                q.a11 = weight * n.y * n.y;
+                q.a12 = weight * n.y * n.z;
+                q.a22 = weight * n.z * n.z;
+                q.b0 = weight * n.x * d;
+                q.b1 = weight * n.y * d;
+                q.b2 = weight * n.z * d;
+                q.c = weight * d * d;
+                q.weight = weight;
+                return q;
+            }
+
+            Quadric& operator+=(Quadric const& o)
+            {
+                a00 += o.a00; a01 += o.a01; a02 += o.a02; a11 += o.a11; a12 += o.a12; a22 += o.a22;
+                b0 += o.b0; b1 += o.b1; b2 += o.b2; c += o.c;
+                weight += o.weight;
+                return *this;
+            }
+
+            // weighted mean squared distance of p to the accumulated planes
+            [[nodiscard]]
+            double error(Quadric const& o, glm::vec3 const& p) const
+            {
+                double x = p.x, y = p.y, z = p.z;
+                double sum =
+                        (a00 + o.a00) * x * x + (a11 + o.a11) * y * y + (a22 + o.a22) * z * z +
+                        2 * ((a01 + o.a01) * x * y + (a02 + o.a02) * x * z + (a12 + o.a12) * y * z) +
+                        2 * ((b0 + o.b0) * x + (b1 + o.b1) * y + (b2 + o.b2) * z) + (c + o.c);
+                double totalWeight = weight + o.weight;
+                return totalWeight > 0 ? std::max(sum, 0.0) / totalWeight : 0.0;
+            }
+        };
+
+        struct Collapse
+        {
+            uint32_t from;
+            uint32_t to;
+            double cost;
+        };
+
+        // Ritter's approximate bounding sphere
+        void boundingSphere(std::vector<glm::vec3> const& points, glm::vec3& center, float& radius)
+        {
+            size_t minIdx[3] = {0, 0, 0}, maxIdx[3] = {0, 0, 0};
+            for (size_t i = 1; i < points.size(); ++i)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    if (points[i][axis] < points[minIdx[axis]][axis])
+                    {
+                        minIdx[axis] = i;
+                    }
+                    if (points[i][axis] > points[maxIdx[axis]][axis])
+                    {
+                        maxIdx[axis] = i;
+                    }
+                }
+            }
+
+            int widest = 0;
+            float widestDist = -1.f;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                float dist = glm::distance(points[minIdx[axis]], points[maxIdx[axis]]);
+                if (dist > widestDist)
+                {
+                    widestDist = dist;
+                    widest = axis;
+                }
+            }
+
+            center = (points[minIdx[widest]] + points[maxIdx[widest]]) * 0.5f;
+            radius = widestDist * 0.5f;
+
+            for (auto const& point : points)
+            {
+                float dist = glm::distance(point, center);
+                if (dist > radius)
+                {
+                    float grown = (radius + dist) * 0.5f;
+                    center += (point - center) * ((grown - radius) / dist);
+                    radius = grown;
+                }
+            }
+        }
+
+        void computeMeshletBounds(
+                MeshOptimizer::Meshlet& meshlet, uint32_t const* indices, std::vector<NVertex> const& verts,
+                std::vector<glm::vec3>& points)
+        {
+            points.clear();
+            glm::vec3 normalSum(0.f);
+            for (uint32_t i = 0; i < meshlet.indexCount; i += 3)
+            {
+                glm::vec3 const& a = verts[indices[i]].pos;
+                glm::vec3 const& b = verts[indices[i + 1]].pos;
+                glm::vec3 const& c = verts[indices[i + 2]].pos;
+                points.insert(points.end(), {a, b, c});
+
+                glm::vec3 n = glm::cross(b - a, c - a);
+                float len = glm::length(n);
+                if (len > 0.f)
+                {
+                    normalSum += n / len;
+                }
+            }
+
+            boundingSphere(points, meshlet.center, meshlet.radius);
+
+            // a cutoff of 1 can never satisfy the cone test, i.e. the cluster is never culled
+            meshlet.coneAxis = glm::vec3(0.f, 0.f, 1.f);
+            meshlet.coneCutoff = 1.f;
+
+            float axisLength = glm::length(normalSum);
+            if (axisLength <= 0.f)
+            {
+                return;
+            }
+            glm::vec3 axis = normalSum / axisLength;
+
+            float minDot = 1.f;
+            for (uint32_t i = 0; i < meshlet.indexCount; i += 3)
+            {
+                glm::vec3 const& a = verts[indices[i]].pos;
+                glm::vec3 n = glm::cross(verts[indices[i + 1]].pos - a, verts[indices[i + 2]].pos - a);
+                float len = glm::length(n);
+                if (len > 0.f)
+                {
+                    minDot = std::min(minDot, glm::dot(axis, n / len));
+                }
+            }
+
+            // wider than a hemisphere: some triangle faces any given eye
+            if (minDot > 0.f)
+            {
+                meshlet.coneAxis = axis;
+                meshlet.coneCutoff = std::sqrt(1.f - minDot * minDot);
+            }
+        }
+    }
+
+    size_t weldVertices(std::vector<NVertex>& verts, std::vector<uint32_t>& indices, ThreadPool* pool)
+    {
+        size_t vertCount = verts.size();
+        if (vertCount == 0)
+        {
+            return 0;
+        }
+
+        std::vector<uint64_t> hashes(vertCount);
+        auto hashRange = [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                hashes[i] = helpers::hashBytes(&verts[i], sizeof(NVertex));
+            }
+        };
+
+        if (pool)
+        {
+            pool->parallelFor(vertCount, hashRange, 1 << 16);
+        }
+        else
+        {
+            hashRange(0, vertCount);
+        }
+
+        // open addressing on indices into the compacted array; no per-entry allocation
+        size_t tableSize = tableSizeFor(vertCount);
+        size_t mask = tableSize - 1;
+        std::vector<uint32_t> table(tableSize, EMPTY_SLOT);
+        std::vector<uint32_t> remap(vertCount);
+
+        uint32_t uniqueCount = 0;
+        for (size_t i = 0; i < vertCount; ++i)
+        {
+            size_t slot = hashes[i] & mask;
+            while (true)
+            {
+                uint32_t entry = table[slot];
+                if (entry == EMPTY_SLOT)
+                {
+                    table[slot] = uniqueCount;
+                    // compaction never overwrites an unvisited vertex since uniqueCount <= i
+                    verts[uniqueCount] = verts[i];
+                    hashes[uniqueCount] = hashes[i];
+                    remap[i] = uniqueCount++;
+                    break;
+                }
+                if (hashes[entry] == hashes[i] && memcmp(&verts[entry], &verts[i], sizeof(NVertex)) == 0)
+                {
+                    remap[i] = entry;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+
+        verts.resize(uniqueCount);
+        verts.shrink_to_fit();
+        for (auto& idx : indices)
+        {
+            idx = remap[idx];
+        }
+
+        return uniqueCount;
+    }
+
+    std::vector<uint32_t> positionRemap(std::vector<NVertex> const& verts, ThreadPool* pool)
+    {
+        std::vector<uint64_t> hashes(verts.size());
+        auto hashRange = [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                hashes[i] = helpers::hashBytes(&verts[i].pos, sizeof(glm::vec3));
+            }
+        };
+
+        if (pool)
+        {
+            pool->parallelFor(verts.size(), hashRange, 1 << 16);
+        }
+        else
+        {
+            hashRange(0, verts.size());
+        }
+
+        size_t mask = tableSizeFor(verts.size()) - 1;
+        std::vector<uint32_t> table(mask + 1, EMPTY_SLOT);
+        std::vector<uint32_t> remap(verts.size());
+
+        for (uint32_t i = 0; i < verts.size(); ++i)
+        {
+            size_t slot = hashes[i] & mask;
+            while (true)
+            {
+                uint32_t entry = table[slot];
+                if (entry == EMPTY_SLOT)
+                {
+                    table[slot] = remap[i] = i;
+                    break;
+                }
+                if (hashes[entry] == hashes[i] && memcmp(&verts[entry].pos, &verts[i].pos, sizeof(glm::vec3)) == 0)
+                {
+                    remap[i] = entry;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+        return remap;
+    }
+
+    float computeACMR(uint32_t const* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+    {
+        if (indexCount < 3)
+        {
+            return 0.f;
+        }
+
+        // a vertex is in the FIFO if it was pushed less than cacheSize pushes ago
+        std::vector<size_t> pushedAt(vertexCount, 0);
+        size_t pushes = 0;
+        size_t misses = 0;
+
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            uint32_t v = indices[i];
+            if (pushedAt[v] == 0 || pushes - pushedAt[v] >= cacheSize)
+            {
+                pushedAt[v] = ++pushes;
+                ++misses;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(indexCount / 3);
+    }
+
+    void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || vertexCount == 0)
+        {
+            return;
+        }
+
+        TriangleAdjacency adjacency(indices.data(), triangleCount * 3, vertexCount);
+
+        std::vector<uint32_t> liveTriangles(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            liveTriangles[v] = adjacency.count(v);
+        }
+
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEnd;
+        std::vector<uint32_t> candidates;
+        deadEnd.reserve(vertexCount);
+
+        std::vector<uint32_t> output;
+        output.reserve(triangleCount * 3);
+
+        uint32_t timestamp = cacheSize + 1;
+        uint32_t cursor = 0;
+        int64_t fanning = 0;
+
+        while (fanning >= 0)
+        {
+            auto current = static_cast<uint32_t>(fanning);
+            candidates.clear();
+
+            for (uint32_t j = adjacency.offsets[current]; j < adjacency.offsets[current + 1]; ++j)
+            {
+                uint32_t tri = adjacency.triangles[j];
+                if (emitted[tri])
+                {
+                    continue;
+                }
+
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    uint32_t v = indices[tri * 3 + k];
+                    output.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    --liveTriangles[v];
+
+                    if (timestamp - cacheTime[v] > cacheSize)
+                    {
+                        cacheTime[v] = timestamp++;
+                    }
+                }
+                emitted[tri] = true;
+            }
+
+            // best candidate: still has work and stays in cache after its fan is emitted
+            fanning = -1;
+            int64_t bestPriority = -1;
+            for (uint32_t v : candidates)
+            {
+                if (liveTriangles[v] == 0)
+                {
+                    continue;
+                }
+
+                int64_t priority = 0;
+                if (timestamp - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+                {
+                    priority = timestamp - cacheTime[v];
+                }
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    fanning = v;
+                }
+            }
+
+            if (fanning < 0)
+            {
+                // dead end: recently used vertices first, then scan forward for any live vertex
+                while (!deadEnd.empty())
+                {
+                    uint32_t v = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (liveTriangles[v] > 0)
+                    {
+                        fanning = v;
+                        break;
+                    }
+                }
+
+                while (fanning < 0 && cursor < vertexCount)
+                {
+                    if (liveTriangles[cursor] > 0)
+                    {
+                        fanning = cursor;
+                    }
+                    ++cursor;
+                }
+            }
+        }
+
+        indices.resize(output.size());
+        std::copy(output.begin(), output.end(), indices.begin());
+    }
+
+    void optimizeOverdraw(
+            std::vector<uint32_t>& indices, std::vector<NVertex> const& verts, float threshold, uint32_t cacheSize)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+        {
+            return;
+        }
+
+        // hard boundaries: triangles where the cache-ordered stream restarts (all three vertices miss)
+        std::vector<uint32_t> hardStarts = {0};
+        {
+            FifoCache cache(verts.size(), cacheSize);
+            cache.accessTriangle(indices.data());
+            for (uint32_t t = 1; t < triangleCount; ++t)
+            {
+                if (cache.accessTriangle(&indices[t * 3]) == 3)
+                {
+                    hardStarts.push_back(t);
+                }
+            }
+        }
+        hardStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+        // soft boundaries: split a hard cluster once its running ACMR is within threshold of the cluster's
+        std::vector<uint32_t> clusterStarts;
+        {
+            FifoCache cache(verts.size(), cacheSize);
+            for (size_t c = 0; c + 1 < hardStarts.size(); ++c)
+            {
+                uint32_t start = hardStarts[c], end = hardStarts[c + 1];
+
+                cache.flush();
+                uint32_t clusterMisses = 0;
+                for (uint32_t t = start; t < end; ++t)
+                {
+                    clusterMisses += cache.accessTriangle(&indices[t * 3]);
+                }
+                float clusterLimit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+                cache.flush();
+                uint32_t runningMisses = 0;
+                clusterStarts.push_back(start);
+                for (uint32_t t = start; t < end; ++t)
+                {
+                    runningMisses += cache.accessTriangle(&indices[t * 3]);
+                    uint32_t runningCount = t - clusterStarts.back() + 1;
+                    if (t + 1 < end && static_cast<float>(runningMisses) <= clusterLimit * runningCount)
+                    {
+                        clusterStarts.push_back(t + 1);
+                        runningMisses = 0;
+                        cache.flush();
+                    }
+                }
+            }
+        }
+        clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+        // occlusion potential: clusters far out along their own normal are likely to hide others
+        auto triangleNormal = [&](uint32_t t)
+        {
+            glm::vec3 const& a = verts[indices[t * 3]].pos;
+            glm::vec3 const& b = verts[indices[t * 3 + 1]].pos;
+            glm::vec3 const& c = verts[indices[t * 3 + 2]].pos;
+            // length is twice the triangle area, so sums are area weighted
+            return glm::cross(b - a, c - a);
+        };
+        auto triangleCentroid = [&](uint32_t t)
+        {
+            return (verts[indices[t * 3]].pos + verts[indices[t * 3 + 1]].pos + verts[indices[t * 3 + 2]].pos) / 3.f;
+        };
+
+        glm::vec3 meshCentroid(0.f);
+        float meshArea = 0.f;
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            float area = glm::length(triangleNormal(t));
+            meshCentroid += triangleCentroid(t) * area;
+            meshArea += area;
+        }
+        meshCentroid = meshArea > 0.f ? meshCentroid / meshArea : glm::vec3(0.f);
+
+        size_t clusterCount = clusterStarts.size() - 1;
+        std::vector<float> potential(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c)
+        {
+            glm::vec3 centroid(0.f), normal(0.f);
+            float area = 0.f;
+            for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+            {
+                glm::vec3 n = triangleNormal(t);
+                float triArea = glm::length(n);
+                centroid += triangleCentroid(t) * triArea;
+                normal += n;
+                area += triArea;
+            }
+
+            float normalLength = glm::length(normal);
+            potential[c] = area > 0.f && normalLength > 0.f ?
+                    glm::dot(centroid / area - meshCentroid, normal / normalLength) : 0.f;
+        }
+
+        std::vector<uint32_t> order(clusterCount);
+        for (uint32_t c = 0; c < clusterCount; ++c)
+        {
+            order[c] = c;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+        {
+            return potential[a] > potential[b];
+        });
+
+        std::vector<uint32_t> sorted;
+        sorted.reserve(triangleCount * 3);
+        for (uint32_t c : order)
+        {
+            sorted.insert(sorted.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+        }
+        indices.swap(sorted);
+    }
+
+    std::vector<Meshlet> buildMeshlets(
+            std::vector<uint32_t> const& indices, std::vector<NVertex> const& verts,
+            uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        std::vector<Meshlet> meshlets;
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+        {
+            return meshlets;
+        }
+
+        // lastMeshlet[v] == meshlets.size() marks v as already counted in the open meshlet
+        std::vector<uint32_t> lastMeshlet(verts.size(), EMPTY_SLOT);
+        std::vector<glm::vec3> points;
+
+        Meshlet current = {};
+        uint32_t currentVertices = 0;
+
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            auto meshletIdx = static_cast<uint32_t>(meshlets.size());
+            uint32_t const* tri = &indices[t * 3];
+
+            uint32_t newVertices = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                newVertices += lastMeshlet[tri[k]] != meshletIdx &&
+                        (k < 1 || tri[k] != tri[0]) && (k < 2 || tri[k] != tri[1]);
+            }
+
+            if (current.indexCount / 3 + 1 > maxTriangles || currentVertices + newVertices > maxVertices)
+            {
+                computeMeshletBounds(current, &indices[current.firstIndex], verts, points);
+                meshlets.push_back(current);
+
+                current = {};
+                current.firstIndex = t * 3;
+                currentVertices = 0;
+                meshletIdx = static_cast<uint32_t>(meshlets.size());
+            }
+
+            for (int k = 0; k < 3; ++k)
+            {
+                if (lastMeshlet[tri[k]] != meshletIdx)
+                {
+                    lastMeshlet[tri[k]] = meshletIdx;
+                    ++currentVertices;
+                }
+            }
+            current.indexCount += 3;
+        }
+
+        computeMeshletBounds(current, &indices[current.firstIndex], verts, points);
+        meshlets.push_back(current);
+        return meshlets;
+    }
+
+    std::vector<uint32_t> simplify(
+            uint32_t const* indices, size_t indexCount, std::vector<NVertex> const& verts,
+            size_t targetIndexCount, float targetError, float* resultError)
+    {
+        std::vector<uint32_t> result(indices, indices + indexCount - indexCount % 3);
+        if (resultError)
+        {
+            *resultError = 0.f;
+        }
+        if (result.size() <= targetIndexCount || verts.empty())
+        {
+            return result;
+        }
+
+        size_t vertCount = verts.size();
+        std::vector<uint32_t> position = positionRemap(verts);
+
+        // quadrics live on positions so that seam vertices share their geometry
+        std::vector<Quadric> quadrics(vertCount);
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            glm::vec3 const& a = verts[result[i]].pos;
+            glm::vec3 n = glm::cross(verts[result[i + 1]].pos - a, verts[result[i + 2]].pos - a);
+            float area = glm::length(n);
+            if (area > 0.f)
+            {
+                n /= area;
+                auto plane = Quadric::fromPlane(n, -glm::dot(n, a), area);
+                for (int k = 0; k < 3; ++k)
+                {
+                    quadrics[position[result[i + k]]] += plane;
+                }
+            }
+        }
+
+        // seams: more than one referenced vertex per position; borders: edges used once
+        std::vector<bool> locked(vertCount, false);
+        {
+            std::vector<uint32_t> firstUser(vertCount, EMPTY_SLOT);
+            for (uint32_t idx : result)
+            {
+                uint32_t& user = firstUser[position[idx]];
+                if (user == EMPTY_SLOT)
+                {
+                    user = idx;
+                }
+                else if (user != idx)
+                {
+                    locked[position[idx]] = true;
+                }
+            }
+
+            std::unordered_map<uint64_t, uint32_t> edgeUse;
+            edgeUse.reserve(result.size());
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (int k = 0; k < 3; ++k)
+                {
+                    uint32_t a = position[result[i + k]], b = position[result[i + (k + 1) % 3]];
+                    ++edgeUse[static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b)];
+                }
+            }
+            for (auto const& [edge, uses] : edgeUse)
+            {
+                if (uses == 1)
+                {
+                    locked[edge >> 32] = true;
+                    locked[edge & 0xFFFFFFFF] = true;
+                }
+            }
+        }
+
+        double maxCost = static_cast<double>(targetError) * targetError;
+        double appliedCost = 0;
+        std::vector<Collapse> collapses;
+        std::vector<uint32_t> remap(vertCount);
+        std::vector<bool> touched(vertCount);
+
+        while (result.size() > targetIndexCount)
+        {
+            collapses.clear();
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (int k = 0; k < 3; ++k)
+                {
+                    uint32_t from = result[i + k];
+                    if (locked[position[from]])
+                    {
+                        continue;
+                    }
+                    for (int other : {(k + 1) % 3, (k + 2) % 3})
+                    {
+                        uint32_t to = result[i + other];
+                        double cost = quadrics[position[from]].error(quadrics[position[to]], verts[to].pos);
+                        if (cost <= maxCost)
+                        {
+                            collapses.push_back({from, to, cost});
+                        }
+                    }
+                }
+            }
+            if (collapses.empty())
+            {
+                break;
+            }
+            std::sort(collapses.begin(), collapses.end(), [](Collapse const& a, Collapse const& b)
+            {
+                return a.cost < b.cost;
+            });
+
+            TriangleAdjacency adjacency(result.data(), result.size(), vertCount);
+            for (uint32_t v = 0; v < vertCount; ++v)
+            {
+                remap[v] = v;
+            }
+            std::fill(touched.begin(), touched.end(), false);
+
+            // each collapse removes about two triangles; leave headroom so we do not overshoot
+            size_t budget = (result.size() - targetIndexCount) / 6 + 1;
+            size_t applied = 0;
+
+            for (auto const& collapse : collapses)
+            {
+                if (applied >= budget)
+                {
+                    break;
+                }
+                if (touched[collapse.from] || touched[collapse.to])
+                {
+                    continue;
+                }
+
+                // reject collapses that flip or degenerate a remaining triangle around from
+                bool valid = true;
+                glm::vec3 const& target = verts[collapse.to].pos;
+                for (uint32_t j = adjacency.offsets[collapse.from]; valid && j < adjacency.offsets[collapse.from + 1]; ++j)
+                {
+                    uint32_t const* tri = &result[adjacency.triangles[j] * 3];
+                    if (tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to)
+                    {
+                        continue;
+                    }
+
+                    glm::vec3 p[3], q[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        p[k] = verts[tri[k]].pos;
+                        q[k] = tri[k] == collapse.from ? target : p[k];
+                    }
+                    glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                    valid = glm::dot(before, after) > 0.25f * glm::length(before) * glm::length(after);
+                }
+                if (!valid)
+                {
+                    continue;
+                }
+
+                for (uint32_t j = adjacency.offsets[collapse.from]; j < adjacency.offsets[collapse.from + 1]; ++j)
+                {
+                    uint32_t const* tri = &result[adjacency.triangles[j] * 3];
+                    touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+                }
+                remap[collapse.from] = collapse.to;
+                quadrics[position[collapse.to]] += quadrics[position[collapse.from]];
+                appliedCost = std::max(appliedCost, collapse.cost);
+                ++applied;
+            }
+
+            if (applied == 0)
+            {
+                break;
+            }
+
+            size_t write = 0;
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+                if (position[a] != position[b] && position[b] != position[c] && position[a] != position[c])
+                {
+                    result[write++] = a;
+                    result[write++] = b;
+                    result[write++] = c;
+                }
+            }
+            result.resize(write);
+        }
+
+        if (resultError)
+        {
+            *resultError = static_cast<float>(std::sqrt(appliedCost));
+        }
+        return result;
+    }
+
+    void optimizeVertexFetch(std::vector<NVertex>& verts, std::vector<uint32_t>& indices)
+    {
+        std::vector<uint32_t> remap(verts.size(), EMPTY_SLOT);
+        std::vector<NVertex> reordered;
+        reordered.reserve(verts.size());
+
+        for (auto& idx : indices)
+        {
+            if (remap[idx] == EMPTY_SLOT)
+            {
+                remap[idx] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(verts[idx]);
+            }
+            idx = remap[idx];
+        }
+
+        verts.swap(reordered);
+    }
+}
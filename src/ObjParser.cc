@@ -0,0 +1,335 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "ObjParser.h"
+#include "ThreadPool.h"
+
+#include <charconv>
+
+namespace ObjParser
+{
+    namespace
+    {
+        bool isSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        char const* skipSpace(char const* p, char const* end)
+        {
+            while (p < end && isSpace(*p))
+            {
+                ++p;
+            }
+            return p;
+        }
+
+        char const* skipToken(char const* p, char const* end)
+        {
+            while (p < end && !isSpace(*p) && *p != '\n')
+            {
+                ++p;
+            }
+            return p;
+        }
+
+        char const* nextLine(char const* p, char const* end)
+        {
+            auto const* newline = reinterpret_cast<char const*>(memchr(p, '\n', end - p));
+            return newline ? newline + 1 : end;
+        }
+
+        char const* parseFloat(char const* p, char const* end, float& out)
+        {
+            p = skipSpace(p, end);
+            if (p < end && *p == '+')
+            {
+                ++p;
+            }
+
+            auto [ptr, err] = std::from_chars(p, end, out);
+            if (err != std::errc())
+            {
+                out = 0.f;
+                return skipToken(p, end);
+            }
+            return ptr;
+        }
+
+        // parses a signed OBJ index; returns p unchanged if there is none
+        char const* parseIndex(char const* p, char const* end, int64_t& out)
+        {
+            bool negative = false;
+            char const* start = p;
+            if (p < end && *p == '-')
+            {
+                negative = true;
+                ++p;
+            }
+
+            int64_t value = 0;
+            char const* digits = p;
+            while (p < end && *p >= '0' && *p <= '9')
+            {
+                value = value * 10 + (*p - '0');
+                ++p;
+            }
+
+            if (p == digits)
+            {
+                out = 0;
+                return start;
+            }
+            out = negative ? -value : value;
+            return p;
+        }
+
+        // OBJ indices are 1-based, negative ones are relative to the current count
+        uint32_t resolveIndex(int64_t idx, size_t count)
+        {
+            if (idx > 0)
+            {
+                return static_cast<uint32_t>(idx - 1);
+            }
+            if (idx < 0 && static_cast<size_t>(-idx) <= count)
+            {
+                return static_cast<uint32_t>(static_cast<int64_t>(count) + idx);
+            }
+            return NO_INDEX;
+        }
+
+        char const* parseCorner(char const* p, char const* end, RecordCounts const& seen, Corner& corner)
+        {
+            int64_t idx = 0;
+            p = parseIndex(p, end, idx);
+            corner.pos = resolveIndex(idx, seen.positions);
+            corner.tex = NO_INDEX;
+            corner.normal = NO_INDEX;
+
+            if (p < end && *p == '/')
+            {
+                ++p;
+                p = parseIndex(p, end, idx);
+                corner.tex = resolveIndex(idx, seen.texCoords);
+
+                if (p < end && *p == '/')
+                {
+                    ++p;
+                    p = parseIndex(p, end, idx);
+                    corner.normal = resolveIndex(idx, seen.normals);
+                }
+            }
+            return skipToken(p, end);
+        }
+
+        char const* parseFace(char const* p, char const* end, RecordCounts const& base, ObjData& data)
+        {
+            RecordCounts seen;
+            seen.positions = base.positions + data.positions.size();
+            seen.texCoords = base.texCoords + data.texCoords.size();
+            seen.normals = base.normals + data.normals.size();
+
+            Corner first = {}, prev = {};
+            uint32_t cornerCount = 0;
+
+            while (true)
+            {
+                p = skipSpace(p, end);
+                if (p == end || *p == '\n' || *p == '#')
+                {
+                    break;
+                }
+
+                Corner corner = {};
+                p = parseCorner(p, end, seen, corner);
+                if (corner.pos == NO_INDEX)
+                {
+                    continue;
+                }
+
+                if (cornerCount == 0)
+                {
+                    first = corner;
+                }
+                else if (cornerCount >= 2)
+                {
+                    data.corners.push_back(first);
+                    data.corners.push_back(prev);
+                    data.corners.push_back(corner);
+                }
+                prev = corner;
+                ++cornerCount;
+            }
+            return p;
+        }
+
+        /**
+         * Parses [begin, end), which must start at a line boundary.
+         * @param base records in the file before begin, used to resolve relative indices
+         */
+        void parseRange(char const* begin, char const* end, RecordCounts const& base, ObjData& data)
+        {
+            char const* p = begin;
+            while (p < end)
+            {
+                p = skipSpace(p, end);
+                if (p == end)
+                {
+                    break;
+                }
+
+                if (p[0] == 'v' && p + 1 < end)
+                {
+                    if (isSpace(p[1]))
+                    {
+                        auto& pos = data.positions.emplace_back();
+                        p = parseFloat(p + 1, end, pos.x);
+                        p = parseFloat(p, end, pos.y);
+                        p = parseFloat(p, end, pos.z);
+                    }
+                    else if (p[1] == 'n' && p + 2 < end && isSpace(p[2]))
+                    {
+                        auto& norm = data.normals.emplace_back();
+                        p = parseFloat(p + 2, end, norm.x);
+                        p = parseFloat(p, end, norm.y);
+                        p = parseFloat(p, end, norm.z);
+                    }
+                    else if (p[1] == 't' && p + 2 < end && isSpace(p[2]))
+                    {
+                        auto& tex = data.texCoords.emplace_back();
+                        p = parseFloat(p + 2, end, tex.x);
+                        p = parseFloat(p, end, tex.y);
+                    }
+                }
+                else if (p[0] == 'f' && p + 1 < end && isSpace(p[1]))
+                {
+                    p = parseFace(p + 1, end, base, data);
+                }
+
+                p = nextLine(p, end);
+            }
+        }
+
+        // cheap pre-pass: only looks at the first token of each line
+        RecordCounts countRecords(char const* p, char const* end)
+        {
+            RecordCounts counts;
+            while (p < end)
+            {
+                p = skipSpace(p, end);
+                if (p + 1 < end && p[0] == 'v')
+                {
+                    if (isSpace(p[1]))
+                    {
+                        ++counts.positions;
+                    }
+                    else if (p + 2 < end && isSpace(p[2]))
+                    {
+                        counts.texCoords += p[1] == 't';
+                        counts.normals += p[1] == 'n';
+                    }
+                }
+                p = nextLine(p, end);
+            }
+            return counts;
+        }
+
+        template<typename T>
+        void appendChunks(
+                std::vector<ObjData> const& chunks, std::vector<T> ObjData::* member,
+                std::vector<T>& out, ThreadPool& pool)
+        {
+            std::vector<size_t> offsets(chunks.size() + 1, 0);
+            for (size_t i = 0; i < chunks.size(); ++i)
+            {
+                offsets[i + 1] = offsets[i] + (chunks[i].*member).size();
+            }
+
+            out.resize(offsets.back());
+            pool.parallelFor(chunks.size(), [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    auto const& src = chunks[i].*member;
+                    std::copy(src.begin(), src.end(), out.begin() + static_cast<ptrdiff_t>(offsets[i]));
+                }
+            }, 1);
+        }
+    }
+
+    ObjData parse(char const* begin, char const* end)
+    {
+        ObjData data;
+        parseRange(begin, end, {}, data);
+        return data;
+    }
+
+    ObjData parseWindow(char const* begin, char const* end, RecordCounts& seen)
+    {
+        ObjData data;
+        parseRange(begin, end, seen, data);
+        seen.positions += data.positions.size();
+        seen.texCoords += data.texCoords.size();
+        seen.normals += data.normals.size();
+        return data;
+    }
+
+    ObjData parseParallel(char const* begin, char const* end, ThreadPool& pool, size_t minChunkBytes)
+    {
+        size_t totalSize = static_cast<size_t>(end - begin);
+        size_t chunkCount = std::min(pool.size() * 4, totalSize / std::max<size_t>(minChunkBytes, 1));
+        if (chunkCount <= 1)
+        {
+            return parse(begin, end);
+        }
+
+        // split at line boundaries
+        std::vector<char const*> bounds(chunkCount + 1);
+        bounds[0] = begin;
+        bounds[chunkCount] = end;
+        for (size_t i = 1; i < chunkCount; ++i)
+        {
+            char const* nominal = std::max(begin + totalSize / chunkCount * i, bounds[i - 1]);
+            bounds[i] = nextLine(nominal, end);
+        }
+
+        // counts per chunk, then exclusive prefix sums give every chunk its global base
+        std::vector<RecordCounts> counts(chunkCount);
+        pool.parallelFor(chunkCount, [&](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                counts[i] = countRecords(bounds[i], bounds[i + 1]);
+            }
+        }, 1);
+
+        std::vector<RecordCounts> bases(chunkCount);
+        for (size_t i = 1; i < chunkCount; ++i)
+        {
+            bases[i].positions = bases[i - 1].positions + counts[i - 1].positions;
+            bases[i].texCoords = bases[i - 1].texCoords + counts[i - 1].texCoords;
+            bases[i].normals = bases[i - 1].normals + counts[i - 1].normals;
+        }
+
+        std::vector<ObjData> chunks(chunkCount);
+        pool.parallelFor(chunkCount, [&](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                chunks[i].positions.reserve(counts[i].positions);
+                chunks[i].texCoords.reserve(counts[i].texCoords);
+                chunks[i].normals.reserve(counts[i].normals);
+                parseRange(bounds[i], bounds[i + 1], bases[i], chunks[i]);
+            }
+        }, 1);
+
+        // concatenating in chunk order keeps the result identical to a serial parse
+        ObjData data;
+        appendChunks(chunks, &ObjData::positions, data.positions, pool);
+        appendChunks(chunks, &ObjData::texCoords, data.texCoords, pool);
+        appendChunks(chunks, &ObjData::normals, data.normals, pool);
+        appendChunks(chunks, &ObjData::corners, data.corners, pool);
+        return data;
+    }
+}
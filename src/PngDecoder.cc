@@ -0,0 +1,258 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "PngDecoder.h"
+#include "CpuFeatures.h"
+
+namespace
+{
+    constexpr uint32_t OPAQUE_ALPHA = 0xFF000000;
+
+#if defined(CPU_X86)
+    // four RGB pixels from the low 12 bytes of rgb
+    TARGET_SSSE3
+    void storeRgbx4(uint8_t* dst, __m128i rgb)
+    {
+        __m128i const shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        __m128i const alpha = _mm_set1_epi32(static_cast<int>(OPAQUE_ALPHA));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+    }
+
+    // returns the pixels expanded; the rest are left to the scalar loop
+    TARGET_SSSE3
+    size_t expandRgbSsse3(uint8_t const* src, uint8_t* dst, size_t width)
+    {
+        // 16 pixels from three loads that end exactly at the last byte read
+        size_t x = 0;
+        for (; x + 16 <= width; x += 16)
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 3 * x));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 3 * x + 16));
+            __m128i c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 3 * x + 32));
+            storeRgbx4(dst + 4 * x, a);
+            storeRgbx4(dst + 4 * (x + 4), _mm_alignr_epi8(b, a, 12));
+            storeRgbx4(dst + 4 * (x + 8), _mm_alignr_epi8(c, b, 8));
+            storeRgbx4(dst + 4 * (x + 12), _mm_srli_si128(c, 4));
+        }
+        return x;
+    }
+#endif
+
+    void expandRgb(uint8_t const* src, uint8_t* dst, size_t width)
+    {
+        size_t x = 0;
+#if defined(CPU_X86)
+        if (CpuFeatures::detected().ssse3)
+        {
+            x = expandRgbSsse3(src, dst, width);
+        }
+#endif
+        for (; x < width; ++x)
+        {
+            dst[4 * x] = src[3 * x];
+            dst[4 * x + 1] = src[3 * x + 1];
+            dst[4 * x + 2] = src[3 * x + 2];
+            dst[4 * x + 3] = 0xFF;
+        }
+    }
+
+    void expandPalette(uint8_t const* src, uint32_t const* palette, uint8_t* dst, size_t width)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            memcpy(dst + 4 * x, &palette[src[x]], sizeof(uint32_t));
+        }
+    }
+}
+
+PngDecoder::PngDecoder(uint8_t const* data, size_t size) : data(data), size(size)
+{
+    if (size < 8 || png_sig_cmp(data, 0, 8) != 0)
+    {
+        throw std::runtime_error("Not a PNG file!");
+    }
+
+    png = png_create_read_struct(PNG_LIBPNG_VER_STRING, this, onError, onWarning);
+    info = png ? png_create_info_struct(png) : nullptr;
+    if (!info)
+    {
+        png_destroy_read_struct(&png, nullptr, nullptr);
+        throw std::runtime_error("Cannot create PNG decoder!");
+    }
+    png_set_read_fn(png, this, readData);
+
+    // libpng reports errors by jumping back here; nothing with a destructor may live in between
+    if (setjmp(png_jmpbuf(png)))
+    {
+        png_destroy_read_struct(&png, &info, nullptr);
+        throw std::runtime_error("Cannot decode PNG: " + error);
+    }
+    png_read_info(png, info);
+    imageWidth = png_get_image_width(png, info);
+    imageHeight = png_get_image_height(png, info);
+}
+
+PngDecoder::~PngDecoder()
+{
+    if (png)
+    {
+        png_destroy_read_struct(&png, &info, nullptr);
+    }
+}
+
+uint32_t PngDecoder::width() const
+{
+    return imageWidth;
+}
+
+uint32_t PngDecoder::height() const
+{
+    return imageHeight;
+}
+
+void PngDecoder::decodeRgba8(uint8_t* dst, size_t rowPitch)
+{
+    if (rowPitch < size_t(imageWidth) * 4)
+    {
+        throw std::runtime_error("PNG row pitch is too small!");
+    }
+
+    uint32_t palette[256];
+    std::vector<uint8_t> row(size_t(imageWidth) * 4);
+    if (setjmp(png_jmpbuf(png)))
+    {
+        throw std::runtime_error("Cannot decode PNG: " + error);
+    }
+
+    RowLayout layout = configure(palette);
+    readRows(layout, palette, row.data(), dst, rowPitch);
+    png_read_end(png, nullptr);
+}
+
+PngDecoder::RowLayout PngDecoder::configure(uint32_t (&palette)[256])
+{
+    int bitDepth = png_get_bit_depth(png, info);
+    int colorType = png_get_color_type(png, info);
+    bool hasTransparency = png_get_valid(png, info, PNG_INFO_tRNS) != 0;
+    // Adam7 passes fill in rows of dst several times, which only libpng's RGBA output supports
+    passes = png_set_interlace_handling(png);
+    bool interlaced = passes > 1;
+
+    if (bitDepth == 16)
+    {
+        png_set_strip_16(png);
+    }
+
+    RowLayout layout;
+    size_t pixelBytes;
+    if (colorType == PNG_COLOR_TYPE_PALETTE && !interlaced)
+    {
+        // indices, one byte each; the table holds the palette with its tRNS alpha
+        if (bitDepth < 8)
+        {
+            png_set_packing(png);
+        }
+
+        png_colorp colors = nullptr;
+        int colorCount = 0;
+        png_get_PLTE(png, info, &colors, &colorCount);
+        png_bytep alphas = nullptr;
+        int alphaCount = 0;
+        if (hasTransparency)
+        {
+            png_get_tRNS(png, info, &alphas, &alphaCount, nullptr);
+        }
+
+        // indices past the palette come out opaque black
+        std::fill(std::begin(palette), std::end(palette), OPAQUE_ALPHA);
+        for (int i = 0; i < colorCount && i < 256; ++i)
+        {
+            uint32_t alpha = i < alphaCount ? alphas[i] : 0xFF;
+            palette[i] = colors[i].red | colors[i].green << 8 | colors[i].blue << 16 | alpha << 24;
+        }
+        layout = RowLayout::PALETTE;
+        pixelBytes = 1;
+    }
+    else
+    {
+        if (colorType == PNG_COLOR_TYPE_PALETTE)
+        {
+            png_set_palette_to_rgb(png);
+        }
+        if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+        {
+            if (bitDepth < 8)
+            {
+                png_set_expand_gray_1_2_4_to_8(png);
+            }
+            png_set_gray_to_rgb(png);
+        }
+        if (hasTransparency)
+        {
+            png_set_tRNS_to_alpha(png);
+        }
+
+        bool alpha = (colorType & PNG_COLOR_MASK_ALPHA) != 0 || hasTransparency;
+        if (!alpha && interlaced)
+        {
+            png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+            alpha = true;
+        }
+        layout = alpha ? RowLayout::RGBA : RowLayout::RGB;
+        pixelBytes = alpha ? 4 : 3;
+    }
+
+    png_read_update_info(png, info);
+    if (png_get_rowbytes(png, info) != imageWidth * pixelBytes)
+    {
+        png_error(png, "unexpected row layout");
+    }
+    return layout;
+}
+
+void PngDecoder::readRows(RowLayout layout, uint32_t const* palette, uint8_t* row, uint8_t* dst, size_t rowPitch)
+{
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (uint32_t y = 0; y < imageHeight; ++y)
+        {
+            uint8_t* out = dst + y * rowPitch;
+            switch (layout)
+            {
+                case RowLayout::RGBA:
+                    png_read_row(png, out, nullptr);
+                    break;
+                case RowLayout::RGB:
+                    png_read_row(png, row, nullptr);
+                    expandRgb(row, out, imageWidth);
+                    break;
+                case RowLayout::PALETTE:
+                    png_read_row(png, row, nullptr);
+                    expandPalette(row, palette, out, imageWidth);
+                    break;
+            }
+        }
+    }
+}
+
+void PngDecoder::readData(png_structp png, png_bytep out, png_size_t length)
+{
+    auto* decoder = static_cast<PngDecoder*>(png_get_io_ptr(png));
+    if (length > decoder->size - decoder->offset)
+    {
+        png_error(png, "data is truncated");
+    }
+    memcpy(out, decoder->data + decoder->offset, length);
+    decoder->offset += length;
+}
+
+void PngDecoder::onError(png_structp png, png_const_charp message)
+{
+    static_cast<PngDecoder*>(png_get_error_ptr(png))->error = message;
+    png_longjmp(png, 1);
+}
+
+void PngDecoder::onWarning(png_structp, png_const_charp)
+{
+}
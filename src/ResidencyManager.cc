@@ -0,0 +1,192 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "ResidencyManager.h"
+#include "StreamingUpload.h"
+
+namespace
+{
+    // smallest staging buffer worth allocating for an update's uploads
+    constexpr VkDeviceSize MIN_STAGING_SIZE = 1024 * 1024;
+}
+
+ResidencyManager::ResidencyManager(
+        VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+        VkQueue const& transferQueue, VkCommandPool* transferCmdPool,
+        std::set<uint32_t> const& transferQueues,
+        AssetRegistry& assets) :
+        AVkGraphicsBase(dev), assets(&assets), allocator(allocator), physicalDev(physicalDev),
+        transferQueue(transferQueue), transferCmdPool(transferCmdPool), transferQueues(transferQueues)
+{
+}
+
+bool ResidencyManager::use(MeshHandle mesh)
+{
+    Entry& meshEntry = entry(mesh);
+    meshEntry.lastUsed = frame;
+    if (assets->mesh(mesh).resident())
+    {
+        return true;
+    }
+
+    meshEntry.requested = true;
+    return false;
+}
+
+void ResidencyManager::update()
+{
+    ++frame;
+    // VMA refreshes its heap budgets from VK_EXT_memory_budget on frame changes
+    vmaSetCurrentFrameIndex(*allocator, static_cast<uint32_t>(frame));
+
+    // (last used frame, mesh) of resident meshes no frame in flight draws
+    std::vector<std::pair<uint64_t, MeshHandle>> evictable;
+    std::vector<MeshHandle> requested;
+    VkDeviceSize requestedBytes = 0;
+    resident = 0;
+    for (uint32_t index = 0; index < entries.size(); ++index)
+    {
+        Entry& meshEntry = entries[index];
+        MeshHandle handle = { index, meshEntry.generation };
+        Mesh* mesh = assets->meshes().get(handle);
+        if (!mesh)
+        {
+            meshEntry = {};
+            continue;
+        }
+
+        if (mesh->resident())
+        {
+            resident += mesh->gpuBytes();
+            if (meshEntry.lastUsed + MAX_FRAMES_IN_FLIGHT <= frame)
+            {
+                evictable.emplace_back(meshEntry.lastUsed, handle);
+            }
+        }
+        else if (meshEntry.requested)
+        {
+            requested.push_back(handle);
+            requestedBytes += mesh->gpuBytes();
+        }
+        meshEntry.requested = false;
+    }
+
+    currentBudget = fixedBudget != 0 ? fixedBudget : deviceBudget();
+    std::sort(evictable.begin(), evictable.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+    for (auto const& [lastUsed, handle] : evictable)
+    {
+        if (resident + requestedBytes <= currentBudget)
+        {
+            break;
+        }
+
+        Mesh& mesh = assets->mesh(handle);
+        resident -= mesh.gpuBytes();
+        mesh.evict();
+    }
+
+    // what does not fit is requested again by the next frames drawing it
+    std::vector<Mesh*> uploads;
+    VkDeviceSize uploadBytes = 0;
+    for (MeshHandle handle : requested)
+    {
+        Mesh& mesh = assets->mesh(handle);
+        if (resident + mesh.gpuBytes() <= currentBudget)
+        {
+            resident += mesh.gpuBytes();
+            uploadBytes += mesh.gpuBytes();
+            uploads.push_back(&mesh);
+        }
+    }
+    if (uploads.empty())
+    {
+        return;
+    }
+
+    {
+        StreamingUpload uploader(
+                getLogicalDevPtr(), allocator, physicalDev, transferQueue, transferCmdPool, transferQueues,
+                std::clamp(uploadBytes, MIN_STAGING_SIZE, StreamingUpload::DEFAULT_STAGING_SIZE));
+        for (Mesh* mesh : uploads)
+        {
+            mesh->upload(uploader);
+        }
+        uploader.flush();
+    }
+
+    for (Mesh* mesh : uploads)
+    {
+        mesh->releaseCpuData();
+    }
+}
+
+void ResidencyManager::setBudget(VkDeviceSize bytes)
+{
+    fixedBudget = bytes;
+}
+
+VkDeviceSize ResidencyManager::budget() const
+{
+    return currentBudget;
+}
+
+VkDeviceSize ResidencyManager::residentBytes() const
+{
+    return resident;
+}
+
+size_t ResidencyManager::cpuBytes()
+{
+    size_t bytes = 0;
+    for (Mesh const& mesh : assets->meshes())
+    {
+        bytes += mesh.cpuBytes();
+    }
+    return bytes;
+}
+
+ResidencyManager::Usage ResidencyManager::usage(MeshHandle mesh)
+{
+    Mesh& record = assets->mesh(mesh);
+    return { record.gpuBytes(), record.cpuBytes(), entry(mesh).lastUsed, record.resident() };
+}
+
+ResidencyManager::Entry& ResidencyManager::entry(MeshHandle mesh)
+{
+    if (mesh.index >= entries.size())
+    {
+        entries.resize(mesh.index + 1);
+    }
+
+    Entry& meshEntry = entries[mesh.index];
+    if (meshEntry.generation != mesh.generation)
+    {
+        meshEntry = {};
+        meshEntry.generation = mesh.generation;
+    }
+    return meshEntry;
+}
+
+VkDeviceSize ResidencyManager::deviceBudget() const
+{
+    VkPhysicalDeviceMemoryProperties const* props = nullptr;
+    vmaGetMemoryProperties(*allocator, &props);
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+    vmaGetHeapBudgets(*allocator, budgets);
+
+    VkDeviceSize heapBudget = 0;
+    VkDeviceSize heapUsage = 0;
+    for (uint32_t heap = 0; heap < props->memoryHeapCount; ++heap)
+    {
+        if (props->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        {
+            heapBudget += budgets[heap].budget;
+            heapUsage += budgets[heap].usage;
+        }
+    }
+
+    VkDeviceSize others = heapUsage > resident ? heapUsage - resident : 0;
+    auto usable = static_cast<VkDeviceSize>(static_cast<double>(heapBudget) * (1.0 - BUDGET_HEADROOM));
+    return usable > others ? usable - others : 0;
+}
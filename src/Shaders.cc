@@ -2,34 +2,14 @@
 // Created by Supakorn on 9/5/2021.
 //
 #include "common.h"
-#include <fstream>
-#include <sstream>
 #include "Shaders.h"
+#include "helpers.h"
 
 namespace Shaders
 {
     std::vector<uint8_t> readBytecode(std::string const& fileName)
     {
-        std::ifstream file;
-        file.open(fileName, std::ifstream::in | std::ifstream::binary);
-        std::stringstream byteSrc;
-
-        if (file)
-        {
-            byteSrc << file.rdbuf();
-            file.close();
-        }
-        else
-        {
-            throw std::runtime_error("Cannot load shader file!");
-        }
-
-        std::vector<uint8_t> outchr;
-        std::string const& outchrTmp = byteSrc.str();
-        outchr.reserve(outchrTmp.size());
-        outchr.assign(outchrTmp.begin(), outchrTmp.end());
-
-        return outchr;
+        return helpers::readAsset(fileName);
     }
 
     std::pair<VkShaderModule, VkResult>
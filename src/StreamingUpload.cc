@@ -0,0 +1,141 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "StreamingUpload.h"
+
+StreamingUpload::StreamingUpload(
+        VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+        VkQueue const& transferQueue, VkCommandPool* transferCmdPool,
+        std::set<uint32_t> const& transferQueues,
+        VkDeviceSize stagingSize) :
+        AVkGraphicsBase(dev),
+        staging(dev, allocator, physicalDev, stagingSize,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                transferQueues),
+        transferQueue(transferQueue), cmdPool(transferCmdPool), slotSize(stagingSize / SLOT_COUNT)
+{
+    VkFenceCreateInfo fenceCreateInfo = {};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    for (auto& slot : slots)
+    {
+        CHECK_VK_SUCCESS(vkCreateFence(*dev, &fenceCreateInfo, nullptr, &slot.fence), "Cannot create Fence!");
+    }
+}
+
+StreamingUpload::~StreamingUpload()
+{
+    if (!initialized())
+    {
+        return;
+    }
+
+    for (auto& slot : slots)
+    {
+        if (slot.inFlight)
+        {
+            vkWaitForFences(getLogicalDev(), 1, &slot.fence, VK_TRUE, UINT64_MAX);
+        }
+        if (slot.cmdBuffer != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(getLogicalDev(), *cmdPool, 1, &slot.cmdBuffer);
+        }
+        vkDestroyFence(getLogicalDev(), slot.fence, nullptr);
+    }
+}
+
+void StreamingUpload::upload(
+        Buffers::Buffer const& dst, VkDeviceSize dstOffset, VkDeviceSize size, FillFunction const& fill)
+{
+    uint8_t* stagingMemory = staging.mapped();
+    VkDeviceSize done = 0;
+    while (done < size)
+    {
+        if (slotUsed == slotSize)
+        {
+            submit();
+        }
+
+        Slot& slot = slots[current];
+        if (!slot.recording)
+        {
+            begin(slot);
+        }
+
+        VkDeviceSize chunk = std::min(size - done, slotSize - slotUsed);
+        VkDeviceSize stagingOffset = current * slotSize + slotUsed;
+        fill(stagingMemory + stagingOffset, done, chunk);
+        dst.cmdCopyDataFrom(staging.vertexBuffer, stagingOffset, dstOffset + done, chunk, slot.cmdBuffer);
+
+        slotUsed += chunk;
+        done += chunk;
+    }
+}
+
+void StreamingUpload::flush()
+{
+    if (slots[current].recording)
+    {
+        submit();
+    }
+    for (auto& slot : slots)
+    {
+        wait(slot);
+    }
+}
+
+void StreamingUpload::begin(Slot& slot)
+{
+    wait(slot);
+    if (slot.cmdBuffer != VK_NULL_HANDLE)
+    {
+        // the transfer pool cannot reset single command buffers
+        vkFreeCommandBuffers(getLogicalDev(), *cmdPool, 1, &slot.cmdBuffer);
+        slot.cmdBuffer = VK_NULL_HANDLE;
+    }
+
+    VkCommandBufferAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocateInfo.commandPool = *cmdPool;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocateInfo.commandBufferCount = 1;
+    CHECK_VK_SUCCESS(vkAllocateCommandBuffers(getLogicalDev(), &allocateInfo, &slot.cmdBuffer),
+                     ErrorMessages::FAILED_CANNOT_CREATE_CMD_BUFFER);
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    CHECK_VK_SUCCESS(vkBeginCommandBuffer(slot.cmdBuffer, &beginInfo),
+                     ErrorMessages::FAILED_CANNOT_BEGIN_CMD_BUFFER);
+    slot.recording = true;
+}
+
+void StreamingUpload::submit()
+{
+    Slot& slot = slots[current];
+    CHECK_VK_SUCCESS(vkEndCommandBuffer(slot.cmdBuffer), ErrorMessages::FAILED_CANNOT_END_CMD_BUFFER);
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &slot.cmdBuffer;
+    CHECK_VK_SUCCESS(vkQueueSubmit(transferQueue, 1, &submitInfo, slot.fence),
+                     ErrorMessages::FAILED_CANNOT_SUBMIT_QUEUE);
+
+    slot.recording = false;
+    slot.inFlight = true;
+    current = (current + 1) % SLOT_COUNT;
+    slotUsed = 0;
+}
+
+void StreamingUpload::wait(Slot& slot)
+{
+    if (!slot.inFlight)
+    {
+        return;
+    }
+    CHECK_VK_SUCCESS(vkWaitForFences(getLogicalDev(), 1, &slot.fence, VK_TRUE, UINT64_MAX),
+                     ErrorMessages::FAILED_WAIT_IDLE);
+    CHECK_VK_SUCCESS(vkResetFences(getLogicalDev(), 1, &slot.fence), "Cannot reset Fence!");
+    slot.inFlight = false;
+}
@@ -46,6 +46,25 @@ void SwapchainImageBuffers::configureBuffers(uint32_t const& binding, Image::Ima
     }
 }
 
+void SwapchainImageBuffers::setImage(uint32_t i, Image::Image const& img)
+{
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = img.imgView;
+    imageInfo.sampler = img.baseSampler;
+
+    VkWriteDescriptorSet descriptorWriteImg = {};
+    descriptorWriteImg.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWriteImg.dstSet = descriptorSets[i];
+    descriptorWriteImg.dstBinding = 1;
+    descriptorWriteImg.dstArrayElement = 0;
+    descriptorWriteImg.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWriteImg.descriptorCount = 1;
+    descriptorWriteImg.pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(getLogicalDev(), 1, &descriptorWriteImg, 0, nullptr);
+}
+
 void SwapchainImageBuffers::configureMeshBuffers(uint32_t const& binding, DynUniformObjBuffer<MeshUniform> const& unif)
 {
     for (uint32_t i = 0; i < imgSize; ++i)
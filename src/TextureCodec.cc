@@ -0,0 +1,680 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "TextureCodec.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+namespace TextureCodec
+{
+    namespace
+    {
+        constexpr size_t BLOCK_TEXELS = BLOCK_DIM * BLOCK_DIM;
+
+        // sRGB byte -> linear intensity
+        std::array<float, 256> srgbToLinearTable()
+        {
+            std::array<float, 256> table = {};
+            for (size_t i = 0; i < table.size(); ++i)
+            {
+                float c = static_cast<float>(i) / 255.f;
+                table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            return table;
+        }
+
+        // linear intensities halfway between consecutive sRGB bytes, to encode by binary search
+        std::array<float, 255> linearMidpoints(std::array<float, 256> const& toLinear)
+        {
+            std::array<float, 255> midpoints = {};
+            for (size_t i = 0; i < midpoints.size(); ++i)
+            {
+                midpoints[i] = (toLinear[i] + toLinear[i + 1]) * 0.5f;
+            }
+            return midpoints;
+        }
+
+        // one level from the one above, averaging 2x2 blocks; odd edges reuse the last row or column
+        void downsampleRgba8(uint8_t const* src, uint32_t srcWidth, uint32_t srcHeight, uint8_t* dst, bool srgb)
+        {
+            static std::array<float, 256> const toLinear = srgbToLinearTable();
+            static std::array<float, 255> const midpoints = linearMidpoints(toLinear);
+
+            uint32_t dstWidth = std::max(srcWidth / 2, 1u);
+            uint32_t dstHeight = std::max(srcHeight / 2, 1u);
+            for (uint32_t y = 0; y < dstHeight; ++y)
+            {
+                uint8_t const* row0 = src + size_t(std::min(2 * y, srcHeight - 1)) * srcWidth * 4;
+                uint8_t const* row1 = src + size_t(std::min(2 * y + 1, srcHeight - 1)) * srcWidth * 4;
+                for (uint32_t x = 0; x < dstWidth; ++x)
+                {
+                    size_t x0 = size_t(std::min(2 * x, srcWidth - 1)) * 4;
+                    size_t x1 = size_t(std::min(2 * x + 1, srcWidth - 1)) * 4;
+                    uint8_t* out = dst + (size_t(y) * dstWidth + x) * 4;
+                    for (size_t c = 0; c < 4; ++c)
+                    {
+                        uint32_t a = row0[x0 + c], b = row0[x1 + c], d = row1[x0 + c], e = row1[x1 + c];
+                        if (srgb && c < 3)
+                        {
+                            float linear = (toLinear[a] + toLinear[b] + toLinear[d] + toLinear[e]) * 0.25f;
+                            out[c] = static_cast<uint8_t>(
+                                    std::upper_bound(midpoints.begin(), midpoints.end(), linear) - midpoints.begin());
+                        }
+                        else
+                        {
+                            out[c] = static_cast<uint8_t>((a + b + d + e + 2) / 4);
+                        }
+                    }
+                }
+            }
+        }
+
+        template<size_t N>
+        using Color = std::array<float, N>;
+
+        /**
+         * Endpoints spanning the texels along their principal axis, through the mean.
+         * @param count texels in texels, N channels each
+         */
+        template<size_t N>
+        void fitPrincipalAxis(Color<N> const* texels, size_t count, Color<N>& e0, Color<N>& e1)
+        {
+            Color<N> mean = {};
+            for (size_t i = 0; i < count; ++i)
+            {
+                for (size_t c = 0; c < N; ++c)
+                {
+                    mean[c] += texels[i][c] / static_cast<float>(count);
+                }
+            }
+
+            float covariance[N][N] = {};
+            for (size_t i = 0; i < count; ++i)
+            {
+                for (size_t r = 0; r < N; ++r)
+                {
+                    for (size_t c = 0; c < N; ++c)
+                    {
+                        covariance[r][c] += (texels[i][r] - mean[r]) * (texels[i][c] - mean[c]);
+                    }
+                }
+            }
+
+            // power iteration, starting from the diagonal of the color cube
+            Color<N> axis;
+            axis.fill(1.f);
+            for (int iteration = 0; iteration < 8; ++iteration)
+            {
+                Color<N> next = {};
+                float length = 0;
+                for (size_t r = 0; r < N; ++r)
+                {
+                    for (size_t c = 0; c < N; ++c)
+                    {
+                        next[r] += covariance[r][c] * axis[c];
+                    }
+                    length = std::max(length, std::abs(next[r]));
+                }
+                if (length < 1e-6f)
+                {
+                    // a single color; both endpoints on it
+                    e0 = mean;
+                    e1 = mean;
+                    return;
+                }
+                for (size_t c = 0; c < N; ++c)
+                {
+                    axis[c] = next[c] / length;
+                }
+            }
+
+            float lo = std::numeric_limits<float>::max();
+            float hi = std::numeric_limits<float>::lowest();
+            float axisLength2 = 0;
+            for (size_t c = 0; c < N; ++c)
+            {
+                axisLength2 += axis[c] * axis[c];
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                float t = 0;
+                for (size_t c = 0; c < N; ++c)
+                {
+                    t += (texels[i][c] - mean[c]) * axis[c];
+                }
+                lo = std::min(lo, t / axisLength2);
+                hi = std::max(hi, t / axisLength2);
+            }
+            for (size_t c = 0; c < N; ++c)
+            {
+                e0[c] = std::clamp(mean[c] + axis[c] * hi, 0.f, 255.f);
+                e1[c] = std::clamp(mean[c] + axis[c] * lo, 0.f, 255.f);
+            }
+        }
+
+        /**
+         * Endpoints minimizing the squared error of the texels for fixed interpolation weights,
+         * texel i being weight[i] * e0 + (1 - weight[i]) * e1. Leaves them as they are when
+         * the weights cannot separate them.
+         */
+        template<size_t N>
+        void refineLeastSquares(Color<N> const* texels, float const* weights, size_t count, Color<N>& e0, Color<N>& e1)
+        {
+            float aa = 0, ab = 0, bb = 0;
+            Color<N> ax = {}, bx = {};
+            for (size_t i = 0; i < count; ++i)
+            {
+                float a = weights[i];
+                float b = 1.f - a;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                for (size_t c = 0; c < N; ++c)
+                {
+                    ax[c] += a * texels[i][c];
+                    bx[c] += b * texels[i][c];
+                }
+            }
+
+            float det = aa * bb - ab * ab;
+            if (std::abs(det) < 1e-6f)
+            {
+                return;
+            }
+            for (size_t c = 0; c < N; ++c)
+            {
+                e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.f, 255.f);
+                e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.f, 255.f);
+            }
+        }
+
+        // ---- BC1 ----
+
+        uint16_t packRgb565(Color<3> const& color)
+        {
+            auto quantize = [](float value, float max)
+            {
+                return static_cast<uint16_t>(std::lround(value * max / 255.f));
+            };
+            return static_cast<uint16_t>(quantize(color[0], 31) << 11 | quantize(color[1], 63) << 5 | quantize(color[2], 31));
+        }
+
+        std::array<int, 3> unpackRgb565(uint16_t packed)
+        {
+            int r = packed >> 11, g = (packed >> 5) & 63, b = packed & 31;
+            return { r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2 };
+        }
+
+        struct Bc1Candidate
+        {
+            uint16_t color0 = 0;
+            uint16_t color1 = 0;
+            uint8_t indices[BLOCK_TEXELS] = {};
+            float error = std::numeric_limits<float>::max();
+        };
+
+        /**
+         * Picks the closest palette entry for every texel. color0 > color1 selects the 4-color
+         * mode, else the 3-color mode whose index 3 is transparent black.
+         */
+        Bc1Candidate selectBc1(uint16_t color0, uint16_t color1, uint8_t const* texels)
+        {
+            auto c0 = unpackRgb565(color0);
+            auto c1 = unpackRgb565(color1);
+            int palette[4][3];
+            bool fourColors = color0 > color1;
+            for (size_t c = 0; c < 3; ++c)
+            {
+                palette[0][c] = c0[c];
+                palette[1][c] = c1[c];
+                palette[2][c] = fourColors ? (2 * c0[c] + c1[c] + 1) / 3 : (c0[c] + c1[c] + 1) / 2;
+                palette[3][c] = fourColors ? (c0[c] + 2 * c1[c] + 1) / 3 : 0;
+            }
+
+            Bc1Candidate candidate;
+            candidate.color0 = color0;
+            candidate.color1 = color1;
+            candidate.error = 0;
+            for (size_t i = 0; i < BLOCK_TEXELS; ++i)
+            {
+                uint8_t const* texel = texels + 4 * i;
+                if (texel[3] < 128)
+                {
+                    candidate.indices[i] = 3;
+                    continue;
+                }
+
+                int bestError = std::numeric_limits<int>::max();
+                for (uint8_t entry = 0; entry < (fourColors ? 4 : 3); ++entry)
+                {
+                    int error = 0;
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        int diff = palette[entry][c] - texel[c];
+                        error += diff * diff;
+                    }
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        candidate.indices[i] = entry;
+                    }
+                }
+                candidate.error += static_cast<float>(bestError);
+            }
+            return candidate;
+        }
+
+        // ---- BC7 ----
+
+        constexpr int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        struct Bc7Candidate
+        {
+            // 7-bit endpoints and their p-bits
+            uint8_t endpoint0[4] = {};
+            uint8_t endpoint1[4] = {};
+            uint8_t pbit0 = 0;
+            uint8_t pbit1 = 0;
+            uint8_t indices[BLOCK_TEXELS] = {};
+            float error = std::numeric_limits<float>::max();
+        };
+
+        Bc7Candidate selectBc7(Color<4> const& e0, Color<4> const& e1, uint8_t pbit0, uint8_t pbit1, Color<4> const* texels)
+        {
+            Bc7Candidate candidate;
+            candidate.pbit0 = pbit0;
+            candidate.pbit1 = pbit1;
+            int lo[4], hi[4];
+            for (size_t c = 0; c < 4; ++c)
+            {
+                // the endpoint is (value << 1) | pbit
+                candidate.endpoint0[c] = static_cast<uint8_t>(std::clamp(std::lround((e0[c] - pbit0) / 2.f), 0L, 127L));
+                candidate.endpoint1[c] = static_cast<uint8_t>(std::clamp(std::lround((e1[c] - pbit1) / 2.f), 0L, 127L));
+                lo[c] = candidate.endpoint0[c] << 1 | pbit0;
+                hi[c] = candidate.endpoint1[c] << 1 | pbit1;
+            }
+
+            int palette[16][4];
+            for (size_t entry = 0; entry < 16; ++entry)
+            {
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    palette[entry][c] = ((64 - BC7_WEIGHTS[entry]) * lo[c] + BC7_WEIGHTS[entry] * hi[c] + 32) >> 6;
+                }
+            }
+
+            // project onto the endpoint line for a first guess, then settle between the neighbors
+            float axis[4];
+            float axisLength2 = 0;
+            for (size_t c = 0; c < 4; ++c)
+            {
+                axis[c] = static_cast<float>(hi[c] - lo[c]);
+                axisLength2 += axis[c] * axis[c];
+            }
+
+            candidate.error = 0;
+            for (size_t i = 0; i < BLOCK_TEXELS; ++i)
+            {
+                int guess = 0;
+                if (axisLength2 > 0)
+                {
+                    float t = 0;
+                    for (size_t c = 0; c < 4; ++c)
+                    {
+                        t += (texels[i][c] - static_cast<float>(lo[c])) * axis[c];
+                    }
+                    float weight = std::clamp(t / axisLength2, 0.f, 1.f) * 64.f;
+                    guess = static_cast<int>(std::lower_bound(std::begin(BC7_WEIGHTS), std::end(BC7_WEIGHTS), weight) -
+                                             std::begin(BC7_WEIGHTS));
+                }
+
+                float bestError = std::numeric_limits<float>::max();
+                for (int entry = std::max(guess - 1, 0); entry <= std::min(guess + 1, 15); ++entry)
+                {
+                    float error = 0;
+                    for (size_t c = 0; c < 4; ++c)
+                    {
+                        float diff = static_cast<float>(palette[entry][c]) - texels[i][c];
+                        error += diff * diff;
+                    }
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        candidate.indices[i] = static_cast<uint8_t>(entry);
+                    }
+                }
+                candidate.error += bestError;
+            }
+            return candidate;
+        }
+
+        // appends bits least significant first, as BC7 blocks are laid out
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(uint8_t* dst) : dst(dst)
+            {
+                memset(dst, 0, BC7_BLOCK_BYTES);
+            }
+
+            void write(uint32_t value, uint32_t bits)
+            {
+                for (uint32_t bit = 0; bit < bits; ++bit, ++pos)
+                {
+                    dst[pos / 8] |= static_cast<uint8_t>(((value >> bit) & 1) << (pos % 8));
+                }
+            }
+
+        private:
+            uint8_t* dst;
+            uint32_t pos = 0;
+        };
+    }
+
+    uint32_t mipLevelCount(uint32_t width, uint32_t height, uint32_t depth)
+    {
+        uint32_t largest = std::max({ width, height, depth, 1u });
+        uint32_t levels = 1;
+        while (largest >>= 1)
+        {
+            ++levels;
+        }
+        return levels;
+    }
+
+    uint64_t mipChainSizeRgba8(uint32_t width, uint32_t height, uint32_t mipLevels)
+    {
+        uint64_t total = 0;
+        for (uint32_t level = 0; level < mipLevels; ++level)
+        {
+            total += encodedSize(BakedTexture::Encoding::RGBA8, std::max(width >> level, 1u), std::max(height >> level, 1u));
+        }
+        return total;
+    }
+
+    void generateMipsRgba8(uint8_t* chain, uint32_t width, uint32_t height, uint32_t mipLevels, bool srgb)
+    {
+        uint8_t* src = chain;
+        for (uint32_t level = 1; level < mipLevels; ++level)
+        {
+            uint32_t srcWidth = std::max(width >> (level - 1), 1u);
+            uint32_t srcHeight = std::max(height >> (level - 1), 1u);
+            uint8_t* dst = src + size_t(srcWidth) * srcHeight * 4;
+            downsampleRgba8(src, srcWidth, srcHeight, dst, srgb);
+            src = dst;
+        }
+    }
+
+    uint64_t encodedSize(BakedTexture::Encoding encoding, uint32_t width, uint32_t height)
+    {
+        uint64_t blocks = uint64_t((width + BLOCK_DIM - 1) / BLOCK_DIM) * ((height + BLOCK_DIM - 1) / BLOCK_DIM);
+        switch (encoding)
+        {
+            case BakedTexture::Encoding::RGBA8:
+                return uint64_t(width) * height * 4;
+            case BakedTexture::Encoding::BC1:
+                return blocks * BC1_BLOCK_BYTES;
+            case BakedTexture::Encoding::BC7:
+                return blocks * BC7_BLOCK_BYTES;
+        }
+        throw std::runtime_error("Unknown texture encoding!");
+    }
+
+    void encodeBc1Block(uint8_t const* texels, uint8_t* dst)
+    {
+        // transparent texels take index 3 of the 3-color mode and are left out of the fit
+        Color<3> opaque[BLOCK_TEXELS];
+        size_t opaqueCount = 0;
+        for (size_t i = 0; i < BLOCK_TEXELS; ++i)
+        {
+            if (texels[4 * i + 3] >= 128)
+            {
+                opaque[opaqueCount++] = { float(texels[4 * i]), float(texels[4 * i + 1]), float(texels[4 * i + 2]) };
+            }
+        }
+        bool transparent = opaqueCount < BLOCK_TEXELS;
+
+        Bc1Candidate best;
+        if (opaqueCount == 0)
+        {
+            best = selectBc1(0, 0, texels);
+        }
+        else
+        {
+            Color<3> e0, e1;
+            fitPrincipalAxis(opaque, opaqueCount, e0, e1);
+            for (int iteration = 0; iteration < 3; ++iteration)
+            {
+                uint16_t color0 = packRgb565(e0);
+                uint16_t color1 = packRgb565(e1);
+                // the order of the endpoints selects the mode
+                if ((color0 < color1) != transparent)
+                {
+                    std::swap(color0, color1);
+                    std::swap(e0, e1);
+                }
+
+                Bc1Candidate candidate = selectBc1(color0, color1, texels);
+                if (candidate.error < best.error)
+                {
+                    best = candidate;
+                }
+                if (candidate.error == 0 || color0 == color1)
+                {
+                    break;
+                }
+
+                // weight of color0 for each palette entry of the mode
+                float const modeWeights[4] = { 1.f, 0.f, transparent ? 0.5f : 2.f / 3.f, 1.f / 3.f };
+                float weights[BLOCK_TEXELS];
+                size_t opaqueIndex = 0;
+                for (size_t i = 0; i < BLOCK_TEXELS; ++i)
+                {
+                    if (texels[4 * i + 3] >= 128)
+                    {
+                        weights[opaqueIndex++] = modeWeights[candidate.indices[i]];
+                    }
+                }
+                refineLeastSquares(opaque, weights, opaqueCount, e0, e1);
+            }
+        }
+
+        uint32_t indices = 0;
+        for (size_t i = 0; i < BLOCK_TEXELS; ++i)
+        {
+            // with equal endpoints the 4-color mode is not available; any of 0-2 is the same color
+            uint32_t index = best.color0 == best.color1 && best.indices[i] != 3 ? 0 : best.indices[i];
+            indices |= index << (2 * i);
+        }
+        memcpy(dst, &best.color0, sizeof(uint16_t));
+        memcpy(dst + 2, &best.color1, sizeof(uint16_t));
+        memcpy(dst + 4, &indices, sizeof(uint32_t));
+    }
+
+    void encodeBc7Block(uint8_t const* texels, uint8_t* dst)
+    {
+        Color<4> colors[BLOCK_TEXELS];
+        for (size_t i = 0; i < BLOCK_TEXELS; ++i)
+        {
+            for (size_t c = 0; c < 4; ++c)
+            {
+                colors[i][c] = texels[4 * i + c];
+            }
+        }
+
+        Color<4> fit0, fit1;
+        fitPrincipalAxis(colors, BLOCK_TEXELS, fit0, fit1);
+
+        Bc7Candidate best;
+        for (uint8_t pbits = 0; pbits < 4; ++pbits)
+        {
+            Color<4> e0 = fit0, e1 = fit1;
+            for (int iteration = 0; iteration < 2; ++iteration)
+            {
+                Bc7Candidate candidate = selectBc7(e0, e1, pbits & 1, pbits >> 1, colors);
+                if (candidate.error < best.error)
+                {
+                    best = candidate;
+                }
+                if (candidate.error == 0)
+                {
+                    break;
+                }
+
+                float weights[BLOCK_TEXELS];
+                for (size_t i = 0; i < BLOCK_TEXELS; ++i)
+                {
+                    weights[i] = static_cast<float>(64 - BC7_WEIGHTS[candidate.indices[i]]) / 64.f;
+                }
+                refineLeastSquares(colors, weights, BLOCK_TEXELS, e0, e1);
+            }
+        }
+
+        // the first index is stored without its top bit, which must therefore be 0
+        if (best.indices[0] & 8)
+        {
+            std::swap(best.endpoint0, best.endpoint1);
+            std::swap(best.pbit0, best.pbit1);
+            for (auto& index : best.indices)
+            {
+                index = static_cast<uint8_t>(15 - index);
+            }
+        }
+
+        BitWriter bits(dst);
+        // mode 6
+        bits.write(1 << 6, 7);
+        for (size_t c = 0; c < 4; ++c)
+        {
+            bits.write(best.endpoint0[c], 7);
+            bits.write(best.endpoint1[c], 7);
+        }
+        bits.write(best.pbit0, 1);
+        bits.write(best.pbit1, 1);
+        for (size_t i = 0; i < BLOCK_TEXELS; ++i)
+        {
+            bits.write(best.indices[i], i == 0 ? 3 : 4);
+        }
+    }
+
+    std::vector<uint8_t> encodeBlocks(
+            uint8_t const* rgba, uint32_t width, uint32_t height, BakedTexture::Encoding encoding, ThreadPool* pool)
+    {
+        if (encoding != BakedTexture::Encoding::BC1 && encoding != BakedTexture::Encoding::BC7)
+        {
+            throw std::runtime_error("Not a block compressed texture encoding!");
+        }
+        size_t blockBytes = encoding == BakedTexture::Encoding::BC1 ? BC1_BLOCK_BYTES : BC7_BLOCK_BYTES;
+        uint32_t blocksWide = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+        uint32_t blocksHigh = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+        std::vector<uint8_t> blocks(encodedSize(encoding, width, height));
+
+        auto encodeRows = [&](size_t begin, size_t end)
+        {
+            uint8_t texels[BLOCK_TEXELS * 4];
+            for (size_t blockY = begin; blockY < end; ++blockY)
+            {
+                for (uint32_t blockX = 0; blockX < blocksWide; ++blockX)
+                {
+                    for (uint32_t y = 0; y < BLOCK_DIM; ++y)
+                    {
+                        size_t srcY = std::min<size_t>(blockY * BLOCK_DIM + y, height - 1);
+                        for (uint32_t x = 0; x < BLOCK_DIM; ++x)
+                        {
+                            size_t srcX = std::min<size_t>(size_t(blockX) * BLOCK_DIM + x, width - 1);
+                            memcpy(texels + 4 * (y * BLOCK_DIM + x), rgba + 4 * (srcY * width + srcX), 4);
+                        }
+                    }
+
+                    uint8_t* dst = blocks.data() + (blockY * blocksWide + blockX) * blockBytes;
+                    if (encoding == BakedTexture::Encoding::BC1)
+                    {
+                        encodeBc1Block(texels, dst);
+                    }
+                    else
+                    {
+                        encodeBc7Block(texels, dst);
+                    }
+                }
+            }
+        };
+
+        if (pool)
+        {
+            pool->parallelFor(blocksHigh, encodeRows, 4);
+        }
+        else
+        {
+            encodeRows(0, blocksHigh);
+        }
+        return blocks;
+    }
+
+    bool write(
+            std::string const& file, BakedTexture::Encoding encoding, bool srgb, uint32_t width, uint32_t height,
+            std::vector<std::vector<uint8_t>> const& levels)
+    {
+        auto alignUp = [](uint64_t value)
+        {
+            return (value + BakedTexture::LEVEL_ALIGNMENT - 1) & ~uint64_t(BakedTexture::LEVEL_ALIGNMENT - 1);
+        };
+
+        BakedTexture::Header hdr = {};
+        hdr.magic = BakedTexture::TEXTURE_MAGIC;
+        hdr.version = BakedTexture::TEXTURE_VERSION;
+        hdr.encoding = encoding;
+        hdr.srgb = srgb ? 1 : 0;
+        hdr.width = width;
+        hdr.height = height;
+        hdr.mipLevels = static_cast<uint32_t>(levels.size());
+
+        std::vector<BakedTexture::Level> levelTable(levels.size());
+        uint64_t offset = alignUp(sizeof(BakedTexture::Header) + levels.size() * sizeof(BakedTexture::Level));
+        for (size_t level = 0; level < levels.size(); ++level)
+        {
+            levelTable[level] = { offset, levels[level].size() };
+            offset = alignUp(offset + levels[level].size());
+        }
+
+        std::string tmpFile = file + ".tmp";
+        {
+            std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                return false;
+            }
+
+            char const padding[BakedTexture::LEVEL_ALIGNMENT] = {};
+            out.write(reinterpret_cast<char const*>(&hdr), sizeof(BakedTexture::Header));
+            out.write(reinterpret_cast<char const*>(levelTable.data()),
+                      static_cast<std::streamsize>(levelTable.size() * sizeof(BakedTexture::Level)));
+            uint64_t written = sizeof(BakedTexture::Header) + levelTable.size() * sizeof(BakedTexture::Level);
+            for (size_t level = 0; level < levels.size(); ++level)
+            {
+                out.write(padding, static_cast<std::streamsize>(levelTable[level].offset - written));
+                out.write(reinterpret_cast<char const*>(levels[level].data()),
+                          static_cast<std::streamsize>(levels[level].size()));
+                written = levelTable[level].offset + levels[level].size();
+            }
+
+            if (!out)
+            {
+                out.close();
+                std::filesystem::remove(tmpFile);
+                return false;
+            }
+        }
+
+        std::error_code err;
+        std::filesystem::rename(tmpFile, file, err);
+        if (err)
+        {
+            std::filesystem::remove(tmpFile, err);
+            return false;
+        }
+        return true;
+    }
+}
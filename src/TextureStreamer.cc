@@ -0,0 +1,389 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "TextureStreamer.h"
+#include "DisposableCmdBuffer.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+
+TextureStreamer::TextureStreamer(
+        VkDevice* dev, VmaAllocator* allocator, VkPhysicalDevice const& physicalDev,
+        VkQueue const& graphicsQueue, VkCommandPool* graphicsCmdPool,
+        std::set<uint32_t> const& transferQueues,
+        VkDeviceSize budget) :
+        AVkGraphicsBase(dev), allocator(allocator), physicalDev(physicalDev),
+        graphicsQueue(graphicsQueue), cmdPool(graphicsCmdPool), transferQueues(transferQueues), budget(budget)
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    if (!initialized())
+    {
+        return;
+    }
+
+    for (auto& texture : textures)
+    {
+        cancel(*texture);
+        vkDestroyFence(getLogicalDev(), texture->fence, nullptr);
+    }
+}
+
+size_t TextureStreamer::add(BakedTexture&& source, VkSamplerCreateInfo const& samplerInfo)
+{
+    auto texture = std::make_unique<Texture>();
+    texture->source = std::move(source);
+    texture->samplerInfo = samplerInfo;
+
+    uint32_t mipLevels = texture->source.mipLevels();
+    uint32_t tailLevel = 0;
+    while (tailLevel + 1 < mipLevels &&
+           std::max(texture->source.width() >> tailLevel, texture->source.height() >> tailLevel) > TAIL_EXTENT)
+    {
+        ++tailLevel;
+    }
+    texture->tailLevel = tailLevel;
+    texture->level = tailLevel;
+    texture->wanted = tailLevel;
+
+    // the tail is small and needed before the first frame
+    std::vector<VkDeviceSize> offsets = texture->source.levelOffsets();
+    std::vector<VkDeviceSize> levelOffsets;
+    for (uint32_t level = tailLevel; level < mipLevels; ++level)
+    {
+        levelOffsets.push_back(offsets[level] - offsets[tailLevel]);
+    }
+    Buffers::StagingBuffer staging(
+            &getLogicalDev(), allocator, physicalDev, chainBytes(*texture, tailLevel),
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            transferQueues);
+    if (!texture->source.readLevels(tailLevel, mipLevels - tailLevel, staging.mapped()))
+    {
+        throw std::runtime_error("Cannot read texture levels!");
+    }
+
+    texture->image = createImage(*texture, tailLevel);
+    DisposableCmdBuffer dcb(&getLogicalDev(), cmdPool);
+    texture->image.cmdTransitionBeginCopy(dcb.commandBuffer());
+    texture->image.cmdCopyFromBuffer(staging, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, dcb.commandBuffer(), levelOffsets);
+    texture->image.cmdTransitionEndCopy(dcb.commandBuffer());
+    dcb.finish();
+    CHECK_VK_SUCCESS(dcb.submit(graphicsQueue), ErrorMessages::FAILED_CANNOT_SUBMIT_QUEUE);
+    CHECK_VK_SUCCESS(vkQueueWaitIdle(graphicsQueue), ErrorMessages::FAILED_WAIT_IDLE);
+
+    VkFenceCreateInfo fenceCreateInfo = {};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    CHECK_VK_SUCCESS(vkCreateFence(getLogicalDev(), &fenceCreateInfo, nullptr, &texture->fence), "Cannot create Fence!");
+    textures.push_back(std::move(texture));
+    return textures.size() - 1;
+}
+
+void TextureStreamer::request(size_t texture, uint32_t level)
+{
+    Texture& entry = *textures[texture];
+    entry.wanted = std::min(entry.wanted, level);
+}
+
+void TextureStreamer::update()
+{
+    ++frame;
+    // the frames recorded before an image was retired have completed by now
+    retired.erase(
+            std::remove_if(retired.begin(), retired.end(), [this](Retired const& old)
+            {
+                return old.frame + MAX_FRAMES_IN_FLIGHT <= frame;
+            }),
+            retired.end());
+
+    size_t pendingCount = 0;
+    // bytes resident once the changes in flight complete
+    VkDeviceSize total = 0;
+    for (auto& texture : textures)
+    {
+        if (texture->pending)
+        {
+            bool done = false;
+            try
+            {
+                done = advance(*texture);
+            }
+            catch (std::exception const& e)
+            {
+                std::cerr << "Texture streaming failed: " << e.what() << std::endl;
+                cancel(*texture);
+                texture->failed = true;
+            }
+
+            if (done)
+            {
+                retired.push_back({ std::move(texture->image), frame });
+                texture->image = std::move(texture->pending->image);
+                texture->level = texture->pending->level;
+                texture->pending = nullopt;
+                ++texture->version;
+            }
+        }
+
+        if (texture->pending)
+        {
+            ++pendingCount;
+            total += chainBytes(*texture, texture->pending->level);
+        }
+        else
+        {
+            total += chainBytes(*texture, texture->level);
+        }
+    }
+
+    for (auto& texture : textures)
+    {
+        uint32_t wanted = std::min(texture->wanted, texture->tailLevel);
+        texture->wanted = texture->tailLevel;
+        if (texture->pending || texture->failed)
+        {
+            continue;
+        }
+
+        VkDeviceSize current = chainBytes(*texture, texture->level);
+        if (wanted < texture->level)
+        {
+            texture->framesUnwanted = 0;
+            // the finest level that fits the budget next to the other textures
+            VkDeviceSize others = total - current;
+            while (wanted < texture->level && others + chainBytes(*texture, wanted) > budget)
+            {
+                ++wanted;
+            }
+            if (wanted < texture->level && pendingCount < MAX_PENDING)
+            {
+                begin(*texture, wanted);
+                ++pendingCount;
+                total = others + chainBytes(*texture, wanted);
+            }
+        }
+        else if (wanted > texture->level)
+        {
+            if (++texture->framesUnwanted >= EVICT_DELAY_FRAMES || total > budget)
+            {
+                begin(*texture, wanted);
+                total = total - current + chainBytes(*texture, wanted);
+            }
+        }
+        else
+        {
+            texture->framesUnwanted = 0;
+        }
+    }
+
+    // still over budget with every level in use: drop the finest level of the largest textures
+    while (total > budget)
+    {
+        Texture* largest = nullptr;
+        for (auto& texture : textures)
+        {
+            if (!texture->pending && !texture->failed && texture->level < texture->tailLevel &&
+                (!largest || chainBytes(*texture, texture->level) > chainBytes(*largest, largest->level)))
+            {
+                largest = texture.get();
+            }
+        }
+        if (!largest)
+        {
+            break;
+        }
+
+        total -= chainBytes(*largest, largest->level) - chainBytes(*largest, largest->level + 1);
+        begin(*largest, largest->level + 1);
+    }
+}
+
+Image::Image& TextureStreamer::image(size_t texture)
+{
+    return textures[texture]->image;
+}
+
+uint64_t TextureStreamer::version(size_t texture) const
+{
+    return textures[texture]->version;
+}
+
+uint32_t TextureStreamer::residentLevel(size_t texture) const
+{
+    return textures[texture]->level;
+}
+
+BakedTexture const& TextureStreamer::source(size_t texture) const
+{
+    return textures[texture]->source;
+}
+
+VkDeviceSize TextureStreamer::residentBytes() const
+{
+    VkDeviceSize total = 0;
+    for (auto const& texture : textures)
+    {
+        total += chainBytes(*texture, texture->level);
+    }
+    return total;
+}
+
+void TextureStreamer::setBudget(VkDeviceSize bytes)
+{
+    budget = bytes;
+}
+
+VkDeviceSize TextureStreamer::chainBytes(Texture const& texture, uint32_t level) const
+{
+    VkDeviceSize bytes = 0;
+    auto const& levels = texture.source.levels();
+    for (uint32_t i = level; i < levels.size(); ++i)
+    {
+        bytes += levels[i].size;
+    }
+    return bytes;
+}
+
+Image::Image TextureStreamer::createImage(Texture const& texture, uint32_t level)
+{
+    std::pair<uint32_t, uint32_t> size = {
+            std::max(texture.source.width() >> level, 1u), std::max(texture.source.height() >> level, 1u) };
+    return Image::Image(
+            &getLogicalDev(), allocator, size,
+            texture.source.format(),
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            texture.samplerInfo,
+            nullopt,
+            VK_IMAGE_TILING_OPTIMAL,
+            texture.source.mipLevels() - level);
+}
+
+void TextureStreamer::begin(Texture& texture, uint32_t level)
+{
+    Pending pending;
+    pending.level = level;
+    pending.image = createImage(texture, level);
+
+    if (level < texture.level)
+    {
+        // only the levels the current image lacks come from the file
+        std::vector<VkDeviceSize> offsets = texture.source.levelOffsets();
+        pending.staging = std::make_shared<Buffers::StagingBuffer>(
+                &getLogicalDev(), allocator, physicalDev, offsets[texture.level] - offsets[level],
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                transferQueues);
+
+        BakedTexture const* source = &texture.source;
+        uint8_t* dst = pending.staging->mapped();
+        uint32_t levelCount = texture.level - level;
+        pending.read = ThreadPool::shared().submit([source, level, levelCount, dst]()
+        {
+            if (!source->readLevels(level, levelCount, dst))
+            {
+                throw std::runtime_error("Cannot read texture levels!");
+            }
+        });
+    }
+
+    texture.pending = std::move(pending);
+}
+
+bool TextureStreamer::advance(Texture& texture)
+{
+    Pending& pending = *texture.pending;
+    if (!pending.submitted)
+    {
+        if (pending.read.valid())
+        {
+            if (pending.read.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                return false;
+            }
+            // rethrows a failed read
+            pending.read.get();
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = *cmdPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        CHECK_VK_SUCCESS(vkAllocateCommandBuffers(getLogicalDev(), &allocateInfo, &pending.cmdBuffer),
+                         ErrorMessages::FAILED_CANNOT_CREATE_CMD_BUFFER);
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        CHECK_VK_SUCCESS(vkBeginCommandBuffer(pending.cmdBuffer, &beginInfo),
+                         ErrorMessages::FAILED_CANNOT_BEGIN_CMD_BUFFER);
+
+        pending.image.cmdTransitionBeginCopy(pending.cmdBuffer);
+        if (pending.staging)
+        {
+            std::vector<VkDeviceSize> offsets = texture.source.levelOffsets();
+            std::vector<VkDeviceSize> levelOffsets;
+            for (uint32_t level = pending.level; level < texture.level; ++level)
+            {
+                levelOffsets.push_back(offsets[level] - offsets[pending.level]);
+            }
+            pending.image.cmdCopyFromBuffer(
+                    *pending.staging, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, pending.cmdBuffer, levelOffsets);
+        }
+
+        // the levels both images hold are copied on the GPU
+        uint32_t firstShared = std::max(pending.level, texture.level);
+        pending.image.cmdCopyLevelsFrom(
+                texture.image, firstShared - texture.level, firstShared - pending.level,
+                texture.source.mipLevels() - firstShared, pending.cmdBuffer);
+        pending.image.cmdTransitionEndCopy(pending.cmdBuffer);
+
+        CHECK_VK_SUCCESS(vkEndCommandBuffer(pending.cmdBuffer), ErrorMessages::FAILED_CANNOT_END_CMD_BUFFER);
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &pending.cmdBuffer;
+        CHECK_VK_SUCCESS(vkQueueSubmit(graphicsQueue, 1, &submitInfo, texture.fence),
+                         ErrorMessages::FAILED_CANNOT_SUBMIT_QUEUE);
+        pending.submitted = true;
+        return false;
+    }
+
+    if (vkGetFenceStatus(getLogicalDev(), texture.fence) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    CHECK_VK_SUCCESS(vkResetFences(getLogicalDev(), 1, &texture.fence), "Cannot reset Fence!");
+    vkFreeCommandBuffers(getLogicalDev(), *cmdPool, 1, &pending.cmdBuffer);
+    pending.cmdBuffer = VK_NULL_HANDLE;
+    return true;
+}
+
+void TextureStreamer::cancel(Texture& texture)
+{
+    if (!texture.pending)
+    {
+        return;
+    }
+
+    Pending& pending = *texture.pending;
+    if (pending.read.valid())
+    {
+        pending.read.wait();
+    }
+    if (pending.submitted)
+    {
+        CHECK_VK_SUCCESS(vkWaitForFences(getLogicalDev(), 1, &texture.fence, VK_TRUE, UINT64_MAX),
+                         ErrorMessages::FAILED_WAIT_IDLE);
+        CHECK_VK_SUCCESS(vkResetFences(getLogicalDev(), 1, &texture.fence), "Cannot reset Fence!");
+    }
+    if (pending.cmdBuffer != VK_NULL_HANDLE)
+    {
+        vkFreeCommandBuffers(getLogicalDev(), *cmdPool, 1, &pending.cmdBuffer);
+    }
+    texture.pending = nullopt;
+}
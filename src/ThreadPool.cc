@@ -0,0 +1,98 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+size_t ThreadPool::size() const
+{
+    return workers.size();
+}
+
+void ThreadPool::parallelFor(size_t count, std::function<void(size_t, size_t)> const& fn, size_t minRange)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // a few ranges per worker to even out uneven work
+    size_t rangeCount = std::min(workers.size() * 4, (count + minRange - 1) / std::max<size_t>(minRange, 1));
+    if (rangeCount <= 1)
+    {
+        fn(0, count);
+        return;
+    }
+
+    size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+    std::vector<std::future<void>> pending;
+    pending.reserve(rangeCount);
+    for (size_t begin = 0; begin < count; begin += rangeSize)
+    {
+        size_t end = std::min(count, begin + rangeSize);
+        pending.push_back(submit([&fn, begin, end]() { fn(begin, end); }));
+    }
+
+    // every range must finish before fn goes out of scope, even if one of them threw
+    for (auto& result : pending)
+    {
+        result.wait();
+    }
+    for (auto& result : pending)
+    {
+        result.get();
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty())
+            {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -71,3 +71,74 @@ std::array<VkVertexInputAttributeDescription, 3> NVertex::attributeDescription()
 
     return {atrPos, atrNormal, atrTexCoord};
 }
+
+QVertex QVertex::quantize(NVertex const& vert, glm::vec3 const& boundsMin, glm::vec3 const& boundsMax)
+{
+    glm::vec3 extent = boundsMax - boundsMin;
+    glm::vec3 rel = glm::vec3(
+            extent.x > 0.f ? (vert.pos.x - boundsMin.x) / extent.x : 0.f,
+            extent.y > 0.f ? (vert.pos.y - boundsMin.y) / extent.y : 0.f,
+            extent.z > 0.f ? (vert.pos.z - boundsMin.z) / extent.z : 0.f);
+
+    // octahedral mapping: project onto |x|+|y|+|z| = 1 and fold the lower half over
+    glm::vec3 n = vert.normal;
+    float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    glm::vec2 oct = l1 > 0.f ? glm::vec2(n.x, n.y) / l1 : glm::vec2(0.f);
+    if (l1 > 0.f && n.z < 0.f)
+    {
+        oct = glm::vec2(
+                (1.f - std::abs(oct.y)) * (oct.x >= 0.f ? 1.f : -1.f),
+                (1.f - std::abs(oct.x)) * (oct.y >= 0.f ? 1.f : -1.f));
+    }
+
+    QVertex qvert = {};
+    qvert.pos[0] = glm::packUnorm2x16(glm::vec2(rel.x, rel.y));
+    qvert.pos[1] = glm::packUnorm2x16(glm::vec2(rel.z, 0.f));
+    qvert.normal = glm::packSnorm2x16(oct);
+    qvert.texCoord = glm::packHalf2x16(vert.texCoord);
+    return qvert;
+}
+
+VkVertexInputBindingDescription QVertex::bindingDescription()
+{
+    VkVertexInputBindingDescription desc = {};
+    desc.binding = 0;
+    desc.stride = sizeof(QVertex);
+    desc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    return desc;
+}
+
+std::array<VkVertexInputAttributeDescription, 3> QVertex::attributeDescription()
+{
+    VkVertexInputAttributeDescription atrPos = {};
+    VkVertexInputAttributeDescription atrNormal = {};
+    VkVertexInputAttributeDescription atrTexCoord = {};
+
+    atrPos.binding = 0;
+    atrPos.location = 0;
+    atrPos.format = VK_FORMAT_R16G16B16A16_UNORM;
+    atrPos.offset = offsetof(QVertex, pos);
+
+    atrNormal.binding = 0;
+    atrNormal.location = 1;
+    atrNormal.format = VK_FORMAT_R16G16_SNORM;
+    atrNormal.offset = offsetof(QVertex, normal);
+
+    atrTexCoord.binding = 0;
+    atrTexCoord.location = 2;
+    atrTexCoord.format = VK_FORMAT_R16G16_SFLOAT;
+    atrTexCoord.offset = offsetof(QVertex, texCoord);
+
+    return {atrPos, atrNormal, atrTexCoord};
+}
+
+size_t vertexStride(VertexFormat format)
+{
+    return format == QUANTIZED_VERTEX ? sizeof(QVertex) : sizeof(NVertex);
+}
+
+size_t indexStride(VkIndexType type)
+{
+    return type == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
@@ -0,0 +1,208 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "VolumeBricks.h"
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace VolumeBricks
+{
+    namespace
+    {
+        uint64_t alignUp(uint64_t value)
+        {
+            return (value + BRICK_ALIGNMENT - 1) & ~uint64_t(BRICK_ALIGNMENT - 1);
+        }
+
+        template<typename TVoxel>
+        std::pair<uint16_t, uint16_t> extract(
+                TVoxel const* voxels, uint32_t width, uint32_t height, uint32_t depth,
+                uint32_t bx, uint32_t by, uint32_t bz, TVoxel* dst)
+        {
+            // first stored voxel, one apron before the brick; may be -1
+            int64_t x0 = int64_t(bx) * BRICK_DIM - APRON;
+            int64_t y0 = int64_t(by) * BRICK_DIM - APRON;
+            int64_t z0 = int64_t(bz) * BRICK_DIM - APRON;
+            auto clampTo = [](int64_t v, uint32_t extent)
+            {
+                return static_cast<uint64_t>(std::clamp<int64_t>(v, 0, int64_t(extent) - 1));
+            };
+            bool rowInside = x0 >= 0 && x0 + STORED_DIM <= width;
+
+            TVoxel minValue = std::numeric_limits<TVoxel>::max();
+            TVoxel maxValue = 0;
+            for (uint32_t z = 0; z < STORED_DIM; ++z)
+            {
+                uint64_t sz = clampTo(z0 + z, depth);
+                for (uint32_t y = 0; y < STORED_DIM; ++y)
+                {
+                    uint64_t sy = clampTo(y0 + y, height);
+                    TVoxel const* srcRow = voxels + (sz * height + sy) * width;
+                    TVoxel* dstRow = dst + (size_t(z) * STORED_DIM + y) * STORED_DIM;
+                    if (rowInside)
+                    {
+                        memcpy(dstRow, srcRow + x0, STORED_DIM * sizeof(TVoxel));
+                    }
+                    else
+                    {
+                        for (uint32_t x = 0; x < STORED_DIM; ++x)
+                        {
+                            dstRow[x] = srcRow[clampTo(x0 + x, width)];
+                        }
+                    }
+
+                    for (uint32_t x = 0; x < STORED_DIM; ++x)
+                    {
+                        minValue = std::min(minValue, dstRow[x]);
+                        maxValue = std::max(maxValue, dstRow[x]);
+                    }
+                }
+            }
+            return { minValue, maxValue };
+        }
+    }
+
+    size_t voxelBytes(VoxelFormat format)
+    {
+        switch (format)
+        {
+        case VoxelFormat::R8:
+            return 1;
+        case VoxelFormat::R16:
+            return 2;
+        }
+        return 0;
+    }
+
+    uint64_t storedBrickBytes(VoxelFormat format)
+    {
+        return uint64_t(STORED_DIM) * STORED_DIM * STORED_DIM * voxelBytes(format);
+    }
+
+    uint32_t brickCount(uint32_t voxels)
+    {
+        return (voxels + BRICK_DIM - 1) / BRICK_DIM;
+    }
+
+    std::pair<uint16_t, uint16_t> extractBrick(
+            uint8_t const* voxels, VoxelFormat format, uint32_t width, uint32_t height, uint32_t depth,
+            uint32_t bx, uint32_t by, uint32_t bz, uint8_t* dst)
+    {
+        if (format == VoxelFormat::R8)
+        {
+            return extract(voxels, width, height, depth, bx, by, bz, dst);
+        }
+        return extract(reinterpret_cast<uint16_t const*>(voxels), width, height, depth, bx, by, bz,
+                       reinterpret_cast<uint16_t*>(dst));
+    }
+
+    bool bake(
+            std::string const& file, uint8_t const* voxels, VoxelFormat format,
+            uint32_t width, uint32_t height, uint32_t depth, uint16_t emptyThreshold,
+            ThreadPool* pool)
+    {
+        Header hdr = {};
+        hdr.magic = VOLUME_MAGIC;
+        hdr.version = VOLUME_VERSION;
+        hdr.format = format;
+        hdr.brickDim = BRICK_DIM;
+        hdr.width = width;
+        hdr.height = height;
+        hdr.depth = depth;
+        hdr.emptyThreshold = emptyThreshold;
+        hdr.bricksX = brickCount(width);
+        hdr.bricksY = brickCount(height);
+        hdr.bricksZ = brickCount(depth);
+        if (voxelBytes(format) == 0 || width == 0 || height == 0 || depth == 0 ||
+            hdr.bricksX > MAX_BRICKS_PER_AXIS || hdr.bricksY > MAX_BRICKS_PER_AXIS || hdr.bricksZ > MAX_BRICKS_PER_AXIS)
+        {
+            return false;
+        }
+
+        size_t brickCountTotal = size_t(hdr.bricksX) * hdr.bricksY * hdr.bricksZ;
+        std::vector<Brick> bricks(brickCountTotal);
+        uint64_t brickBytes = storedBrickBytes(format);
+        uint64_t dataStart = alignUp(sizeof(Header) + brickCountTotal * sizeof(Brick));
+
+        std::string tmpFile = file + ".tmp";
+        {
+            std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                return false;
+            }
+
+            // the brick table is only known once every brick is summarized; written last
+            std::vector<char> zeros(dataStart, 0);
+            out.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+
+            std::vector<uint8_t> row(hdr.bricksX * brickBytes);
+            std::vector<std::pair<uint16_t, uint16_t>> ranges(hdr.bricksX);
+            char const padding[BRICK_ALIGNMENT] = {};
+            uint64_t offset = dataStart;
+            for (uint32_t bz = 0; bz < hdr.bricksZ && out; ++bz)
+            {
+                for (uint32_t by = 0; by < hdr.bricksY && out; ++by)
+                {
+                    auto extractRow = [&](size_t begin, size_t end)
+                    {
+                        for (size_t bx = begin; bx < end; ++bx)
+                        {
+                            ranges[bx] = extractBrick(
+                                    voxels, format, width, height, depth,
+                                    static_cast<uint32_t>(bx), by, bz, row.data() + bx * brickBytes);
+                        }
+                    };
+                    if (pool)
+                    {
+                        pool->parallelFor(hdr.bricksX, extractRow, 1);
+                    }
+                    else
+                    {
+                        extractRow(0, hdr.bricksX);
+                    }
+
+                    for (uint32_t bx = 0; bx < hdr.bricksX; ++bx)
+                    {
+                        Brick& brick = bricks[(size_t(bz) * hdr.bricksY + by) * hdr.bricksX + bx];
+                        std::tie(brick.minValue, brick.maxValue) = ranges[bx];
+                        if (brick.maxValue <= emptyThreshold)
+                        {
+                            continue;
+                        }
+
+                        brick.offset = offset;
+                        out.write(reinterpret_cast<char const*>(row.data() + bx * brickBytes),
+                                  static_cast<std::streamsize>(brickBytes));
+                        uint64_t next = alignUp(offset + brickBytes);
+                        out.write(padding, static_cast<std::streamsize>(next - offset - brickBytes));
+                        offset = next;
+                    }
+                }
+            }
+
+            out.seekp(0);
+            out.write(reinterpret_cast<char const*>(&hdr), sizeof(Header));
+            out.write(reinterpret_cast<char const*>(bricks.data()),
+                      static_cast<std::streamsize>(bricks.size() * sizeof(Brick)));
+            if (!out)
+            {
+                out.close();
+                std::filesystem::remove(tmpFile);
+                return false;
+            }
+        }
+
+        std::error_code err;
+        std::filesystem::rename(tmpFile, file, err);
+        if (err)
+        {
+            std::filesystem::remove(tmpFile, err);
+            return false;
+        }
+        return true;
+    }
+}
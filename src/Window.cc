@@ -6,7 +6,14 @@
 #include "DisposableCmdBuffer.h"
 #include "helpers.h"
 #include "Mesh.h"
-
+#include "Culling.h"
+#include "PngDecoder.h"
+#include "BakedTexture.h"
+#include "AssetArchive.h"
+#include "TextureCodec.h"
+#include "ThreadPool.h"
+
+#include <filesystem>
 #include <utility>
 #include <chrono>
 
@@ -42,13 +49,21 @@ Window::Window(size_t const& width,
     CHECK_VK_SUCCESS(createCommandPool(), ErrorMessages::CREATE_COMMAND_POOL_FAILED);
     CHECK_VK_SUCCESS(createTransferCmdPool(), "Cannot create transfer command pool!");
 
-    meshStorage.emplace("teapot", std::make_unique<Mesh>(
-            &logicalDev, &allocator, &dev, helpers::searchPath("assets/teapot.obj")
-            ));
-
-    meshStorage.emplace("plane", std::make_unique<Mesh>(
-            &logicalDev, &allocator, &dev, helpers::searchPath("assets/plane.obj")
-            ));
+    // the pipeline is built for a single vertex format, so every mesh is imported with it
+    MeshImportOptions meshOptions;
+    meshOptions.vertexFormat = vertexFormat;
+    MeshImportOptions opaqueOptions = meshOptions;
+    opaqueOptions.optimizeOverdraw = true;
+    auto importMesh = [this](std::string const& name, MeshImportOptions const& options)
+    {
+        // kept by assets to import the mesh again when its file changes
+        return assets.loadMesh(name, options.cacheKey(), [this, name, options]()
+        {
+            return Mesh(&logicalDev, &allocator, &dev, name, options);
+        });
+    };
+    MeshHandle teapot = importMesh("assets/teapot.obj", opaqueOptions);
+    MeshHandle plane = importMesh("assets/plane.obj", meshOptions);
 
     glm::mat4 baseMat = glm::scale(glm::transpose(glm::mat4(
             0, 0, 1, 0,
@@ -57,8 +72,8 @@ Window::Window(size_t const& width,
             0, 0, 0, 1
     )), glm::vec3(0.15f));
 
-    drawables.emplace_back(meshStorage["teapot"].get(), baseMat);
-    drawables.emplace_back(meshStorage["plane"].get(), baseMat);
+    drawables.emplace_back(assets, teapot, baseMat);
+    drawables.emplace_back(assets, plane, baseMat);
 
     drawables[0].uniform.baseColor = glm::vec4(1,1,1,1);
     drawables[1].uniform.baseColor = glm::vec4(0.6,0.2,0.45,1);
@@ -69,17 +84,18 @@ Window::Window(size_t const& width,
     initBuffers();
 
     uniformData = std::make_unique<SwapchainImageBuffers>(
-            &logicalDev, &allocator, dev, *swapchainComponent, img, 0
+            &logicalDev, &allocator, dev, *swapchainComponent, sampledTexture(), 0
     );
+    boundTextureVersions.assign(swapchainComponent->imageCount(), textureVersion());
 
     graphicsPipeline = std::make_unique<GraphicsPipeline>(
             &logicalDev, dev, &cmdPool,
-            helpers::searchPath("main.vert.spv"), helpers::searchPath("main.frag.spv"),
+            "main.vert.spv", "main.frag.spv",
             swapchainComponent->swapchainExtent, swapchainComponent->imageCount(),
             swapchainComponent->renderPass,
             std::vector<VkDescriptorSetLayout> {
                 uniformData->descriptorSetLayout,
-                uniformData->meshDescriptorSetLayout}, true);
+                uniformData->meshDescriptorSetLayout}, true, vertexFormat);
 
     for (size_t i=0; i < MAX_FRAMES_IN_FLIGHT; ++i)
     {
@@ -88,7 +104,7 @@ Window::Window(size_t const& width,
 
     uniformData->configureMeshBuffers(0, *meshUniformGroup);
 
-
+    watchAssets();
 }
 
 int Window::mainLoop()
@@ -116,9 +132,33 @@ int Window::mainLoop()
 
 Window::~Window()
 {
+    for (auto& reload : meshReloads)
+    {
+        reload.import.wait();
+    }
+    for (auto& reload : textureReloads)
+    {
+        if (reload.read.valid())
+        {
+            reload.read.wait();
+        }
+        if (reload.submitted)
+        {
+            vkWaitForFences(logicalDev, 1, &reload.fence, VK_TRUE, UINT64_MAX);
+        }
+        vkDestroyFence(logicalDev, reload.fence, nullptr);
+    }
+    meshReloads.clear();
+    textureReloads.clear();
+    retiredMeshes.clear();
+    retiredTextures.clear();
+
     meshUniformGroup.reset();
     graphicsPipeline.reset();
     swapchainComponent.reset();
+    textureStreamer.reset();
+    residency.reset();
+    volume.reset();
 
     vkDestroyCommandPool(logicalDev, cmdTransferPool, nullptr);
     vkDestroyCommandPool(logicalDev, cmdPool, nullptr);
@@ -128,6 +168,7 @@ void Window::initCallbacks()
 {
     glfwSetWindowUserPointer(window, this);
     glfwSetWindowSizeCallback(window, Window::onWindowSizeChange);
+    glfwSetKeyCallback(window, Window::onKey);
 }
 
 void Window::recordCmd(uint32_t imageIdx, VkFence& submissionFence)
@@ -172,9 +213,47 @@ void Window::recordCmd(uint32_t imageIdx, VkFence& submissionFence)
 
     meshUniformGroup->beginFenceGroup(imageIdx, submissionFence);
 
+    auto frustum = Culling::Frustum::fromMatrix(projectMat * viewMatrix());
     for (auto& drawable : drawables)
     {
-        Mesh& mesh = drawable.getMesh();
+        Mesh& mesh = assets.mesh(drawable.getMesh());
+        size_t level = selectLod(mesh, drawable.uniform.model);
+        if (level == 0 && mesh.meshletCount() > 0)
+        {
+            Culling::visibleRanges(
+                    mesh.meshlets(), mesh.meshletCount(), drawable.uniform.model, frustum, cameraPos, drawRanges);
+            if (drawRanges.empty())
+            {
+                continue;
+            }
+        }
+        else
+        {
+            auto [boundsMin, boundsMax] = mesh.bounds();
+            glm::vec3 center = glm::vec3(drawable.uniform.model * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.f));
+            float radius = glm::length(boundsMax - boundsMin) * 0.5f * Culling::maxScale(drawable.uniform.model);
+            if (!frustum.intersectsSphere(center, radius))
+            {
+                continue;
+            }
+
+            auto lod = mesh.lod(level);
+            drawRanges.assign(1, {lod.firstIndex, lod.indexCount});
+        }
+
+        if (!residency->use(drawable.getMesh()))
+        {
+            continue;
+        }
+
+        if (streamedTexture)
+        {
+            BakedTexture const& texture = textureStreamer->source(*streamedTexture);
+            textureStreamer->request(
+                    *streamedTexture,
+                    selectTextureLevel(mesh, drawable.uniform.model, std::max(texture.width(), texture.height())));
+        }
+
         uint32_t offset_val = meshUniformGroup->placeNextData(drawable.uniform);
         uint32_t offsetvals[1] = { offset_val };
 
@@ -189,10 +268,13 @@ void Window::recordCmd(uint32_t imageIdx, VkFence& submissionFence)
         VkBuffer vertBuffers[] = { mesh.buf.vertexBuffer };
         VkDeviceSize offsets[] = {0};
         vkCmdBindVertexBuffers(cmdBuf, 0, 1, vertBuffers, offsets);
-        vkCmdBindIndexBuffer(cmdBuf, mesh.buf.vertexBuffer, mesh.idxOffset(), VK_INDEX_TYPE_UINT32);
+        vkCmdBindIndexBuffer(cmdBuf, mesh.buf.vertexBuffer, mesh.idxOffset(), mesh.indexType());
         // actual drawing command :)
         // vkCmdDraw(cmdBuf, vertexBuffer->getSize(), 1, 0, 0);
-        vkCmdDrawIndexed(cmdBuf, static_cast<uint32_t>(mesh.idxCount()), 1, 0, 0, 0);
+        for (auto const& [firstIndex, indexCount] : drawRanges)
+        {
+            vkCmdDrawIndexed(cmdBuf, indexCount, 1, firstIndex, 0, 0);
+        }
     }
 
     vkCmdEndRenderPass(cmdBuf);
@@ -223,6 +305,16 @@ void Window::drawFrame()
     VkFence& inFlightFence = frameSemaphores[currentFrame].inFlight;
 
     vkWaitForFences(logicalDev, 1, &inFlightFence, VK_TRUE, UINT64_MAX);
+    if (textureStreamer)
+    {
+        textureStreamer->update();
+    }
+    reloadAssets();
+    residency->update();
+    if (volume)
+    {
+        volume->update(Culling::Frustum::fromMatrix(projectMat * viewMatrix()), volumeModel, cameraPos);
+    }
 
     VkResult nextImgResult = vkAcquireNextImageKHR(
             logicalDev, swapchainComponent->swapChain, UINT64_MAX,
@@ -252,6 +344,13 @@ void Window::drawFrame()
     imgIdxFence = inFlightFence;
     // at this point, image is fully ours.
 
+    // so are its descriptor sets, which may still point at a texture image streaming or a reload replaced
+    if (boundTextureVersions[imgIndex] != textureVersion())
+    {
+        uniformData->setImage(imgIndex, sampledTexture());
+        boundTextureVersions[imgIndex] = textureVersion();
+    }
+
     vkResetCommandBuffer(graphicsPipeline->cmdBuffers[imgIndex], 0);
     recordCmd(imgIndex, inFlightFence);
 
@@ -340,16 +439,17 @@ void Window::resetSwapChain()
             depthBuffer.imgView);
 
     uniformData = std::make_unique<SwapchainImageBuffers>(
-            &logicalDev, &allocator, dev, *swapchainComponent, img, 0
+            &logicalDev, &allocator, dev, *swapchainComponent, sampledTexture(), 0
     );
+    boundTextureVersions.assign(swapchainComponent->imageCount(), textureVersion());
 
     graphicsPipeline = std::make_unique<GraphicsPipeline>(
             &logicalDev, dev, &cmdPool,
-            helpers::searchPath("main.vert.spv"), helpers::searchPath("main.frag.spv"),
+            "main.vert.spv", "main.frag.spv",
             swapchainComponent->swapchainExtent, swapchainComponent->imageCount(),
             swapchainComponent->renderPass,
             std::vector<VkDescriptorSetLayout> {uniformData->descriptorSetLayout, uniformData->meshDescriptorSetLayout},
-            true);
+            true, vertexFormat);
 
     uniformData->configureMeshBuffers(0, *meshUniformGroup);
 }
@@ -370,6 +470,77 @@ void Window::onWindowSizeChange(GLFWwindow* ptr, int width, int height)
     }
 }
 
+void Window::onKey(GLFWwindow* ptr, int key, int scancode, int action, int mods)
+{
+    auto* self = reinterpret_cast<Window*>(glfwGetWindowUserPointer(ptr));
+    if (action == GLFW_RELEASE)
+    {
+        return;
+    }
+
+    if (key == GLFW_KEY_LEFT_BRACKET || key == GLFW_KEY_RIGHT_BRACKET)
+    {
+        self->setLodBias(self->lodBias + (key == GLFW_KEY_RIGHT_BRACKET ? 0.5f : -0.5f));
+    }
+}
+
+void Window::setLodBias(float bias)
+{
+    lodBias = bias;
+}
+
+size_t Window::selectLod(Mesh const& mesh, glm::mat4 const& model) const
+{
+    size_t levels = mesh.lodCount();
+    if (levels == 1)
+    {
+        return 0;
+    }
+
+    float scale = Culling::maxScale(model);
+    float pixels = pixelsPerUnit(mesh, model);
+    // each +1 of bias doubles the tolerated error
+    float maxPixelError = std::exp2(lodBias);
+
+    size_t level = 0;
+    while (level + 1 < levels && mesh.lod(level + 1).error * scale * pixels <= maxPixelError)
+    {
+        ++level;
+    }
+    return level;
+}
+
+float Window::pixelsPerUnit(Mesh const& mesh, glm::mat4 const& model) const
+{
+    auto [boundsMin, boundsMax] = mesh.bounds();
+    glm::vec3 center = glm::vec3(model * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.f));
+    float radius = glm::length(boundsMax - boundsMin) * 0.5f * Culling::maxScale(model);
+    float distance = std::max(glm::distance(center, cameraPos) - radius, clipNear);
+
+    // inverse of the world space length covering one pixel at that distance
+    float viewportHeight = static_cast<float>(swapchainComponent->swapchainExtent.height);
+    return viewportHeight / (2.f * std::tan(glm::radians(fovDegrees) * 0.5f) * distance);
+}
+
+uint32_t Window::selectTextureLevel(Mesh const& mesh, glm::mat4 const& model, uint32_t textureExtent) const
+{
+    auto [boundsMin, boundsMax] = mesh.bounds();
+    glm::vec3 extent = boundsMax - boundsMin;
+    float longestSide = std::max({ extent.x, extent.y, extent.z }) * Culling::maxScale(model);
+    if (longestSide <= 0.f)
+    {
+        return 0;
+    }
+
+    // each level halves the texels covering a pixel; level 0 once there are fewer than 2
+    float texelsPerPixel = static_cast<float>(textureExtent) / longestSide / pixelsPerUnit(mesh, model);
+    if (texelsPerPixel < 2.f)
+    {
+        return 0;
+    }
+    return static_cast<uint32_t>(std::floor(std::log2(texelsPerPixel)));
+}
+
 
 VkResult Window::createCommandPool()
 {
@@ -400,13 +571,93 @@ void Window::initBuffers()
             0,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
-    helpers::img_r8g8b8a8 image = helpers::fromPng(helpers::searchPath("assets/smile.png"));
-    Buffers::StagingBuffer imageStgBuffer(
-            &logicalDev, &allocator, dev, image.totalSize(),
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            queueFamilyIndex.queuesForTransfer());
-    imageStgBuffer.loadData(image.imgData.data());
+    std::string textureName = "assets/smile.png";
+    optional<BakedTexture> baked = streamTextures ? openBakedTexture(textureName) : nullopt;
+    if (baked)
+    {
+        textureStreamer = std::make_unique<TextureStreamer>(
+                &logicalDev, &allocator, dev, graphicsQueue, &cmdPool, queueFamilyIndex.queuesForTransfer());
+        uint32_t mipLevels = baked->mipLevels();
+        streamedTexture = textureStreamer->add(std::move(*baked), textureSamplerInfo(mipLevels));
+    }
+    else
+    {
+        loadedTexture = assets.loadTexture(textureName, 0, [this, textureName]()
+        {
+            return loadTexture(textureName);
+        });
+    }
+
+    // meshes are uploaded as they are drawn, through a staging buffer of bounded size, and
+    // evicted when they no longer fit the budget; those drawn first go up front
+    residency = std::make_unique<ResidencyManager>(
+            &logicalDev, &allocator, dev, transferQueue, &cmdTransferPool,
+            queueFamilyIndex.queuesForTransfer(), assets);
+    residency->setBudget(meshBudget);
+    for (auto const& drawable : drawables)
+    {
+        residency->use(drawable.getMesh());
+    }
+    residency->update();
+
+    if (!volumeName.empty() && AssetFile::open(volumeName))
+    {
+        volume = std::make_unique<BrickedVolume>(
+                &logicalDev, &allocator, dev, graphicsQueue, &cmdPool, queueFamilyIndex.queuesForTransfer(),
+                volumeName);
+        auto const& hdr = volume->header();
+        float longestSide = static_cast<float>(std::max({ hdr.width, hdr.height, hdr.depth }));
+        volumeModel = glm::scale(glm::mat4(1.f), glm::vec3(1.f / longestSide));
+    }
+}
+
+optional<BakedTexture> Window::openBakedTexture(std::string const& name) const
+{
+    auto usable = [this](BakedTexture const& texture)
+    {
+        return (!texture.blockCompressed() || bcTextures) && Image::canSample(dev, texture.format());
+    };
+
+    optional<BakedTexture> baked;
+    if (std::filesystem::path(name).extension() != ".png")
+    {
+        baked = BakedTexture::open(AssetFile::open(name));
+        if (!baked || !usable(*baked))
+        {
+            throw std::runtime_error("Cannot load texture " + name);
+        }
+    }
+    else
+    {
+        // texBake output next to the PNG, when the GPU can sample its encoding
+        std::string bakedName = BakedTexture::bakedPath(name);
+        baked = BakedTexture::open(AssetFile::open(bakedName));
+        if (baked && !usable(*baked))
+        {
+            baked = nullopt;
+        }
+
+        // a PNG saved after it was baked is loaded as it is until it is baked again
+        std::string pngPath = helpers::searchPath(name);
+        std::string bakedPath = helpers::searchPath(bakedName);
+        if (baked && !pngPath.empty() && !bakedPath.empty())
+        {
+            std::error_code pngErr, bakedErr;
+            auto pngTime = std::filesystem::last_write_time(pngPath, pngErr);
+            auto bakedTime = std::filesystem::last_write_time(bakedPath, bakedErr);
+            if (!pngErr && !bakedErr && bakedTime < pngTime)
+            {
+                std::cerr << bakedName << " is older than " << name
+                          << ", loading the PNG instead; rebake it with texBake" << std::endl;
+                baked = nullopt;
+            }
+        }
+    }
+    return baked;
+}
 
+VkSamplerCreateInfo Window::textureSamplerInfo(uint32_t mipLevels) const
+{
     VkSamplerCreateInfo samplerInfo = {};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     samplerInfo.magFilter = VK_FILTER_LINEAR;
@@ -422,35 +673,344 @@ void Window::initBuffers()
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
+    samplerInfo.maxLod = static_cast<float>(mipLevels);
+    return samplerInfo;
+}
 
+Image::Image& Window::sampledTexture()
+{
+    return streamedTexture ? textureStreamer->image(*streamedTexture) : assets.texture(loadedTexture);
+}
+
+uint64_t Window::textureVersion() const
+{
+    return streamedTexture ? textureStreamer->version(*streamedTexture) : loadedTextureVersion;
+}
+
+Image::Image Window::loadTexture(std::string const& name)
+{
+    StagedTexture staged = stageTexture(name);
 
-    img = Image::Image(
-            &logicalDev, &allocator, image.size(),
-            VK_FORMAT_R8G8B8A8_SRGB,
-            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+    // uploaded on the graphics queue, which samples the texture and which vkCmdBlitImage needs
+    DisposableCmdBuffer dcb(&logicalDev, &cmdPool);
+    Image::Image texture = createTexture(staged, dcb.commandBuffer());
+    dcb.finish();
+    CHECK_VK_SUCCESS(dcb.submit(graphicsQueue), ErrorMessages::FAILED_CANNOT_SUBMIT_QUEUE);
+    CHECK_VK_SUCCESS(vkQueueWaitIdle(graphicsQueue), ErrorMessages::FAILED_WAIT_IDLE);
+    return texture;
+}
+
+Window::StagedTexture Window::stageTexture(std::string const& name)
+{
+    optional<BakedTexture> baked = openBakedTexture(name);
+    StagedTexture staged;
+    if (baked)
+    {
+        staged.size = { baked->width(), baked->height() };
+        staged.mipLevels = baked->mipLevels();
+        staged.format = baked->format();
+        staged.levelOffsets = baked->levelOffsets();
+        staged.staging = baked->stage(&logicalDev, &allocator, dev, queueFamilyIndex.queuesForTransfer());
+    }
+    else
+    {
+        // decoded row by row straight into the staging memory
+        std::vector<uint8_t> pngFile = helpers::readAsset(name);
+        PngDecoder decoder(pngFile.data(), pngFile.size());
+        uint32_t width = decoder.width();
+        uint32_t height = decoder.height();
+        staged.size = { width, height };
+        staged.mipLevels = TextureCodec::mipLevelCount(width, height);
+        staged.format = VK_FORMAT_R8G8B8A8_SRGB;
+        // without linear blits for the format, the levels below 0 are filtered here and staged too
+        staged.blitMips = Image::canBlitMips(dev, staged.format);
+        uint32_t stagedLevels = staged.blitMips ? 1 : staged.mipLevels;
+        for (uint32_t level = 0; level < stagedLevels; ++level)
+        {
+            staged.levelOffsets.push_back(TextureCodec::mipChainSizeRgba8(width, height, level));
+        }
+
+        staged.staging = std::make_shared<Buffers::StagingBuffer>(
+                &logicalDev, &allocator, dev,
+                TextureCodec::mipChainSizeRgba8(width, height, stagedLevels),
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                queueFamilyIndex.queuesForTransfer());
+        decoder.decodeRgba8(staged.staging->mapped(), size_t(width) * sizeof(uint32_t));
+        if (!staged.blitMips)
+        {
+            TextureCodec::generateMipsRgba8(staged.staging->mapped(), width, height, staged.mipLevels, true);
+        }
+    }
+    return staged;
+}
+
+Image::Image Window::createTexture(StagedTexture const& staged, VkCommandBuffer& cmdBuffer)
+{
+    Image::Image texture(
+            &logicalDev, &allocator, staged.size,
+            staged.format,
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            samplerInfo);
+            textureSamplerInfo(staged.mipLevels),
+            nullopt,
+            VK_IMAGE_TILING_OPTIMAL,
+            staged.mipLevels);
 
-    // submit in one batch
-    DisposableCmdBuffer dcb(&logicalDev, &cmdTransferPool);
+    texture.cmdTransitionBeginCopy(cmdBuffer);
+    texture.cmdCopyFromBuffer(*staged.staging, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmdBuffer, staged.levelOffsets);
+    if (staged.blitMips)
+    {
+        texture.cmdGenerateMips(cmdBuffer);
+    }
+    else
+    {
+        texture.cmdTransitionEndCopy(cmdBuffer);
+    }
+    return texture;
+}
 
-    std::vector<std::shared_ptr<Buffers::StagingBuffer>> meshStgBuffers;
-    for (auto& [name, meshPtr] : meshStorage)
+void Window::watchAssets()
+{
+    assetWatcher = std::make_unique<AssetWatcher>();
+    if (!*assetWatcher)
     {
-        auto stagingPtr = meshPtr->stagingBuffer(queueFamilyIndex.queuesForTransfer());
-        meshStgBuffers.push_back(stagingPtr);
-        meshPtr->buf.cmdCopyDataFrom(stagingPtr->vertexBuffer, dcb.commandBuffer());
+        assetWatcher.reset();
+        return;
     }
-    // vertexBuffer.cmdCopyDataFrom(stagingBuffer, dcb.commandBuffer());
-    // idxBuffer.cmdCopyDataFrom(stagingBufferIdx, dcb.commandBuffer());
-    img.cmdTransitionBeginCopy(dcb.commandBuffer());
-    img.cmdCopyFromBuffer(imageStgBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, dcb.commandBuffer());
-    img.cmdTransitionEndCopy(dcb.commandBuffer());
 
-    dcb.finish();
-    CHECK_VK_SUCCESS(dcb.submit(transferQueue), ErrorMessages::FAILED_CANNOT_SUBMIT_QUEUE);
-    CHECK_VK_SUCCESS(vkQueueWaitIdle(transferQueue), ErrorMessages::FAILED_WAIT_IDLE);
+    auto const* archive = AssetArchive::mounted();
+    auto watchFile = [this](std::string const& file, std::string const& assetName)
+    {
+        std::error_code error;
+        std::filesystem::path path = std::filesystem::canonical(file, error);
+        if (error || !assetWatcher->watch(path.parent_path().string()))
+        {
+            return;
+        }
+        watchedFiles[path.string()].push_back(assetName);
+    };
+
+    for (std::string const& name : assets.assetNames())
+    {
+        // archives are read-only: what they hold never changes while running
+        if (archive && archive->find(AssetArchive::normalizeName(name)))
+        {
+            continue;
+        }
+
+        std::string file = helpers::searchPath(name);
+        if (!file.empty())
+        {
+            watchFile(file, name);
+        }
+        // a texture may be loaded from the texture baked next to it instead
+        if (!assets.textureSources(name).empty())
+        {
+            std::string baked = helpers::searchPath(BakedTexture::bakedPath(name));
+            if (!baked.empty())
+            {
+                watchFile(baked, name);
+            }
+        }
+    }
+}
+
+void Window::reloadAssets()
+{
+    ++reloadFrame;
+    // the frames recorded before an asset was replaced have completed by now
+    auto unused = [this](auto const& old)
+    {
+        return old.frame + MAX_FRAMES_IN_FLIGHT <= reloadFrame;
+    };
+    retiredMeshes.erase(std::remove_if(retiredMeshes.begin(), retiredMeshes.end(), unused), retiredMeshes.end());
+    retiredTextures.erase(std::remove_if(retiredTextures.begin(), retiredTextures.end(), unused), retiredTextures.end());
+
+    if (assetWatcher)
+    {
+        for (std::string const& written : assetWatcher->poll())
+        {
+            std::error_code error;
+            auto watched = watchedFiles.find(std::filesystem::canonical(written, error).string());
+            if (error || watched == watchedFiles.end())
+            {
+                continue;
+            }
+
+            for (std::string const& name : watched->second)
+            {
+                for (auto const& source : assets.meshSources(name))
+                {
+                    startMeshReload(source);
+                }
+                for (auto const& source : assets.textureSources(name))
+                {
+                    startTextureReload(source.handle, name);
+                }
+            }
+        }
+    }
+
+    std::vector<AssetRegistry::Source<Mesh>> restartedMeshes;
+    for (auto reload = meshReloads.begin(); reload != meshReloads.end();)
+    {
+        if (reload->import.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++reload;
+            continue;
+        }
+
+        MeshHandle handle = reload->source.handle;
+        try
+        {
+            // rethrows a failed import
+            Mesh mesh = reload->import.get();
+            if (assets.contains(handle))
+            {
+                // drawn this frame already if the old mesh was, as the residency update uploads it
+                bool wasResident = assets.mesh(handle).resident();
+                retiredMeshes.push_back({ assets.replace(handle, std::move(mesh)), reloadFrame });
+                for (auto& drawable : drawables)
+                {
+                    if (drawable.getMesh() == handle)
+                    {
+                        assets.mesh(handle).setDequantization(drawable.uniform);
+                    }
+                }
+                if (wasResident)
+                {
+                    residency->use(handle);
+                }
+            }
+        }
+        catch (std::exception const& e)
+        {
+            // the old mesh stays until the file is fixed
+            std::cerr << "Cannot reload mesh: " << e.what() << std::endl;
+        }
+
+        if (reload->again)
+        {
+            restartedMeshes.push_back(reload->source);
+        }
+        reload = meshReloads.erase(reload);
+    }
+    for (auto const& source : restartedMeshes)
+    {
+        startMeshReload(source);
+    }
+
+    std::vector<std::pair<TextureHandle, std::string>> restartedTextures;
+    for (auto reload = textureReloads.begin(); reload != textureReloads.end();)
+    {
+        bool done = false;
+        try
+        {
+            if (!reload->submitted)
+            {
+                if (reload->read.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    ++reload;
+                    continue;
+                }
+                // rethrows a failed read
+                reload->read.get();
+
+                // copied on the graphics queue like loadTexture; nothing waits for it
+                reload->upload = std::make_unique<DisposableCmdBuffer>(&logicalDev, &cmdPool);
+                reload->image = createTexture(**reload->staged, reload->upload->commandBuffer());
+                reload->upload->finish();
+                CHECK_VK_SUCCESS(reload->upload->submit(graphicsQueue, reload->fence),
+                                 ErrorMessages::FAILED_CANNOT_SUBMIT_QUEUE);
+                reload->submitted = true;
+            }
+            else if (vkGetFenceStatus(logicalDev, reload->fence) == VK_SUCCESS)
+            {
+                done = true;
+                if (assets.contains(reload->handle))
+                {
+                    retiredTextures.push_back({ assets.replace(reload->handle, std::move(reload->image)), reloadFrame });
+                    if (reload->handle == loadedTexture)
+                    {
+                        ++loadedTextureVersion;
+                    }
+                }
+            }
+        }
+        catch (std::exception const& e)
+        {
+            // the old texture stays until the file is fixed
+            std::cerr << "Cannot reload texture " << reload->name << ": " << e.what() << std::endl;
+            done = true;
+        }
+
+        if (!done)
+        {
+            ++reload;
+            continue;
+        }
+
+        if (reload->submitted && vkGetFenceStatus(logicalDev, reload->fence) != VK_SUCCESS)
+        {
+            // failed after submitting: the copies may still be reading the staging buffer
+            vkWaitForFences(logicalDev, 1, &reload->fence, VK_TRUE, UINT64_MAX);
+        }
+        vkDestroyFence(logicalDev, reload->fence, nullptr);
+        if (reload->again)
+        {
+            restartedTextures.emplace_back(reload->handle, reload->name);
+        }
+        reload = textureReloads.erase(reload);
+    }
+    for (auto const& [handle, name] : restartedTextures)
+    {
+        startTextureReload(handle, name);
+    }
+}
+
+void Window::startMeshReload(AssetRegistry::Source<Mesh> const& source)
+{
+    for (auto& reload : meshReloads)
+    {
+        if (reload.source.handle == source.handle)
+        {
+            // the import running may have read the file before it was written
+            reload.again = true;
+            return;
+        }
+    }
+
+    MeshReload reload;
+    reload.source = source;
+    // a thread of its own rather than the ThreadPool: the import splits its work over the pool
+    // and waits for it, which a pool task must not do
+    reload.import = std::async(std::launch::async, source.load);
+    meshReloads.push_back(std::move(reload));
+}
+
+void Window::startTextureReload(TextureHandle handle, std::string const& name)
+{
+    for (auto& reload : textureReloads)
+    {
+        if (reload.handle == handle)
+        {
+            reload.again = true;
+            return;
+        }
+    }
+
+    TextureReload reload;
+    reload.handle = handle;
+    reload.name = name;
+    VkFenceCreateInfo fenceCreateInfo = {};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    CHECK_VK_SUCCESS(vkCreateFence(logicalDev, &fenceCreateInfo, nullptr, &reload.fence), "Cannot create Fence!");
+    reload.staged = std::make_shared<optional<StagedTexture>>();
+    reload.read = ThreadPool::shared().submit([this, staged = reload.staged, name]()
+    {
+        *staged = stageTexture(name);
+    });
+    textureReloads.push_back(std::move(reload));
 }
 
 void Window::setUniforms(UniformObjBuffer<UniformObjects>& bufObject)
@@ -462,16 +1022,21 @@ void Window::setUniforms(UniformObjBuffer<UniformObjects>& bufObject)
 
     UniformObjects ubo = {};
     ubo.time = totalTime / 1000.f;
-    ubo.view = glm::lookAt(
-            cameraPos,
-            O,
-            glm::vec3(1.f, -1.f, -1.f));
+    ubo.view = viewMatrix();
     ubo.proj = projectMat;
     ubo.cameraPos = glm::vec4(cameraPos, 1);
 
     CHECK_VK_SUCCESS(bufObject.loadData(ubo), "Cannot set uniforms!");
 }
 
+glm::mat4 Window::viewMatrix() const
+{
+    return glm::lookAt(
+            cameraPos,
+            glm::vec3(0, 0, 0),
+            glm::vec3(1.f, -1.f, -1.f));
+}
+
 void Window::setLights(StorageBufferArray<Light>& storageObj)
 {
     float t = sin(totalTime / 500);
@@ -318,10 +318,22 @@ VkResult WindowBase::createLogicalDevice()
 
     VkDeviceQueueCreateInfo queues[] = {createQueueInfo, presentationQueueInfo, transferQueueInfo};
 
+    VkPhysicalDeviceFeatures supported;
+    vkGetPhysicalDeviceFeatures(dev, &supported);
+
     VkPhysicalDeviceFeatures feat = {};
     feat.samplerAnisotropy = VK_TRUE;
+    // optional; baked BC1/BC7 textures are only used with it
+    feat.textureCompressionBC = supported.textureCompressionBC;
+    bcTextures = supported.textureCompressionBC == VK_TRUE;
 
     auto deviceExts = getRequiredDeviceExts();
+    // optional; lets VMA report each heap's actual budget instead of estimating it from the heap size
+    memoryBudgetExt = checkDeviceExtensionSupport(dev, { VK_EXT_MEMORY_BUDGET_EXTENSION_NAME });
+    if (memoryBudgetExt)
+    {
+        deviceExts.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
 
     VkDeviceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -362,6 +374,10 @@ VkResult WindowBase::createAllocator()
     createInfo.physicalDevice = dev;
     createInfo.device = logicalDev;
     createInfo.instance = instance;
+    if (memoryBudgetExt)
+    {
+        createInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
 
     return vmaCreateAllocator(&createInfo, &allocator);
 }
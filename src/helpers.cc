@@ -3,6 +3,10 @@
 //
 
 #include "helpers.h"
+#include "AssetArchive.h"
+#include "PngDecoder.h"
+
+#include <filesystem>
 
 constexpr char const* SEARCH_PATHS_ENV = "SEARCH_PATHS";
 
@@ -38,18 +42,22 @@ namespace helpers
             }
         }
 #else
-        char* base_buffer = getenv(SEARCH_PATHS_ENV);
+        char const* base_buffer = getenv(SEARCH_PATHS_ENV);
+        if (base_buffer == nullptr)
+        {
+            return {};
+        }
         auto base_buffer_data = std::make_unique<char[]>(strlen(base_buffer) + 1);
+        strcpy(base_buffer_data.get(), base_buffer);
 
         char* out = strtok(base_buffer_data.get(), ";");
-        out = strtok(nullptr, out);
         while (out)
         {
             if (fileExists(out, file))
             {
                 return std::string(out) + "/" + file;
             }
-            out = strtok(nullptr, out);
+            out = strtok(nullptr, ";");
         }
 #endif
         return {};
@@ -57,30 +65,89 @@ namespace helpers
 
     bool fileExists(std::string const& prefix, std::string const& file)
     {
-        std::ifstream fil(prefix + "/" + file);
-        return fil.operator bool();
+        // a stat, without opening the file
+        std::error_code err;
+        return std::filesystem::is_regular_file(prefix + "/" + file, err);
     }
 
-    img_r8g8b8a8 fromPng(std::string const& file)
+    std::vector<uint8_t> readAsset(std::string const& name)
     {
-        std::vector<uint32_t> im;
-        png::image<png::rgba_pixel> inputIm(file);
-
-        for (size_t i = 0; i < inputIm.get_width(); ++i)
+        if (auto const* archive = AssetArchive::mounted())
         {
-            for (size_t j=0; j < inputIm.get_height(); ++j)
+            if (auto const* entry = archive->find(AssetArchive::normalizeName(name)))
             {
-
-                auto colorData = inputIm.get_pixel(i,j);
-                uint32_t pixelData =
-                        colorData.red |
-                        colorData.green << (sizeof(uint8_t) * 8) |
-                        colorData.blue << (2 * sizeof(uint8_t) * 8) |
-                        colorData.alpha << (3 * sizeof(uint8_t) * 8);
-                im.emplace_back(pixelData);
+                return archive->read(*entry);
             }
         }
 
-        return { inputIm.get_width(), inputIm.get_height(), im };
+        std::string path = searchPath(name);
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (path.empty() || !file)
+        {
+            throw std::runtime_error("Cannot find asset " + name);
+        }
+
+        std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            throw std::runtime_error("Cannot read asset " + name);
+        }
+        return data;
+    }
+
+    uint64_t hashBytes(void const* data, size_t size, uint64_t seed)
+    {
+        // FNV-1a style mixing, 8 bytes at a time
+        constexpr uint64_t prime = 0x100000001b3ULL;
+        uint64_t hash = 0xcbf29ce484222325ULL ^ seed;
+
+        auto const* bytes = reinterpret_cast<uint8_t const*>(data);
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(uint64_t));
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 29;
+        }
+        for (; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * prime;
+        }
+
+        hash ^= size;
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    img_r8g8b8a8 fromPng(std::string const& file)
+    {
+        std::ifstream in(file, std::ios::binary | std::ios::ate);
+        if (!in)
+        {
+            throw std::runtime_error("Cannot open " + file);
+        }
+
+        std::vector<uint8_t> data(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!in)
+        {
+            throw std::runtime_error("Cannot read " + file);
+        }
+        return fromPng(data);
+    }
+
+    img_r8g8b8a8 fromPng(std::vector<uint8_t> const& pngData)
+    {
+        PngDecoder decoder(pngData.data(), pngData.size());
+        img_r8g8b8a8 image = { decoder.width(), decoder.height(), {} };
+        image.imgData.resize(size_t(image.width) * image.height);
+        decoder.decodeRgba8(reinterpret_cast<uint8_t*>(image.imgData.data()), size_t(image.width) * sizeof(uint32_t));
+        return image;
     }
 }
\ No newline at end of file
@@ -1,10 +1,19 @@
 #include "common.h"
 #include "Window.h"
+#include "AssetArchive.h"
+#include "helpers.h"
 
 #define TITLE "Vulkan"
 
 int main()
 {
+    // assets come from the archive when one was packed, else from loose files
+    std::string archive = helpers::searchPath(AssetArchive::DEFAULT_ARCHIVE);
+    if (!archive.empty() && AssetArchive::mount(archive))
+    {
+        std::cout << "Using asset archive " << archive << std::endl;
+    }
+
     Window win1(1920, 1080, TITLE);
     return win1.mainLoop();
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "common.h"
+#include "AssetArchive.h"
+
+#include <filesystem>
+
+// usage: assetPack out.vkpak path... [name=path ...]
+// packs files (directories recursively) under their relative path, or under an explicit
+// asset name, e.g. assetPack assets.vkpak assets main.vert.spv=build/main.vert.spv
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " out.vkpak path... [name=path ...]" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::pair<std::string, std::string>> files;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        if (eq != std::string::npos)
+        {
+            files.emplace_back(arg.substr(0, eq), arg.substr(eq + 1));
+            continue;
+        }
+
+        std::error_code err;
+        if (!std::filesystem::is_directory(arg, err))
+        {
+            files.emplace_back(arg, arg);
+            continue;
+        }
+
+        for (auto const& item : std::filesystem::recursive_directory_iterator(arg, err))
+        {
+            if (item.is_regular_file())
+            {
+                std::string path = item.path().generic_string();
+                files.emplace_back(path, path);
+            }
+        }
+    }
+
+    if (!AssetArchive::write(argv[1], files))
+    {
+        std::cerr << "Cannot write " << argv[1] << " (missing input or duplicate asset name?)" << std::endl;
+        return 1;
+    }
+
+    auto archive = AssetArchive::open(argv[1]);
+    if (!archive.has_value())
+    {
+        std::cerr << "Cannot read back " << argv[1] << std::endl;
+        return 1;
+    }
+
+    uint64_t rawSize = 0;
+    for (size_t i = 0; i < archive->entryCount(); ++i)
+    {
+        rawSize += archive->entries()[i].size;
+    }
+    std::cout << argv[1] << ": " << archive->entryCount() << " assets, " << rawSize << " bytes -> "
+              << std::filesystem::file_size(argv[1]) << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,49 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "common.h"
+#include "MappedFile.h"
+#include "MeshCodec.h"
+#include "MeshImport.h"
+
+#include <filesystem>
+
+// usage: meshPack in.obj|in.glb out.nvmz [--quantize]
+// imports a mesh with the default options and writes it as a compressed mesh, which
+// vkTest loads without importing (see include/MeshCodec.h)
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " in.obj|in.glb out.nvmz [--quantize]" << std::endl;
+        return 1;
+    }
+
+    MeshImportOptions options;
+    if (argc > 3 && std::string(argv[3]) == "--quantize")
+    {
+        options.vertexFormat = QUANTIZED_VERTEX;
+    }
+
+    MappedFile source(argv[1]);
+    if (!source)
+    {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    MeshData mesh = MeshImport::import(source.data(), source.size(), argv[1], options);
+    if (!MeshCodec::write(argv[2], mesh))
+    {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    size_t rawSize = mesh.vertexCount() * vertexStride(mesh.vertexFormat) +
+                     mesh.indexCount() * indexStride(mesh.indexType);
+    std::cout << argv[2] << ": " << mesh.vertexCount() << " vertices, " << mesh.indexCount() << " indices, "
+              << rawSize << " bytes -> " << std::filesystem::file_size(argv[2]) << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,119 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "common.h"
+#include "MappedFile.h"
+#include "PngDecoder.h"
+#include "TextureCodec.h"
+
+#include <chrono>
+#include <filesystem>
+
+// usage: texBake in.png out.nvtex [--bc1|--bc7|--rgba8] [--linear]
+// bakes a PNG into a texture with its full mip chain, which vkTest uploads as it is when it
+// sits next to the PNG under the same name (see include/BakedTexture.h). Without an encoding
+// option, opaque images become BC1 and images with alpha BC7. Texels are sRGB unless --linear
+// is given, e.g. for normal maps.
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " in.png out.nvtex [--bc1|--bc7|--rgba8] [--linear]" << std::endl;
+        return 1;
+    }
+
+    optional<BakedTexture::Encoding> encoding;
+    bool srgb = true;
+    for (int arg = 3; arg < argc; ++arg)
+    {
+        std::string option = argv[arg];
+        if (option == "--bc1")
+        {
+            encoding = BakedTexture::Encoding::BC1;
+        }
+        else if (option == "--bc7")
+        {
+            encoding = BakedTexture::Encoding::BC7;
+        }
+        else if (option == "--rgba8")
+        {
+            encoding = BakedTexture::Encoding::RGBA8;
+        }
+        else if (option == "--linear")
+        {
+            srgb = false;
+        }
+        else
+        {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    MappedFile source(argv[1]);
+    if (!source)
+    {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    PngDecoder decoder(source.data(), source.size());
+    uint32_t width = decoder.width();
+    uint32_t height = decoder.height();
+    uint32_t mipLevels = TextureCodec::mipLevelCount(width, height);
+    uint64_t chainSize = TextureCodec::mipChainSizeRgba8(width, height, mipLevels);
+    std::vector<uint8_t> chain(chainSize);
+    decoder.decodeRgba8(chain.data(), size_t(width) * 4);
+    TextureCodec::generateMipsRgba8(chain.data(), width, height, mipLevels, srgb);
+
+    if (!encoding)
+    {
+        bool opaque = true;
+        for (size_t i = 3; i < size_t(width) * height * 4 && opaque; i += 4)
+        {
+            opaque = chain[i] == 0xFF;
+        }
+        encoding = opaque ? BakedTexture::Encoding::BC1 : BakedTexture::Encoding::BC7;
+    }
+
+    std::vector<std::vector<uint8_t>> levels;
+    uint8_t const* level = chain.data();
+    for (uint32_t mip = 0; mip < mipLevels; ++mip)
+    {
+        uint32_t levelWidth = std::max(width >> mip, 1u);
+        uint32_t levelHeight = std::max(height >> mip, 1u);
+        uint64_t levelSize = TextureCodec::encodedSize(BakedTexture::Encoding::RGBA8, levelWidth, levelHeight);
+        if (*encoding == BakedTexture::Encoding::RGBA8)
+        {
+            levels.emplace_back(level, level + levelSize);
+        }
+        else
+        {
+            levels.push_back(TextureCodec::encodeBlocks(level, levelWidth, levelHeight, *encoding, &ThreadPool::shared()));
+        }
+        level += levelSize;
+    }
+
+    if (!TextureCodec::write(argv[2], *encoding, srgb, width, height, levels))
+    {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    char const* encodingNames[] = { "RGBA8", "BC1", "BC7" };
+    uint64_t bakedSize = 0;
+    for (auto const& data : levels)
+    {
+        bakedSize += data.size();
+    }
+    std::cout << argv[2] << ": " << width << "x" << height << ", " << mipLevels << " levels, "
+              << encodingNames[static_cast<uint32_t>(*encoding)] << (srgb ? " sRGB" : " linear") << ", "
+              << chainSize << " bytes as RGBA8 -> " << bakedSize << " bytes ("
+              << static_cast<double>(chainSize) / static_cast<double>(bakedSize) << "x) in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    return 0;
+}
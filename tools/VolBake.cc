@@ -0,0 +1,93 @@
+//
+// Created by Supakorn on 10/16/2026.
+//
+
+#include "common.h"
+#include "MappedFile.h"
+#include "VolumeBricks.h"
+
+#include <chrono>
+
+// usage: volBake in.raw WIDTHxHEIGHTxDEPTH r8|r16 out.nvvol [--empty N]
+// bricks a raw volume (x fastest, then y, then z; 16-bit voxels little endian) into a file
+// BrickedVolume streams brick by brick (see include/VolumeBricks.h). Bricks whose voxels are
+// all at most N (0 by default) are left out.
+
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        std::cerr << "usage: " << argv[0] << " in.raw WIDTHxHEIGHTxDEPTH r8|r16 out.nvvol [--empty N]" << std::endl;
+        return 1;
+    }
+
+    uint32_t width = 0, height = 0, depth = 0;
+    if (sscanf(argv[2], "%ux%ux%u", &width, &height, &depth) != 3 || width == 0 || height == 0 || depth == 0)
+    {
+        std::cerr << "Bad volume size " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::string formatName = argv[3];
+    VolumeBricks::VoxelFormat format;
+    if (formatName == "r8")
+    {
+        format = VolumeBricks::VoxelFormat::R8;
+    }
+    else if (formatName == "r16")
+    {
+        format = VolumeBricks::VoxelFormat::R16;
+    }
+    else
+    {
+        std::cerr << "Unknown voxel format " << formatName << std::endl;
+        return 1;
+    }
+
+    uint16_t emptyThreshold = 0;
+    for (int arg = 5; arg < argc; ++arg)
+    {
+        std::string option = argv[arg];
+        if (option == "--empty" && arg + 1 < argc)
+        {
+            emptyThreshold = static_cast<uint16_t>(std::stoul(argv[++arg]));
+        }
+        else
+        {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    // mapped, so volumes larger than memory are paged in as the bricks are cut
+    MappedFile source(argv[1]);
+    uint64_t voxelCount = uint64_t(width) * height * depth;
+    if (!source || source.size() < voxelCount * VolumeBricks::voxelBytes(format))
+    {
+        std::cerr << "Cannot open " << argv[1] << " as a " << argv[2] << " " << formatName << " volume" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!VolumeBricks::bake(argv[4], source.data(), format, width, height, depth, emptyThreshold, &ThreadPool::shared()))
+    {
+        std::cerr << "Cannot write " << argv[4] << std::endl;
+        return 1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    MappedFile baked(argv[4]);
+    auto const* hdr = reinterpret_cast<VolumeBricks::Header const*>(baked.data());
+    auto const* bricks = reinterpret_cast<VolumeBricks::Brick const*>(baked.data() + sizeof(VolumeBricks::Header));
+    size_t brickTotal = size_t(hdr->bricksX) * hdr->bricksY * hdr->bricksZ;
+    size_t stored = 0;
+    for (size_t i = 0; i < brickTotal; ++i)
+    {
+        stored += bricks[i].offset != 0 ? 1 : 0;
+    }
+    std::cout << argv[4] << ": " << hdr->bricksX << "x" << hdr->bricksY << "x" << hdr->bricksZ << " bricks, "
+              << stored << " stored, " << brickTotal - stored << " empty, "
+              << source.size() << " bytes -> " << baked.size() << " bytes in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+    return 0;
+}